@@ -48,6 +48,13 @@
  *      it is important that all strings are valid UTF-8, as this is required
  *      by the JSON specification.
  *
+ *      The JSONParser may be asked to parse lazily via ParserOptions.  In
+ *      that case, the text is verified to be well-formed, but the members of
+ *      objects and the elements of arrays are parsed only when that object or
+ *      array is first accessed.  Since accessing a lazily parsed document may
+ *      modify it, even via const member functions, such a document must not be
+ *      accessed by several threads at once.
+ *
  *      If there is an error parsing JSON text or producing JSON text, an
  *      exception will be thrown.  Likewise, there are other functions that will
  *      throw a JSONException if a function call is invalid.  One must
@@ -79,6 +86,7 @@
 #include <cstddef>
 #include <variant>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <stdexcept>
@@ -86,7 +94,13 @@
 #include <type_traits>
 #include <limits>
 #include <initializer_list>
+#include <iterator>
 #include <utility>
+#include <memory>
+#include <span>
+#ifdef TERRA_JSON_NODE_POOL
+#include <terra/json/json_node_pool.h>
+#endif
 
 namespace Terra::JSON
 {
@@ -100,6 +114,26 @@ class JSONException : public std::runtime_error
 // Make forward declarations
 class JSON;
 class JSONParser;
+class JSONArrayConsumer;
+
+// Allocator used for the storage held by JSONObject and JSONArray
+#ifdef TERRA_JSON_NODE_POOL
+template<typename T>
+using JSONAllocator = NodePoolAllocator<T>;
+#else
+template<typename T>
+using JSONAllocator = std::allocator<T>;
+#endif
+
+// Container types holding the members of JSONObject and JSONArray; the
+// map's comparator is transparent so that members may be found using string
+// views or JSONKey handles without constructing a std::u8string
+using JSONObjectMap =
+    std::map<std::u8string,
+             JSON,
+             std::less<>,
+             JSONAllocator<std::pair<const std::u8string, JSON>>>;
+using JSONArrayVector = std::vector<JSON, JSONAllocator<JSON>>;
 
 // Define an enumeration for the JSON value types
 enum class JSONValueType
@@ -200,8 +234,13 @@ struct JSONNumber
         }
         value = static_cast<JSONInteger>(number);
     }
+    JSONNumber(const JSONNumber &) = default;
+    JSONNumber(JSONNumber &&) = default;
     ~JSONNumber() = default;
 
+    JSONNumber &operator=(const JSONNumber &) = default;
+    JSONNumber &operator=(JSONNumber &&) = default;
+
     bool IsFloat() const { return std::holds_alternative<JSONFloat>(value); }
     bool IsInteger() const { return !IsFloat(); }
 
@@ -223,10 +262,53 @@ struct JSONNumber
 // Streaming operator for JSONNumber output
 std::ostream &operator<<(std::ostream &o, const JSONNumber &value);
 
+// Handle for an object key that is looked up repeatedly; it is a view of the
+// key that is built once, which may be done at compile time (e.g., constexpr
+// JSONKey Type_Key{u8"type"}), so that lookups need not construct a string.
+// The handle refers to the given string, which must outlive the handle.
+class JSONKey
+{
+    public:
+        constexpr explicit JSONKey(const std::u8string_view key) : key{key}
+        {
+        }
+        constexpr explicit JSONKey(const char8_t *key) :
+            JSONKey(std::u8string_view(key))
+        {
+        }
+        explicit JSONKey(const std::string_view key) :
+            JSONKey(std::u8string_view(
+                reinterpret_cast<const char8_t *>(key.data()), key.size()))
+        {
+        }
+
+        constexpr std::u8string_view View() const { return key; }
+        constexpr std::size_t Size() const { return key.size(); }
+
+        constexpr bool operator==(const JSONKey &other) const
+        {
+            return key == other.key;
+        }
+
+    protected:
+        std::u8string_view key;                 // Key string
+};
+
+namespace Literals
+{
+
+// Produce a JSONKey at compile time (e.g., u8"type"_key)
+constexpr JSONKey operator""_key(const char8_t *key, std::size_t length)
+{
+    return JSONKey(std::u8string_view(key, length));
+}
+
+} // namespace Literals
+
 // JSON type to hold a JSON value type of object
 struct JSONObject
 {
-    std::map<std::u8string, JSON> value;
+    JSONObjectMap value;
 
     JSONObject() = default;
     JSONObject(
@@ -234,20 +316,27 @@ struct JSONObject
                                                                         &list);
     JSONObject(
         const std::initializer_list<std::pair<const std::string, JSON>> &list);
+    JSONObject(const JSONObject &) = default;
+    JSONObject(JSONObject &&) = default;
     ~JSONObject() = default;
 
+    JSONObject &operator=(const JSONObject &) = default;
+    JSONObject &operator=(JSONObject &&) = default;
+
     JSON &operator[](const std::u8string &key) { return value[key]; }
     const JSON &operator[](const std::u8string &key) const
     {
         return value.at(key);
     }
-    JSON &operator[](const std::string &key)
+    JSON &operator[](const std::string &key) { return Member(View(key)); }
+    const JSON &operator[](const std::string &key) const
     {
-        return operator[](std::u8string(key.cbegin(), key.cend()));
+        return Member(View(key));
     }
-    const JSON &operator[](const std::string &key) const
+    JSON &operator[](const JSONKey &key) { return Member(key.View()); }
+    const JSON &operator[](const JSONKey &key) const
     {
-        return operator[](std::u8string(key.cbegin(), key.cend()));
+        return Member(key.View());
     }
 
     bool HasKey(const std::u8string &key) const
@@ -256,49 +345,166 @@ struct JSONObject
     }
     bool HasKey(const std::string &key) const
     {
-        return HasKey(std::u8string(key.cbegin(), key.cend()));
+        return (Find(View(key)) != nullptr);
+    }
+    bool HasKey(const JSONKey &key) const
+    {
+        return (Find(key.View()) != nullptr);
     }
 
+    // Return a pointer to the member having the given key or nullptr if
+    // there is no such member
+    JSON *Find(const std::u8string_view key);
+    const JSON *Find(const std::u8string_view key) const;
+    JSON *Find(const JSONKey &key) { return Find(key.View()); }
+    const JSON *Find(const JSONKey &key) const { return Find(key.View()); }
+
+    // Remove the member having the given key, returning it as a node that
+    // owns the key and value (the node is empty if there is no such member)
+    JSONObjectMap::node_type Extract(const std::u8string_view key);
+    JSONObjectMap::node_type Extract(const JSONKey &key);
+
     // Return the underlying map of JSON objects
-    std::map<std::u8string, JSON> &operator*() { return value; }
-    const std::map<std::u8string, JSON> &operator*() const { return value; }
+    JSONObjectMap &operator*() { return value; }
+    const JSONObjectMap &operator*() const { return value; }
+
+    // Construct the member having the given key from the given arguments,
+    // replacing any existing member having that key
+    template<typename... Args>
+    JSON &Emplace(std::u8string key, Args &&...args);
+    template<typename... Args>
+    JSON &Emplace(const std::string &key, Args &&...args);
 
     std::size_t Size() const { return value.size(); }
 
     std::string ToString() const;
+
+protected:
+    JSON &Member(const std::u8string_view key);
+    const JSON &Member(const std::u8string_view key) const;
+
+    // Return a view of the given key as UTF-8 text without copying it
+    static std::u8string_view View(const std::string &key)
+    {
+        return {reinterpret_cast<const char8_t *>(key.data()), key.size()};
+    }
 };
 
 // Streaming operator for JSONObject output
 std::ostream &operator<<(std::ostream &o, const JSONObject &object);
 
+// Arithmetic types that may be converted to and from arrays of numbers in
+// bulk: the standard signed and unsigned integer types (e.g., std::int8_t
+// and std::uint16_t), float, and double; bool and the character types are
+// not numbers, and long double cannot be held by a JSONNumber
+template<typename T>
+concept JSONArithmetic =
+    std::is_same_v<T, signed char> || std::is_same_v<T, short> ||
+    std::is_same_v<T, int> || std::is_same_v<T, long> ||
+    std::is_same_v<T, long long> || std::is_same_v<T, unsigned char> ||
+    std::is_same_v<T, unsigned short> || std::is_same_v<T, unsigned> ||
+    std::is_same_v<T, unsigned long> ||
+    std::is_same_v<T, unsigned long long> || std::is_same_v<T, float> ||
+    std::is_same_v<T, double>;
+
 // JSON type to hold a JSON value type of array
 struct JSONArray
 {
-    std::vector<JSON> value;
+    JSONArrayVector value;
 
     JSONArray() = default;
     JSONArray(const std::initializer_list<JSON> &list);
+    JSONArray(const JSONArray &) = default;
+    JSONArray(JSONArray &&) = default;
     ~JSONArray() = default;
 
+    JSONArray &operator=(const JSONArray &other);
+    JSONArray &operator=(JSONArray &&other);
+
     JSON &operator[](const std::size_t index);
     const JSON &operator[](const std::size_t index) const;
 
     // Return the underlying array of JSON objects
-    std::vector<JSON> &operator*() { return value; }
-    const std::vector<JSON> &operator*() const { return value; }
+    JSONArrayVector &operator*()
+    {
+        version++;
+        element_version++;
+        return value;
+    }
+    const JSONArrayVector &operator*() const { return value; }
+
+    // Reserve space for the given number of elements
+    void Reserve(std::size_t size) { value.reserve(size); }
+
+    // Construct an element at the end of the array from the given arguments
+    template<typename... Args>
+    JSON &Emplace(Args &&...args);
+
+    // Construct an array of numbers from the given arithmetic values (e.g.,
+    // JSONArray::FromSpan<double>(samples))
+    template<JSONArithmetic T>
+    static JSONArray FromSpan(std::span<const T> values);
+
+    // Return the elements of an array of numbers as the given arithmetic
+    // type; a JSONException identifying the first element that is not a
+    // number, or is not representable as the type, is thrown
+    template<JSONArithmetic T>
+    std::vector<T> ToVector() const;
 
     std::size_t Size() const;
 
+    // Returns a value that changes whenever elements may have been
+    // inserted, erased, or reordered (i.e., when the underlying vector is
+    // accessed or the array is assigned); direct modification of the value
+    // member is not tracked
+    std::uint64_t Version() const { return version; }
+
+    // Returns a value that changes whenever an element may have been
+    // modified or appended, as well as whenever Version() changes
+    std::uint64_t ElementVersion() const { return element_version; }
+
+    // Returns the position most recently passed to the non-const operator[]
+    std::size_t LastAccessed() const { return last_accessed; }
+
     std::string ToString() const;
+
+protected:
+    std::uint64_t version{};                    // Structural change counter
+    std::uint64_t element_version{};            // Element change counter
+    std::size_t last_accessed{};                // Last element accessed
 };
 
 // Streaming operator for JSONArray output
 std::ostream &operator<<(std::ostream &o, const JSONArray &array);
 
+// Produce the JSON text for an array of the given arithmetic values directly,
+// without first constructing a JSONArray
+template<JSONArithmetic T>
+std::string ToJSONText(std::span<const T> values);
+
 // Define a type that will hold any one of the JSON types
 using JSONValue =
     std::variant<JSONString, JSONNumber, JSONObject, JSONArray, JSONLiteral>;
 
+// Marker that replaces content omitted from a preview or from JSON text
+// produced within a budget (U+2026, the horizontal ellipsis)
+constexpr std::u8string_view Elision_Marker = u8"\u2026";
+
+// Options for JSON text produced by JSON::ToString(); content that would
+// exceed a limit is replaced with the Elision_Marker
+struct SerializerOptions
+{
+    // Value of a limit that does not limit
+    static constexpr std::size_t No_Limit =
+        std::numeric_limits<std::size_t>::max();
+
+    // Smallest output budget, which is sufficient for an elided container
+    static constexpr std::size_t Minimum_Bytes = 32;
+
+    std::size_t max_bytes{No_Limit};            // Octets of JSON text
+    std::size_t max_string_length{No_Limit};    // Octets of each string
+};
+
 // The JSON class holds a JSONValue
 class JSON
 {
@@ -306,15 +512,31 @@ class JSON
         JSON() { AssignType(JSONValueType::Object); }
         JSON(JSONValueType type) { AssignType(type); }
         JSON(const JSONValue &value) : value{value} {}
-        JSON(JSONValue &&value) : value{std::move(value)} {}
+        JSON(JSONValue &&value) : value{std::move(value)}
+        {
+            // Values within a moved object or array might be referenced
+            if (std::holds_alternative<JSONObject>(this->value) ||
+                std::holds_alternative<JSONArray>(this->value))
+            {
+                Expose();
+            }
+        }
         JSON(const JSONString &string) : value{string} {}
         JSON(JSONString &&string) : value{std::move(string)} {}
         JSON(const JSONNumber &number) : value{number} {}
         JSON(JSONNumber &&number) : value{std::move(number)} {}
         JSON(const JSONObject &object) : value{object} {}
-        JSON(JSONObject &&object) : value{std::move(object)} {}
+        JSON(JSONObject &&object) :
+            value{std::move(object)},
+            annex{&Exposed_Annex}
+        {
+        }
         JSON(const JSONArray &array) : value{array} {}
-        JSON(JSONArray &&array) : value{std::move(array)} {}
+        JSON(JSONArray &&array) :
+            value{std::move(array)},
+            annex{&Exposed_Annex}
+        {
+        }
         JSON(const JSONLiteral value) : value{value} {}
         JSON(const char8_t *string) : JSON(JSONString(string)) {}
         JSON(const char *string) :
@@ -327,8 +549,23 @@ class JSON
                                          bool>::type = true>
         JSON(T value) : value{JSONNumber(value)} {}
 
+        JSON(const JSON &other) : value{other.value}, annex{other.CopyAnnex()}
+        {
+        }
+        JSON(JSON &&) = default;
         ~JSON() = default;
 
+        JSON &operator=(const JSON &other)
+        {
+            if (this != &other)
+            {
+                value = other.value;
+                annex = other.CopyAnnex();
+            }
+            return *this;
+        }
+        JSON &operator=(JSON &&) = default;
+
         // Return the type of the JSON value held by this object
         JSONValueType GetValueType() const;
 
@@ -342,11 +579,13 @@ class JSON
         JSON &operator=(const char8_t *string)
         {
             value = JSONString(string);
+            annex.reset();
             return *this;
         }
         JSON &operator=(const char *string)
         {
             value = JSONString(string);
+            annex.reset();
             return *this;
         }
 
@@ -358,6 +597,7 @@ class JSON
         JSON &operator=(const T assignment)
         {
             value = JSONNumber(assignment);
+            annex.reset();
             return *this;
         }
         template<typename T,
@@ -367,69 +607,100 @@ class JSON
         JSON &operator=(const T assignment)
         {
             value = JSONNumber(assignment);
+            annex.reset();
             return *this;
         }
 
         JSON &operator=(const JSONLiteral assignment)
         {
             value = assignment;
+            annex.reset();
             return *this;
         }
 
         JSON &operator=(const JSONNumber &assignment)
         {
             value = assignment;
+            annex.reset();
             return *this;
         }
         JSON &operator=(JSONNumber &&assignment)
         {
-            value = assignment;
+            value = std::move(assignment);
+            annex.reset();
             return *this;
         }
 
         JSON &operator=(const JSONString &assignment)
         {
             value = assignment;
+            annex.reset();
             return *this;
         }
         JSON &operator=(JSONString &&assignment)
         {
-            value = assignment;
+            value = std::move(assignment);
+            annex.reset();
             return *this;
         }
 
         JSON &operator=(const JSONArray &assignment)
         {
             value = assignment;
+            annex.reset();
             return *this;
         }
         JSON &operator=(JSONArray &&assignment)
         {
-            value = assignment;
+            value = std::move(assignment);
+            Expose();
             return *this;
         }
 
         JSON &operator=(const JSONObject &assignment)
         {
             value = assignment;
+            annex.reset();
             return *this;
         }
         JSON &operator=(JSONObject &&assignment)
         {
-            value = assignment;
+            value = std::move(assignment);
+            Expose();
             return *this;
         }
 
         // Functions to return a reference to the underlying JSONValue variant
-        JSONValue &operator*() { return value; }
-        const JSONValue &operator*() const { return value; }
-        JSONValue &GetValue() { return value; }
-        const JSONValue &GetValue() const { return value; }
+        JSONValue &operator*()
+        {
+            Expand();
+            Expose();
+            return value;
+        }
+        const JSONValue &operator*() const
+        {
+            Expand();
+            return value;
+        }
+        JSONValue &GetValue()
+        {
+            Expand();
+            Expose();
+            return value;
+        }
+        const JSONValue &GetValue() const
+        {
+            Expand();
+            return value;
+        }
 
         // Function to return a reference to the underlying type
         template<typename T>
         T &GetValue()
         {
+            Expand();
+            Expose();
+
             if (std::holds_alternative<T>(value))
             {
                 return std::get<T>(value);
@@ -440,6 +711,8 @@ class JSON
         template<typename T>
         const T &GetValue() const
         {
+            Expand();
+
             if (std::holds_alternative<T>(value))
             {
                 return std::get<T>(value);
@@ -453,33 +726,351 @@ class JSON
         const JSON &operator[](std::size_t index) const;
         JSON &operator[](const std::u8string &key);
         const JSON &operator[](const std::u8string &key) const;
-        JSON &operator[](const std::string &key)
+        JSON &operator[](const std::string &key);
+        const JSON &operator[](const std::string &key) const;
+        JSON &operator[](const JSONKey &key);
+        const JSON &operator[](const JSONKey &key) const;
+
+        // Move the value of the given type out of this object, which is left
+        // holding an empty value of that type; a JSONException is thrown if
+        // the object holds a different type
+        template<typename T>
+        T Take()
         {
-            return operator[](std::u8string(key.cbegin(), key.cend()));
+            T taken = std::move(GetValue<T>());
+            value = T{};
+            return taken;
         }
-        const JSON &operator[](const std::string &key) const
+        std::u8string TakeString() { return std::move(*Take<JSONString>()); }
+        JSONArrayVector TakeArray() { return std::move(*Take<JSONArray>()); }
+        JSONObjectMap TakeObject() { return std::move(*Take<JSONObject>()); }
+
+        // Remove the member having the given key from the object held by
+        // this object, returning it as a node that owns the key and value
+        JSONObjectMap::node_type ExtractMember(const std::u8string_view key);
+        JSONObjectMap::node_type ExtractMember(const std::string_view key)
         {
-            return operator[](std::u8string(key.cbegin(), key.cend()));
+            return ExtractMember(std::u8string_view(
+                reinterpret_cast<const char8_t *>(key.data()), key.size()));
         }
+        JSONObjectMap::node_type ExtractMember(const JSONKey &key)
+        {
+            return ExtractMember(key.View());
+        }
+
+        // Take the elements of the array held by this object as a range
+        // whose elements are moved out as they are visited
+        JSONArrayConsumer ConsumeArray();
 
         std::string ToString() const;
+        std::string ToString(const SerializerOptions &options) const;
+
+        // Produce the same text as ToString(), retaining the text of objects
+        // and arrays so that it is reused by subsequent calls; text is not
+        // retained for values that were accessed via a non-const member
+        // function, nor for the values that enclose them, as they might be
+        // modified via a retained reference.  ClearCache() discards the
+        // retained text throughout the value.
+        std::string ToCachedString();
+        void ClearCache();
 
     protected:
-        JSONValue value;
+        friend class JSONParser;
+
+        // Text associated with the value, which is held apart from it so
+        // that the many values having none require only a null pointer; an
+        // object or array either has text yet to be parsed or retains the
+        // text produced by ToCachedString(), never both
+        struct Annex
+        {
+            std::shared_ptr<const char8_t> deferred;
+                                                // Text yet to be parsed
+            std::string serialized;             // Text from ToCachedString()
+        };
+
+        // Annex held by a value that was accessed via a non-const member
+        // function (or constructed from a moved object or array), whose
+        // content might therefore be modified via a retained reference
+        static Annex Exposed_Annex;
+
+        // Deletes any annex other than the Exposed_Annex
+        struct AnnexDeleter
+        {
+            void operator()(Annex *annex) const
+            {
+                if (annex != &Exposed_Annex) delete annex;
+            }
+        };
+        using AnnexPointer = std::unique_ptr<Annex, AnnexDeleter>;
+
+        // Parse the object or array whose parsing was deferred, if any
+        void Expand() const
+        {
+            if (annex && annex->deferred) ExpandDeferred();
+        }
+        void ExpandDeferred() const;
+
+        // Note that the value might be modified via a reference held by the
+        // caller, discarding any retained text
+        void Expose() { annex.reset(&Exposed_Annex); }
+        bool Exposed() const { return annex.get() == &Exposed_Annex; }
+
+        // Copy the text yet to be parsed, if any; retained text is not
+        // copied, as copies are generally made in order to be modified, and
+        // no reference to the content of a copy can yet be held
+        AnnexPointer CopyAnnex() const
+        {
+            if (!annex || !annex->deferred) return {};
+            return AnnexPointer(new Annex{annex->deferred, {}});
+        }
+
+        bool WriteCached(std::string &output);
+
+        mutable JSONValue value;                // JSON value
+        mutable AnnexPointer annex;             // Text associated with value
 };
 
 // Streaming operator for JSON output
 std::ostream &operator<<(std::ostream &o, const JSON &json);
 
+// Range over the elements taken from an array by JSON::ConsumeArray(); each
+// element is presented as an rvalue so that it may be moved out (e.g., for
+// (JSON element : json.ConsumeArray())), releasing its storage as the range
+// is traversed rather than when the range is destroyed
+class JSONArrayConsumer
+{
+    public:
+        using iterator = std::move_iterator<JSONArrayVector::iterator>;
+
+        explicit JSONArrayConsumer(JSONArrayVector &&elements) :
+            elements{std::move(elements)}
+        {
+        }
+
+        iterator begin() { return std::make_move_iterator(elements.begin()); }
+        iterator end() { return std::make_move_iterator(elements.end()); }
+        std::size_t Size() const { return elements.size(); }
+
+    protected:
+        JSONArrayVector elements;               // Elements taken from array
+};
+
+template<typename... Args>
+JSON &JSONObject::Emplace(std::u8string key, Args &&...args)
+{
+    // Arguments are not moved from if the key is present
+    auto [it, inserted] =
+        value.try_emplace(std::move(key), std::forward<Args>(args)...);
+    if (!inserted) it->second = JSON(std::forward<Args>(args)...);
+
+    return it->second;
+}
+
+template<typename... Args>
+JSON &JSONObject::Emplace(const std::string &key, Args &&...args)
+{
+    return Emplace(std::u8string(key.cbegin(), key.cend()),
+                   std::forward<Args>(args)...);
+}
+
+template<typename... Args>
+JSON &JSONArray::Emplace(Args &&...args)
+{
+    element_version++;
+
+    return value.emplace_back(std::forward<Args>(args)...);
+}
+
+// Construct a JSONArray holding the given values; unlike initializer lists,
+// whose elements must be copied, the values are moved into the array (e.g.,
+// MakeArray(1, "two", MakeArray(3, 4)) allocates each element once)
+template<typename... Values>
+JSONArray MakeArray(Values &&...values)
+{
+    JSONArray array;
+
+    array.Reserve(sizeof...(values));
+    (array.Emplace(std::forward<Values>(values)), ...);
+
+    return array;
+}
+
+// Construct a JSONObject holding the given key/value pairs, moving the values
+// into the object (e.g., MakeObject(std::pair{u8"a", MakeArray(1, 2)}))
+template<typename... Members>
+JSONObject MakeObject(Members &&...members)
+{
+    JSONObject object;
+
+    (object.Emplace(std::forward<Members>(members).first,
+                    std::forward<Members>(members).second),
+     ...);
+
+    return object;
+}
+
+// Layout of the JSON text written by WriteJSONText()
+enum class JSONTextStyle
+{
+    Default,                                    // As produced by ToString()
+    Compact,                                    // Without whitespace
+    Indented                                    // As by the JSONFormatter
+};
+
+// Destination for the JSON text written by WriteJSONText(), which is given
+// the text in pieces as it is produced
+class JSONTextSink
+{
+    public:
+        virtual ~JSONTextSink() = default;
+
+        virtual void Write(const std::string_view text) = 0;
+};
+
+// Write the JSON text for the given value to the sink without producing a
+// string; for the Indented style, the text is the same as that produced by
+// a JSONFormatter having the given indentation
+void WriteJSONText(JSONTextSink &sink,
+                   const JSON &json,
+                   JSONTextStyle style = JSONTextStyle::Default,
+                   std::size_t indentation = 2);
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONString &string,
+                   JSONTextStyle style = JSONTextStyle::Default,
+                   std::size_t indentation = 2);
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONNumber &number,
+                   JSONTextStyle style = JSONTextStyle::Default,
+                   std::size_t indentation = 2);
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONObject &object,
+                   JSONTextStyle style = JSONTextStyle::Default,
+                   std::size_t indentation = 2);
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONArray &array,
+                   JSONTextStyle style = JSONTextStyle::Default,
+                   std::size_t indentation = 2);
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONLiteral literal,
+                   JSONTextStyle style = JSONTextStyle::Default,
+                   std::size_t indentation = 2);
+
+// Rebuild the JSON object such that its storage is allocated in depth-first
+// order, improving locality when traversing long-lived, modified documents
+void Compact(JSON &json);
+
+// Result of validating JSON text
+struct ValidationResult
+{
+    bool valid{};                               // True if text is well-formed
+    std::size_t offset{};                       // Offset of the first error
+    const char *error{};                        // Description of the error
+
+    explicit operator bool() const { return valid; }
+};
+
+// Depth to which objects and arrays may be nested in text that is verified
+// without being parsed (e.g., by Validate()) unless another limit is given;
+// since the text is verified recursively, a limit protects the stack
+constexpr std::size_t Default_Validation_Depth = 1024;
+
+// Verify that the given UTF-8 text is well-formed JSON per RFC 8259 without
+// parsing it into JSON objects; objects and arrays may be nested to at most
+// the given depth (ParserOptions::No_Limit is no limit)
+ValidationResult Validate(
+                    const std::u8string_view content,
+                    std::size_t max_depth = Default_Validation_Depth) noexcept;
+ValidationResult Validate(
+                    const std::string_view content,
+                    std::size_t max_depth = Default_Validation_Depth) noexcept;
+
+// Location of a value within JSON text
+struct JSONTextSpan
+{
+    std::size_t offset{};                       // Offset of the value
+    std::size_t length{};                       // Length of the value's text
+};
+
+// Locate the value identified by the given JSON Pointer (RFC 6901) within
+// JSON text without parsing the text
+JSONTextSpan FindValue(const std::u8string_view content,
+                       const std::u8string_view pointer);
+JSONTextSpan FindValue(const std::string_view content,
+                       const std::string_view pointer);
+
+// Replace the value identified by the given JSON Pointer within JSON text,
+// either with the given value or with the given well-formed JSON text
+void ReplaceValue(std::u8string &content,
+                  const std::u8string_view pointer,
+                  const JSON &value);
+void ReplaceValue(std::string &content,
+                  const std::string_view pointer,
+                  const JSON &value);
+void ReplaceValueText(std::u8string &content,
+                      const std::u8string_view pointer,
+                      const std::u8string_view text);
+void ReplaceValueText(std::string &content,
+                      const std::string_view pointer,
+                      const std::string_view text);
+
+// Options that control the behavior of the JSONParser
+struct ParserOptions
+{
+    // Value of a limit that does not limit
+    static constexpr std::size_t No_Limit =
+        std::numeric_limits<std::size_t>::max();
+
+    // Defer parsing the members of objects and the elements of arrays until
+    // the object or array is first accessed
+    bool lazy{false};
+
+    // Limits on the content to parse, which protect against excessive use
+    // of memory when parsing untrusted input; if a limit is exceeded, the
+    // parser stops and throws a JSONException
+    std::size_t max_document_size{No_Limit};    // Octets of JSON text
+    std::size_t max_depth{No_Limit};            // Nesting of objects/arrays
+    std::size_t max_values{No_Limit};           // Values in the document
+    std::size_t max_string_length{No_Limit};    // Octets in a string's text
+    std::size_t max_members{No_Limit};          // Members in an object
+    std::size_t max_elements{No_Limit};         // Elements in an array
+};
+
+// Budgets for the preview of JSON text produced by JSONParser::Preview();
+// content beyond a budget is skipped and replaced with the Elision marker
+struct PreviewOptions
+{
+    // Value of a budget that does not limit
+    static constexpr std::size_t No_Limit = ParserOptions::No_Limit;
+
+    // Marker that replaces elided content
+    static constexpr std::u8string_view Elision = Elision_Marker;
+
+    std::size_t max_elements{No_Limit};         // Elements shown per array
+    std::size_t max_members{No_Limit};          // Members shown per object
+    std::size_t max_depth{No_Limit};            // Nesting of objects/arrays
+    std::size_t max_string_length{No_Limit};    // Octets of string text shown
+};
+
 // Define the JSONParser object used to deserialize JSON text
 class JSONParser
 {
     public:
-        JSONParser() = default;
+        JSONParser(const ParserOptions &options = {}) :
+            options{options},
+            preview{nullptr}
+        {
+        }
         ~JSONParser() = default;
 
         JSON Parse(const std::string_view content);
         JSON Parse(const std::u8string_view content);
+        JSON Parse(const std::u16string_view content);
+        JSON Parse(const std::u32string_view content);
+
+        JSON Preview(const std::string_view content,
+                     const PreviewOptions &budget);
+        JSON Preview(const std::u8string_view content,
+                     const PreviewOptions &budget);
 
     protected:
         constexpr bool EndOfInput() const { return p >= q; }
@@ -491,6 +1082,7 @@ class JSONParser
             column += p - old_p;
         }
         void ConsumeWhitespace();
+        void IndexArraySizes();
         JSONValueType DetermineValueType() const;
         JSONValue ParseValue(JSONValueType value_type);
         JSONString ParseString();
@@ -499,11 +1091,25 @@ class JSONParser
         JSONObject ParseObject();
         JSONArray ParseArray();
         JSONLiteral ParseLiteral();
+        void ParseElement(JSON &json);
+        JSON ParseDeferred(const std::u8string_view content);
+        void ExpandDeferred(const JSON &json);
+        void SkipElided();
+
+        friend class JSON;
 
+        ParserOptions options;                  // Parsing options
+        const PreviewOptions *preview;          // Budgets if previewing
         const char8_t *p;                       // Start of content
         const char8_t *q;                       // One past end of data
         std::size_t line;                       // Current line number
         std::size_t column;                     // Current column
+        std::vector<std::size_t> array_sizes;   // Element count of each array
+        std::size_t array_index;                // Next array_sizes entry
+        std::size_t depth;                      // Depth of nesting
+        std::size_t values;                     // Number of values parsed
+        std::shared_ptr<const char8_t> deferred_text;
+                                                // Text parsed lazily
 };
 
 // Define the JSONFormatter object used format JSON text
@@ -0,0 +1,123 @@
+/*
+ *  json_columns.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines ExtractColumns(), which extracts the values of the
+ *      given members from each object in an array of objects into columns.
+ *      Documents commonly hold arrays of records, such as:
+ *
+ *          [ { "id": 1, "price": 9.5, "tags": {...} }, ... ]
+ *
+ *      Aggregating a member over such an array would otherwise visit each
+ *      object's map for every element.  Each column instead holds the values
+ *      of one member in a contiguous vector having one entry per element,
+ *      along with a validity bitmap that records which elements have a
+ *      value.  An element whose member is missing or null (or that is not
+ *      an object) is recorded as invalid and holds a default value (zero,
+ *      false, or an empty string).
+ *
+ *      Each column is specified by the path of keys that leads from the
+ *      element to the value (an empty path refers to the element itself)
+ *      and the type of the values.  Integer columns accept only integers,
+ *      while Float columns accept any number.  A value of any other type
+ *      results in a JSONException.
+ *
+ *      Columns may be extracted either from a JSONArray or directly from
+ *      JSON text, in which case no JSON objects are produced and only the
+ *      values of the requested members are converted.  The text is first
+ *      verified to be well-formed, with objects and arrays nested to at most
+ *      the given depth (Default_Validation_Depth unless specified, or
+ *      ParserOptions::No_Limit for no limit).
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Type of the values held by a column
+enum class JSONColumnType
+{
+    Integer,                                    // JSONInteger values
+    Float,                                      // JSONFloat values
+    Boolean,                                    // Literals true and false
+    String                                      // Decoded string values
+};
+
+// Specification of a column to extract
+struct JSONColumnSpec
+{
+    std::vector<std::u8string> path;            // Keys leading to the value
+    JSONColumnType type{JSONColumnType::Float}; // Type of the values
+};
+
+// Values extracted for one column, one per element of the array
+struct JSONColumn
+{
+    // Values of the column, held in the vector for the column's type
+    // (booleans are held as 0 or 1)
+    using Values = std::variant<std::vector<JSONInteger>,
+                                std::vector<JSONFloat>,
+                                std::vector<std::uint8_t>,
+                                std::vector<std::u8string>>;
+
+    JSONColumnType type{JSONColumnType::Float}; // Type of the values
+    Values values;                              // Values of the column
+    std::vector<std::uint64_t> validity;        // Bit set if element is valid
+    std::size_t invalid_count{};                // Elements that are invalid
+
+    // Number of elements
+    std::size_t Size() const
+    {
+        return std::visit([](const auto &v) { return v.size(); }, values);
+    }
+
+    // Determine whether the given element has a value
+    bool IsValid(std::size_t row) const
+    {
+        return ((validity[row / 64] >> (row % 64)) & 1) != 0;
+    }
+
+    // Return the values, where T is the type held for the column's type
+    template<typename T>
+    const std::vector<T> &Get() const
+    {
+        return std::get<std::vector<T>>(values);
+    }
+};
+
+// Extract the given columns from an array of objects
+std::vector<JSONColumn> ExtractColumns(
+                                const JSONArray &array,
+                                const std::vector<JSONColumnSpec> &columns);
+
+// Extract the given columns from JSON text holding an array of objects
+// without parsing the text into JSON objects
+std::vector<JSONColumn> ExtractColumns(
+                            const std::u8string_view content,
+                            const std::vector<JSONColumnSpec> &columns,
+                            std::size_t max_depth = Default_Validation_Depth);
+std::vector<JSONColumn> ExtractColumns(
+                            const std::string_view content,
+                            const std::vector<JSONColumnSpec> &columns,
+                            std::size_t max_depth = Default_Validation_Depth);
+
+} // namespace Terra::JSON
@@ -0,0 +1,95 @@
+/*
+ *  json_file_sink.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines the JSONFileSink, which writes large volumes of
+ *      JSON text to a file.  Writing through a std::ofstream, the thread
+ *      producing the text stalls each time the stream's small buffer is
+ *      written to the file.  The JSONFileSink instead fills one of two large
+ *      aligned blocks while a writer thread writes the other to the file, so
+ *      producing the text and writing it to the file overlap.
+ *
+ *      The JSONFileSink is a JSONTextSink, so it may be given directly to
+ *      WriteJSONText().  Stream() returns a std::ostream that writes into
+ *      the same blocks for use with a JSONFormatter or the JSON streaming
+ *      operators.  Flushing that stream does not write a partial block.
+ *
+ *      Close() writes any remaining text, waits for the writer thread, and
+ *      ensures that the content of the file is committed to storage before
+ *      closing the file.  Errors writing the file are reported by throwing
+ *      a JSONException from Write() or Close() (the stream sets its badbit
+ *      instead).  If the object is destroyed without calling Close(), the
+ *      file is closed, but errors are ignored.
+ *
+ *  Portability Issues:
+ *      On POSIX systems, blocks are written using pwrite() and the file is
+ *      committed to storage using fsync().  Elsewhere, a std::ofstream is
+ *      used, and the file is only flushed when closed.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// JSONTextSink that writes to a file in large blocks on a separate thread
+class JSONFileSink : public JSONTextSink, protected std::streambuf
+{
+    public:
+        // Default number of octets written to the file at once
+        static constexpr std::size_t Default_Block_Size = 1024 * 1024;
+
+        // Alignment of each block (the block size is a multiple of this)
+        static constexpr std::size_t Block_Alignment = 4096;
+
+        JSONFileSink(const std::filesystem::path &path,
+                     std::size_t block_size = Default_Block_Size);
+        JSONFileSink(const JSONFileSink &) = delete;
+        ~JSONFileSink() override;
+
+        JSONFileSink &operator=(const JSONFileSink &) = delete;
+
+        void Write(const std::string_view text) override;
+
+        // Stream that writes to this sink
+        std::ostream &Stream() { return stream; }
+
+        // Write the remaining text, commit the file to storage, and close it
+        void Close();
+
+        // Number of octets written to this sink
+        std::uint64_t Size() const;
+
+    protected:
+        struct Writer;
+
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char *text, std::streamsize length)
+            override;
+        int sync() override;
+
+        void Submit();
+
+        std::size_t block_size;                 // Octets in each block
+        std::unique_ptr<Writer> writer;         // Writer thread and file
+        std::ostream stream;                    // Stream writing to this sink
+        bool closed;                            // Close() was called
+};
+
+} // namespace Terra::JSON
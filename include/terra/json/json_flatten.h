@@ -0,0 +1,70 @@
+/*
+ *  json_flatten.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines functions that flatten a JSON value into pairs of
+ *      a JSON Pointer (RFC 6901) and a scalar value, as required to index
+ *      the content of documents.  For example, {"a": {"b": [1, true]}} is
+ *      flattened into the pairs ("/a/b/0", 1) and ("/a/b/1", true).
+ *
+ *      Each pair is passed to the given function as it is visited.  The
+ *      pointer is held in a single buffer that is extended as each object
+ *      or array is entered and truncated as it is left, so no string is
+ *      produced for each value.  Each key is escaped once as it is added to
+ *      the pointer.  The pointer given to the function remains valid only
+ *      until the function returns.
+ *
+ *      Empty objects and arrays have no scalar values, so they are passed
+ *      to the function as values themselves.  Members are visited in the
+ *      order held by the object (i.e., sorted by name) when flattening a
+ *      JSON object, and in the order they appear when flattening JSON text.
+ *
+ *      FlattenText() flattens JSON text without parsing it into JSON
+ *      objects, and passes the text of each value unparsed.  The text is
+ *      first verified to be well-formed, with objects and arrays nested to
+ *      at most the given depth (Default_Validation_Depth unless specified,
+ *      or ParserOptions::No_Limit for no limit).
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Function given the JSON Pointer and value of each scalar by Flatten()
+using JSONFlattenConsumer =
+    std::function<void(const std::u8string_view pointer, const JSON &value)>;
+
+// Function given the JSON Pointer and text of each scalar by FlattenText()
+using JSONFlattenTextConsumer =
+    std::function<void(const std::u8string_view pointer,
+                       const std::u8string_view text)>;
+
+// Flatten the given JSON value into pairs of a JSON Pointer and a scalar
+void Flatten(const JSON &json, const JSONFlattenConsumer &consumer);
+
+// Flatten the given JSON text into pairs of a JSON Pointer and the text of
+// a scalar without parsing the text into JSON objects
+void FlattenText(const std::u8string_view content,
+                 const JSONFlattenTextConsumer &consumer,
+                 std::size_t max_depth = Default_Validation_Depth);
+void FlattenText(const std::string_view content,
+                 const JSONFlattenTextConsumer &consumer,
+                 std::size_t max_depth = Default_Validation_Depth);
+
+} // namespace Terra::JSON
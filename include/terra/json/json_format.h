@@ -0,0 +1,154 @@
+/*
+ *  json_format.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines specializations of std::formatter for the JSON types
+ *      so that they may be given to std::format() and std::format_to().  The
+ *      JSON text is written directly to the format output iterator, so no
+ *      temporary string is produced.  For example:
+ *
+ *          std::format_to(std::back_inserter(buffer), "request: {}", json);
+ *
+ *      The format specification selects the layout of the text:
+ *
+ *          {}      The text produced by ToString()
+ *          {:c}    Compact text without whitespace
+ *          {:i}    Indented text, as produced by a JSONFormatter; the
+ *                  indentation may follow (e.g., {:i4}) and defaults to 2
+ *
+ *      If the library is built with TERRA_DISABLE_STD_FORMAT defined, these
+ *      specializations are not provided.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#ifndef TERRA_DISABLE_STD_FORMAT
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <string_view>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// JSONTextSink that writes to a format output iterator
+template<typename OutputIt>
+class JSONFormatSink : public JSONTextSink
+{
+    public:
+        explicit JSONFormatSink(OutputIt out) : out{out} {}
+        ~JSONFormatSink() override = default;
+
+        void Write(const std::string_view text) override
+        {
+            out = std::copy(text.begin(), text.end(), out);
+        }
+
+        OutputIt Out() const { return out; }
+
+    protected:
+        OutputIt out;                           // Format output iterator
+};
+
+// Formatter for each of the JSON types
+template<typename T>
+struct JSONTypeFormatter
+{
+    JSONTextStyle style{JSONTextStyle::Default};
+    std::size_t indentation{2};
+
+    constexpr auto parse(std::format_parse_context &context)
+    {
+        auto it = context.begin();
+        auto end = context.end();
+
+        if ((it != end) && (*it == 'c'))
+        {
+            style = JSONTextStyle::Compact;
+            ++it;
+        }
+        else if ((it != end) && (*it == 'i'))
+        {
+            style = JSONTextStyle::Indented;
+            ++it;
+            if ((it != end) && (*it >= '0') && (*it <= '9'))
+            {
+                indentation = 0;
+                while ((it != end) && (*it >= '0') && (*it <= '9'))
+                {
+                    indentation = (indentation * 10) + (*it - '0');
+                    ++it;
+                }
+            }
+        }
+
+        if ((it != end) && (*it != '}'))
+        {
+            throw std::format_error("Invalid format specification for JSON");
+        }
+
+        return it;
+    }
+
+    template<typename FormatContext>
+    auto format(const T &value, FormatContext &context) const
+    {
+        JSONFormatSink sink(context.out());
+
+        WriteJSONText(sink, value, style, indentation);
+
+        return sink.Out();
+    }
+};
+
+} // namespace Terra::JSON
+
+template<>
+struct std::formatter<Terra::JSON::JSON> :
+    Terra::JSON::JSONTypeFormatter<Terra::JSON::JSON>
+{
+};
+
+template<>
+struct std::formatter<Terra::JSON::JSONString> :
+    Terra::JSON::JSONTypeFormatter<Terra::JSON::JSONString>
+{
+};
+
+template<>
+struct std::formatter<Terra::JSON::JSONNumber> :
+    Terra::JSON::JSONTypeFormatter<Terra::JSON::JSONNumber>
+{
+};
+
+template<>
+struct std::formatter<Terra::JSON::JSONObject> :
+    Terra::JSON::JSONTypeFormatter<Terra::JSON::JSONObject>
+{
+};
+
+template<>
+struct std::formatter<Terra::JSON::JSONArray> :
+    Terra::JSON::JSONTypeFormatter<Terra::JSON::JSONArray>
+{
+};
+
+template<>
+struct std::formatter<Terra::JSON::JSONLiteral> :
+    Terra::JSON::JSONTypeFormatter<Terra::JSON::JSONLiteral>
+{
+};
+
+#endif // TERRA_DISABLE_STD_FORMAT
@@ -0,0 +1,82 @@
+/*
+ *  json_gzip.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines functions that parse JSON text compressed using
+ *      gzip (or the zlib format) without first reading the compressed data
+ *      into memory.  Compressed data is read one block at a time and
+ *      decompressed directly into the buffer from which the text is parsed,
+ *      so only the decompressed text and one block of compressed data are
+ *      held in memory.
+ *
+ *      ParseGzip() parses a single JSON document.  ParseGzipLines() parses
+ *      text holding one JSON value per line (i.e., JSON Lines), and does so
+ *      in a pipeline: one thread decompresses blocks while the calling
+ *      thread parses each line as it becomes available and passes the
+ *      resulting value to the caller.  Only a few blocks are held at once,
+ *      so the memory required does not depend on the size of the text.
+ *
+ *      These are available only if the library is built with the
+ *      libjson_ZLIB option, which requires zlib.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Source of text decompressed from a gzip or zlib stream, one block at a time
+class JSONGzipSource
+{
+    public:
+        // Default number of octets of compressed data read at once
+        static constexpr std::size_t Default_Block_Size = 64 * 1024;
+
+        JSONGzipSource(std::istream &input,
+                       std::size_t block_size = Default_Block_Size);
+        JSONGzipSource(const JSONGzipSource &) = delete;
+        ~JSONGzipSource();
+
+        JSONGzipSource &operator=(const JSONGzipSource &) = delete;
+
+        // Decompress the next block of text, appending it to the given
+        // string; returns false once all of the text has been read
+        bool Read(std::u8string &text);
+
+    protected:
+        struct Stream;
+
+        std::istream &input;                    // Compressed data
+        std::size_t block_size;                 // Octets to read at once
+        std::unique_ptr<Stream> stream;         // Decompression state
+        bool finished;                          // All text was read
+};
+
+// Parse the JSON document compressed within the given stream
+JSON ParseGzip(std::istream &input, const ParserOptions &options = {});
+
+// Parse the JSON values, one per line, compressed within the given stream,
+// passing each to the consumer in order; blank lines are ignored, and the
+// number of values parsed is returned
+std::size_t ParseGzipLines(std::istream &input,
+                           const std::function<void(JSON &&)> &consumer,
+                           const ParserOptions &options = {});
+
+} // namespace Terra::JSON
@@ -0,0 +1,99 @@
+/*
+ *  json_index.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines the JSONArrayIndex, which is a secondary index over
+ *      an array of objects.  Documents commonly contain arrays of objects
+ *      that are identified by the value of a member, such as:
+ *
+ *          "users": [ { "id": 1, ... }, { "id": 2, ... }, ... ]
+ *
+ *      Finding an element by "id" would otherwise require a linear scan over
+ *      the array and a lookup within each object.  The JSONArrayIndex builds
+ *      a hash table that maps the value of the given member (or a member of
+ *      a nested object, specified as a path of keys) to the position of the
+ *      element in the array, allowing elements to be found in constant time.
+ *
+ *      Only string, number, and literal values are indexed.  Numbers are
+ *      compared by value, so 42 and 42.0 are the same key.  If more than one
+ *      element holds the same key, the first such element is found.
+ *
+ *      The index records the array's Version() when built and is rebuilt
+ *      automatically on the next lookup if elements were inserted, erased,
+ *      or reordered.  Elements appended via Emplace() are added to the index.
+ *      Modifying elements (e.g., via operator[]) does not invalidate the
+ *      index: each element found is verified to still hold the requested
+ *      key, and the index is rebuilt only if it does not, or if a key is not
+ *      found after elements were modified.  An element accessed via
+ *      operator[] is re-indexed on the next lookup if it is the only one
+ *      accessed since the previous lookup.  Thus, finding or updating an
+ *      element between lookups does not cause the index to be rebuilt, and
+ *      it is rebuilt at most once per change otherwise.  If the array's
+ *      value member is modified directly, Rebuild() should be called.
+ *
+ *      The array must outlive the index.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <variant>
+#include <unordered_map>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Secondary index over an array of objects
+class JSONArrayIndex
+{
+    public:
+        // Value returned by FindPosition() when no element is found
+        static constexpr std::size_t Not_Found = static_cast<std::size_t>(-1);
+
+        JSONArrayIndex(JSONArray &array, const std::u8string &key);
+        JSONArrayIndex(JSONArray &array, const std::string &key);
+        JSONArrayIndex(JSONArray &array, std::vector<std::u8string> path);
+        ~JSONArrayIndex() = default;
+
+        void Rebuild();
+
+        std::size_t FindPosition(const JSON &key);
+        const JSON *Find(const JSON &key);
+
+        std::size_t Size() const { return positions.size(); }
+
+    protected:
+        // Normalized form of an indexed value
+        using Key = std::variant<std::u8string,
+                                 JSONInteger,
+                                 JSONFloat,
+                                 JSONLiteral>;
+
+        static bool MakeKey(const JSON &value, Key &key);
+        const JSON *Lookup(const JSON &element) const;
+        void IndexElement(std::size_t position);
+        void IndexElements();
+
+        JSONArray &array;                       // Indexed array
+        std::vector<std::u8string> path;        // Path to the indexed member
+        std::uint64_t version;                  // Array version when built
+        std::uint64_t element_version;          // Element version when built
+        std::size_t size;                       // Array size when built
+        std::unordered_map<Key, std::size_t> positions;
+};
+
+} // namespace Terra::JSON
@@ -0,0 +1,176 @@
+/*
+ *  json_node_pool.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines the NodePool, which is a size-class pool allocator
+ *      intended for the many small, fixed-size allocations made by long-lived
+ *      and frequently mutated JSON documents (e.g., JSON elements in arrays
+ *      and the nodes of the map within a JSONObject).
+ *
+ *      Memory is obtained from the system in aligned chunks, with each chunk
+ *      carved into blocks of a single size class.  Every thread has its own
+ *      cache of free blocks, so allocation and deallocation on the owning
+ *      thread require no locking.  A block freed by a thread other than the
+ *      one that allocated it is pushed onto a lock-free list belonging to the
+ *      owning cache and reclaimed by the owning thread on its next refill.
+ *      When a thread exits, its cache is retained and later adopted by a new
+ *      thread, so blocks may safely outlive the thread that allocated them.
+ *
+ *      Requests larger than the largest size class, or having an alignment
+ *      requirement larger than Alignment, are passed to operator new.
+ *
+ *      The NodePoolAllocator is a standard allocator that may be used with
+ *      any standard container.  If the library is built with the CMake
+ *      option libjson_NODE_POOL, the JSONObject and JSONArray types use it
+ *      for their storage.
+ *
+ *      A SequentialRegion may be created to have the blocks allocated by a
+ *      thread placed one after another in memory, which is useful when
+ *      building a document that will be traversed in the order it was built.
+ *
+ *      Statistics describing use of the pool, including fragmentation (the
+ *      portion of reserved memory not in use) and the time spent obtaining
+ *      memory from the system, are available via NodePool::GetStats().
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <new>
+#include <limits>
+
+namespace Terra::JSON
+{
+
+// Statistics describing the use of the NodePool
+struct NodePoolStats
+{
+    // Number of size classes served by the pool
+    static constexpr std::size_t Size_Classes = 12;
+
+    std::uint64_t allocations{};                // Blocks allocated
+    std::uint64_t deallocations{};              // Blocks freed
+    std::uint64_t remote_deallocations{};       // Blocks freed by non-owners
+    std::uint64_t large_allocations{};          // Requests given to new
+    std::uint64_t chunks{};                     // Chunks held by the pool
+    std::uint64_t bytes_reserved{};             // Bytes held in chunks
+    std::uint64_t bytes_in_use{};               // Bytes in allocated blocks
+    std::uint64_t refills{};                    // Slow path allocations
+    std::uint64_t refill_nanoseconds{};         // Time spent in slow path
+    std::uint64_t max_refill_nanoseconds{};     // Slowest slow path
+    std::uint64_t region_allocations{};         // Blocks placed in regions
+    std::uint64_t region_bytes_reserved{};      // Bytes held by regions
+
+    // Bytes in use for each size class
+    std::array<std::uint64_t, Size_Classes> class_bytes_in_use{};
+
+    // Bytes reserved for each size class
+    std::array<std::uint64_t, Size_Classes> class_bytes_reserved{};
+
+    // Portion of reserved memory not presently in use (0.0 to 1.0)
+    double Fragmentation() const
+    {
+        if (bytes_reserved == 0) return 0.0;
+        return 1.0 - (static_cast<double>(bytes_in_use) /
+                      static_cast<double>(bytes_reserved));
+    }
+
+    // Average time spent in the slow path, in nanoseconds
+    double AverageRefillNanoseconds() const
+    {
+        if (refills == 0) return 0.0;
+        return static_cast<double>(refill_nanoseconds) /
+               static_cast<double>(refills);
+    }
+};
+
+// Size-class pool from which JSON nodes are allocated
+class NodePool
+{
+    public:
+        // Alignment of every block returned by the pool
+        static constexpr std::size_t Alignment = 16;
+
+        // Largest request served from a size class
+        static constexpr std::size_t Maximum_Block_Size = 512;
+
+        // Size of each chunk of memory obtained from the system
+        static constexpr std::size_t Chunk_Size = 64 * 1024;
+
+        static void *Allocate(std::size_t size,
+                              std::size_t alignment = Alignment);
+        static void Deallocate(void *pointer,
+                               std::size_t size,
+                               std::size_t alignment = Alignment) noexcept;
+
+        static NodePoolStats GetStats();
+
+        // While an object of this type exists, blocks allocated by the thread
+        // that created it are placed one after another in a dedicated region
+        // rather than taken from the size classes.  The region's memory is
+        // returned to the system once every block within it has been freed.
+        class SequentialRegion
+        {
+            public:
+                SequentialRegion();
+                SequentialRegion(const SequentialRegion &) = delete;
+                ~SequentialRegion();
+
+                SequentialRegion &operator=(const SequentialRegion &) = delete;
+
+                struct State;
+
+            protected:
+                State *state;                   // Region state
+                State *previous;                // Previously active region
+        };
+};
+
+// Standard allocator that obtains memory from the NodePool
+template<typename T>
+class NodePoolAllocator
+{
+    public:
+        using value_type = T;
+
+        NodePoolAllocator() noexcept = default;
+        template<typename U>
+        NodePoolAllocator(const NodePoolAllocator<U> &) noexcept
+        {
+        }
+
+        T *allocate(std::size_t n)
+        {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T *>(
+                NodePool::Allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *pointer, std::size_t n) noexcept
+        {
+            NodePool::Deallocate(pointer, n * sizeof(T), alignof(T));
+        }
+
+        template<typename U>
+        bool operator==(const NodePoolAllocator<U> &) const noexcept
+        {
+            return true;
+        }
+};
+
+} // namespace Terra::JSON
@@ -0,0 +1,102 @@
+/*
+ *  json_offset_index.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines the JSONOffsetIndex, which provides random access
+ *      to the values within a large JSON file.  Such files are commonly
+ *      either a single array holding a great many elements or a sequence of
+ *      JSON values with one value per line (e.g., NDJSON or JSON Lines).
+ *      Parsing such a file in full to access one element is prohibitive.
+ *
+ *      Build() makes a single pass over the data file and writes an index
+ *      file (a "sidecar") holding the byte offset and length of each
+ *      top-level value.  Optionally, the offset and length of each member
+ *      of those values that are objects are also recorded.  Scalar values
+ *      and members are located, but their content is not otherwise
+ *      verified to be well-formed until they are parsed.
+ *
+ *      A JSONOffsetIndex object maps the data file and index file into
+ *      memory and parses only the value requested, so accessing any value
+ *      takes constant time, regardless of its position in the file.
+ *
+ *      The index file records the size of the data file and the byte order
+ *      of the machine that wrote it.  An index that does not match the data
+ *      file or machine is rejected, and must be rebuilt.  Modifying the data
+ *      file while it is mapped results in undefined behavior.
+ *
+ *  Portability Issues:
+ *      Files are mapped into memory on POSIX systems.  Elsewhere, the files
+ *      are read into memory instead.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Random access to the values within a large JSON file
+class JSONOffsetIndex
+{
+    public:
+        // Arrangement of the values within the data file
+        enum class Layout : std::uint32_t
+        {
+            Array = 1,                          // Elements of one array
+            Lines = 2                           // One value per line
+        };
+
+        JSONOffsetIndex(const std::filesystem::path &data_file,
+                        const std::filesystem::path &index_file,
+                        const ParserOptions &options = {});
+        ~JSONOffsetIndex() = default;
+
+        static void Build(const std::filesystem::path &data_file,
+                          const std::filesystem::path &index_file,
+                          Layout layout,
+                          bool index_members = false);
+
+        Layout GetLayout() const { return layout; }
+        std::size_t Size() const { return elements; }
+        bool HasMembers() const { return members_indexed; }
+
+        std::u8string_view Text(std::size_t position) const;
+        JSON Get(std::size_t position) const;
+
+        std::u8string_view MemberText(std::size_t position,
+                                      const std::u8string_view name) const;
+        JSON GetMember(std::size_t position,
+                       const std::u8string_view name) const;
+        JSON GetMember(std::size_t position,
+                       const std::string_view name) const;
+
+    protected:
+        std::uint64_t ReadIndex(std::size_t position) const;
+        std::u8string_view Extent(std::size_t position) const;
+
+        ParserOptions options;                  // Options for parsing
+        std::shared_ptr<const void> data_map;   // Mapping of the data file
+        std::shared_ptr<const void> index_map;  // Mapping of the index file
+        std::u8string_view data;                // Content of the data file
+        std::u8string_view index;               // Content of the index file
+        Layout layout;                          // Arrangement of values
+        bool members_indexed;                   // Members were indexed
+        std::size_t elements;                   // Number of values indexed
+        std::size_t members;                    // Number of members indexed
+};
+
+} // namespace Terra::JSON
@@ -0,0 +1,93 @@
+/*
+ *  json_parse_cache.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines the JSONParseCache, which may be placed in front of
+ *      the JSONParser when the same JSON text is parsed repeatedly (e.g.,
+ *      polling responses, configuration, or retried requests).  Parsed
+ *      documents are held in a bounded cache, keyed by a hash of the text,
+ *      and shared with callers as immutable objects.  Parsing text already
+ *      in the cache requires only computing the hash, comparing the text,
+ *      and incrementing a reference count.
+ *
+ *      When the cache is full, the least recently used document is evicted.
+ *      Callers holding an evicted document may continue to use it.  Text
+ *      that fails to parse is not cached.
+ *
+ *      The cache may be used by multiple threads.  Since cached documents
+ *      are shared, they are always parsed in full (i.e., the lazy option is
+ *      ignored), as lazy expansion would modify a shared document.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Counters describing the use of a JSONParseCache
+struct JSONParseCacheStatistics
+{
+    std::uint64_t hits{0};                      // Parses found in cache
+    std::uint64_t misses{0};                    // Parses not found in cache
+    std::uint64_t evictions{0};                 // Documents evicted
+};
+
+// Bounded cache of parsed JSON documents
+class JSONParseCache
+{
+    public:
+        JSONParseCache(std::size_t capacity,
+                       const ParserOptions &options = {});
+        ~JSONParseCache() = default;
+
+        std::shared_ptr<const JSON> Parse(const std::string_view content);
+        std::shared_ptr<const JSON> Parse(const std::u8string_view content);
+
+        JSONParseCacheStatistics GetStatistics() const;
+        std::size_t Size() const;
+        std::size_t Capacity() const { return capacity; }
+        void Clear();
+
+    protected:
+        // Cached document and the text from which it was parsed
+        struct Entry
+        {
+            std::uint64_t hash;
+            std::u8string content;
+            std::shared_ptr<const JSON> json;
+        };
+
+        using EntryList = std::list<Entry>;
+
+        EntryList::iterator Find(std::uint64_t hash,
+                                 const std::u8string_view content);
+
+        const std::size_t capacity;             // Maximum documents cached
+        ParserOptions options;                  // Options for parsing
+        mutable std::mutex mutex;               // Protects the members below
+        EntryList entries;                      // Most recently used first
+        std::unordered_multimap<std::uint64_t, EntryList::iterator> lookup;
+        JSONParseCacheStatistics statistics;    // Counters
+};
+
+} // namespace Terra::JSON
@@ -22,6 +22,9 @@
 namespace Terra::JSON
 {
 
+// Annex marking values that might be modified via a retained reference
+JSON::Annex JSON::Exposed_Annex{};
+
 /*
  *  operator<<()
  *
@@ -134,6 +137,9 @@ JSONValueType JSON::GetValueType() const
  */
 void JSON::AssignType(JSONValueType type)
 {
+    // Any text yet to be parsed and any retained text is discarded
+    annex.reset();
+
     switch(type)
     {
         case JSONValueType::String:
@@ -183,6 +189,13 @@ void JSON::AssignType(JSONValueType type)
  */
 JSON &JSON::operator[](std::size_t index)
 {
+    // Parse the value if parsing was deferred
+    Expand();
+
+    // The value might be modified via the returned reference, so any
+    // retained text is discarded and will not be retained again
+    Expose();
+
     // Ensure the JSON object holds an array
     if (!std::holds_alternative<JSONArray>(value))
     {
@@ -213,6 +226,9 @@ JSON &JSON::operator[](std::size_t index)
  */
 const JSON &JSON::operator[](std::size_t index) const
 {
+    // Parse the value if parsing was deferred
+    Expand();
+
     // Ensure the JSON object holds an array
     if (!std::holds_alternative<JSONArray>(value))
     {
@@ -243,6 +259,13 @@ const JSON &JSON::operator[](std::size_t index) const
  */
 JSON &JSON::operator[](const std::u8string &key)
 {
+    // Parse the value if parsing was deferred
+    Expand();
+
+    // The value might be modified via the returned reference, so any
+    // retained text is discarded and will not be retained again
+    Expose();
+
     // Ensure the JSON object holds an array
     if (!std::holds_alternative<JSONObject>(value))
     {
@@ -273,6 +296,9 @@ JSON &JSON::operator[](const std::u8string &key)
  */
 const JSON &JSON::operator[](const std::u8string &key) const
 {
+    // Parse the value if parsing was deferred
+    Expand();
+
     // Ensure the JSON object holds an array
     if (!std::holds_alternative<JSONObject>(value))
     {
@@ -282,6 +308,192 @@ const JSON &JSON::operator[](const std::u8string &key) const
     return std::get<JSONObject>(value)[key];
 }
 
+/*
+ *  JSON::operator[]()
+ *
+ *  Description:
+ *      This function is used to access the JSON object with the assumption
+ *      that it is holding an object.  It will verify that it does hold an
+ *      object and, if so, access the index operator of the object to
+ *      retrieve the JSON object having the given key.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key used to access information in the JSON object.
+ *
+ *  Returns:
+ *      A reference to the JSON object having the given key.
+ *
+ *  Comments:
+ *      The key is not copied unless a member is inserted.
+ */
+JSON &JSON::operator[](const std::string &key)
+{
+    // Parse the value if parsing was deferred
+    Expand();
+
+    // The value might be modified via the returned reference, so any
+    // retained text is discarded and will not be retained again
+    Expose();
+
+    // Ensure the JSON object holds an object
+    if (!std::holds_alternative<JSONObject>(value))
+    {
+        throw JSONException("JSON object does not contain an object type");
+    }
+
+    return std::get<JSONObject>(value)[key];
+}
+
+/*
+ *  JSON::operator[]()
+ *
+ *  Description:
+ *      This function is used to access the JSON object with the assumption
+ *      that it is holding an object.  It will verify that it does hold an
+ *      object and, if so, access the index operator of the object to
+ *      retrieve the JSON object having the given key.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key used to access information in the JSON object.
+ *
+ *  Returns:
+ *      A reference to the JSON object having the given key.
+ *
+ *  Comments:
+ *      The key is not copied.
+ */
+const JSON &JSON::operator[](const std::string &key) const
+{
+    // Parse the value if parsing was deferred
+    Expand();
+
+    // Ensure the JSON object holds an object
+    if (!std::holds_alternative<JSONObject>(value))
+    {
+        throw JSONException("JSON object does not contain an object type");
+    }
+
+    return std::get<JSONObject>(value)[key];
+}
+
+/*
+ *  JSON::operator[]()
+ *
+ *  Description:
+ *      This function is used to access the JSON object with the assumption
+ *      that it is holding an object.  It will verify that it does hold an
+ *      object and, if so, access the index operator of the object to
+ *      retrieve the JSON object having the given key.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key used to access information in the JSON object.
+ *
+ *  Returns:
+ *      A reference to the JSON object having the given key.
+ *
+ *  Comments:
+ *      None.
+ */
+JSON &JSON::operator[](const JSONKey &key)
+{
+    // Parse the value if parsing was deferred
+    Expand();
+
+    // The value might be modified via the returned reference, so any
+    // retained text is discarded and will not be retained again
+    Expose();
+
+    // Ensure the JSON object holds an object
+    if (!std::holds_alternative<JSONObject>(value))
+    {
+        throw JSONException("JSON object does not contain an object type");
+    }
+
+    return std::get<JSONObject>(value)[key];
+}
+
+/*
+ *  JSON::operator[]()
+ *
+ *  Description:
+ *      This function is used to access the JSON object with the assumption
+ *      that it is holding an object.  It will verify that it does hold an
+ *      object and, if so, access the index operator of the object to
+ *      retrieve the JSON object having the given key.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key used to access information in the JSON object.
+ *
+ *  Returns:
+ *      A reference to the JSON object having the given key.
+ *
+ *  Comments:
+ *      None.
+ */
+const JSON &JSON::operator[](const JSONKey &key) const
+{
+    // Parse the value if parsing was deferred
+    Expand();
+
+    // Ensure the JSON object holds an object
+    if (!std::holds_alternative<JSONObject>(value))
+    {
+        throw JSONException("JSON object does not contain an object type");
+    }
+
+    return std::get<JSONObject>(value)[key];
+}
+
+/*
+ *  JSON::ExtractMember()
+ *
+ *  Description:
+ *      This function will remove the member having the given key from the
+ *      object held by this JSON object.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member to remove.
+ *
+ *  Returns:
+ *      A node owning the member's key and value, which is empty if there is
+ *      no such member.  A JSONException is thrown if this JSON object does
+ *      not hold an object.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONObjectMap::node_type JSON::ExtractMember(const std::u8string_view key)
+{
+    return GetValue<JSONObject>().Extract(key);
+}
+
+/*
+ *  JSON::ConsumeArray()
+ *
+ *  Description:
+ *      This function will take the elements of the array held by this JSON
+ *      object, presenting them as a range whose elements may be moved out.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The range of elements.  A JSONException is thrown if this JSON object
+ *      does not hold an array.
+ *
+ *  Comments:
+ *      This JSON object is left holding an empty array.
+ */
+JSONArrayConsumer JSON::ConsumeArray()
+{
+    return JSONArrayConsumer(TakeArray());
+}
+
 /*
  *  JSON::ToString()
  *
@@ -16,7 +16,11 @@
  *      None.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <string>
+#include <limits>
 #include <terra/json/json.h>
 
 namespace Terra::JSON
@@ -85,6 +89,61 @@ JSONArray::JSONArray(const std::initializer_list<JSON> &list) : value{}
     value.insert(value.end(), list);
 }
 
+/*
+ *  JSONArray::operator=()
+ *
+ *  Description:
+ *      Assign the elements of the given array to this array.
+ *
+ *  Parameters:
+ *      other [in]
+ *          The array whose elements are copied.
+ *
+ *  Returns:
+ *      A reference to this array.
+ *
+ *  Comments:
+ *      The content of the array is replaced, so the version is advanced
+ *      beyond that of both arrays rather than copied; otherwise, assigning
+ *      an array having the same version and size would go unnoticed.
+ */
+JSONArray &JSONArray::operator=(const JSONArray &other)
+{
+    value = other.value;
+    version = std::max(version, other.version) + 1;
+    element_version = std::max(element_version, other.element_version) + 1;
+
+    return *this;
+}
+
+/*
+ *  JSONArray::operator=()
+ *
+ *  Description:
+ *      Move the elements of the given array into this array.
+ *
+ *  Parameters:
+ *      other [in]
+ *          The array whose elements are moved.
+ *
+ *  Returns:
+ *      A reference to this array.
+ *
+ *  Comments:
+ *      The versions of both arrays are advanced, as the content of both
+ *      is changed.
+ */
+JSONArray &JSONArray::operator=(JSONArray &&other)
+{
+    value = std::move(other.value);
+    version = std::max(version, other.version) + 1;
+    element_version = std::max(element_version, other.element_version) + 1;
+    other.version++;
+    other.element_version++;
+
+    return *this;
+}
+
 /*
  *  JSONArray::operator[]()
  *
@@ -99,10 +158,14 @@ JSONArray::JSONArray(const std::initializer_list<JSON> &list) : value{}
  *      A reference to the JSON element in the array at the given index.
  *
  *  Comments:
- *      None.
+ *      Since the returned element may be modified, the array's element
+ *      version is incremented and the index is recorded as the one last
+ *      accessed.  The array's structure is unchanged, so Version() is not.
  */
 JSON &JSONArray::operator[](const std::size_t index)
 {
+    element_version++;
+    last_accessed = index;
     return value[index];
 }
 
@@ -127,6 +190,147 @@ const JSON &JSONArray::operator[](const std::size_t index) const
     return value[index];
 }
 
+/*
+ *  JSONArray::FromSpan()
+ *
+ *  Description:
+ *      Construct an array of numbers from the given values.
+ *
+ *  Parameters:
+ *      values [in]
+ *          The values to place into the array.
+ *
+ *  Returns:
+ *      The array.  A JSONException is thrown if an unsigned value exceeds
+ *      the range of a JSONInteger.
+ *
+ *  Comments:
+ *      The array's storage is allocated once and each number is constructed
+ *      in place.
+ */
+template<JSONArithmetic T>
+JSONArray JSONArray::FromSpan(std::span<const T> values)
+{
+    JSONArray array;
+
+    array.value.reserve(values.size());
+    for (const T number : values) array.value.emplace_back(JSONNumber(number));
+
+    return array;
+}
+
+/*
+ *  JSONArray::ToVector()
+ *
+ *  Description:
+ *      Return the elements of an array of numbers as a vector of the given
+ *      type.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The numbers.  A JSONException is thrown if any element is not a
+ *      number or is not representable as the type.
+ *
+ *  Comments:
+ *      Integral types accept only integers within range of the type.
+ *      Floating point types accept any number within range of the type.
+ */
+template<JSONArithmetic T>
+std::vector<T> JSONArray::ToVector() const
+{
+    std::vector<T> numbers;
+
+    numbers.reserve(value.size());
+
+    for (const JSON &element : value)
+    {
+        if (element.GetValueType() != JSONValueType::Number)
+        {
+            throw JSONException("Array element " +
+                                std::to_string(numbers.size()) +
+                                " is not a number");
+        }
+
+        const JSONNumber &number = element.GetValue<JSONNumber>();
+
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            JSONFloat floating = number.GetFloat();
+            if (std::isfinite(floating) &&
+                ((floating > std::numeric_limits<T>::max()) ||
+                 (floating < std::numeric_limits<T>::lowest())))
+            {
+                throw JSONException("Array element " +
+                                    std::to_string(numbers.size()) +
+                                    " is not representable as the type");
+            }
+            numbers.push_back(static_cast<T>(floating));
+        }
+        else
+        {
+            JSONInteger integer = number.GetInteger();
+            bool representable = number.IsInteger();
+            if constexpr (std::is_unsigned<T>::value)
+            {
+                representable = representable && (integer >= 0) &&
+                                (static_cast<unsigned long long>(integer) <=
+                                 std::numeric_limits<T>::max());
+            }
+            else
+            {
+                representable = representable &&
+                                (integer >= std::numeric_limits<T>::min()) &&
+                                (integer <= std::numeric_limits<T>::max());
+            }
+            if (!representable)
+            {
+                throw JSONException("Array element " +
+                                    std::to_string(numbers.size()) +
+                                    " is not representable as the type");
+            }
+            numbers.push_back(static_cast<T>(integer));
+        }
+    }
+
+    return numbers;
+}
+
+// Instantiate the above for each JSONArithmetic type
+template JSONArray JSONArray::FromSpan<signed char>(
+                                        std::span<const signed char>);
+template JSONArray JSONArray::FromSpan<short>(std::span<const short>);
+template JSONArray JSONArray::FromSpan<int>(std::span<const int>);
+template JSONArray JSONArray::FromSpan<long>(std::span<const long>);
+template JSONArray JSONArray::FromSpan<long long>(std::span<const long long>);
+template JSONArray JSONArray::FromSpan<unsigned char>(
+                                        std::span<const unsigned char>);
+template JSONArray JSONArray::FromSpan<unsigned short>(
+                                        std::span<const unsigned short>);
+template JSONArray JSONArray::FromSpan<unsigned>(std::span<const unsigned>);
+template JSONArray JSONArray::FromSpan<unsigned long>(
+                                        std::span<const unsigned long>);
+template JSONArray JSONArray::FromSpan<unsigned long long>(
+                                        std::span<const unsigned long long>);
+template JSONArray JSONArray::FromSpan<float>(std::span<const float>);
+template JSONArray JSONArray::FromSpan<double>(std::span<const double>);
+template std::vector<signed char> JSONArray::ToVector<signed char>() const;
+template std::vector<short> JSONArray::ToVector<short>() const;
+template std::vector<int> JSONArray::ToVector<int>() const;
+template std::vector<long> JSONArray::ToVector<long>() const;
+template std::vector<long long> JSONArray::ToVector<long long>() const;
+template std::vector<unsigned char>
+    JSONArray::ToVector<unsigned char>() const;
+template std::vector<unsigned short>
+    JSONArray::ToVector<unsigned short>() const;
+template std::vector<unsigned> JSONArray::ToVector<unsigned>() const;
+template std::vector<unsigned long> JSONArray::ToVector<unsigned long>() const;
+template std::vector<unsigned long long>
+    JSONArray::ToVector<unsigned long long>() const;
+template std::vector<float> JSONArray::ToVector<float>() const;
+template std::vector<double> JSONArray::ToVector<double>() const;
+
 /*
  *  JSONArray::Size()
  *
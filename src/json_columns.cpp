@@ -0,0 +1,725 @@
+/*
+ *  json_columns.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements ExtractColumns().
+ *
+ *      When extracting from a JSONArray, the path of each column is followed
+ *      within each element by finding each key in turn without copying it.
+ *      When extracting from JSON text, the column paths are
+ *      arranged as a tree of keys, and the members of each element are
+ *      visited once: members whose names are in the tree are descended into
+ *      or converted, and all other members are skipped without examining
+ *      their content beyond finding their end.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <terra/json/json_columns.h>
+#include "json_scan.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Builder of the columns, one element (row) at a time
+class ColumnBuilder
+{
+    public:
+        ColumnBuilder(const std::vector<JSONColumnSpec> &specs,
+                      std::size_t rows);
+        ~ColumnBuilder() = default;
+
+        void AddRow();
+        bool Filled(std::size_t column) const
+        {
+            return columns[column].IsValid(row);
+        }
+        void Store(std::size_t column, const JSON &value);
+        void StoreText(std::size_t column,
+                       const char8_t *p,
+                       const char8_t *end);
+        std::vector<JSONColumn> Finish() { return std::move(columns); }
+
+    protected:
+        template<typename T>
+        T &Value(std::size_t column)
+        {
+            return std::get<std::vector<T>>(columns[column].values).back();
+        }
+        void SetValid(std::size_t column);
+        [[noreturn]] void WrongType(std::size_t column) const;
+
+        std::vector<JSONColumn> columns;        // Columns being built
+        std::size_t row;                        // Current row
+};
+
+/*
+ *  ColumnBuilder::ColumnBuilder()
+ *
+ *  Description:
+ *      Constructor for the ColumnBuilder.
+ *
+ *  Parameters:
+ *      specs [in]
+ *          The specification of each column.
+ *
+ *      rows [in]
+ *          The expected number of rows, used to reserve space.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+ColumnBuilder::ColumnBuilder(const std::vector<JSONColumnSpec> &specs,
+                             std::size_t rows) :
+    columns(specs.size()),
+    row{static_cast<std::size_t>(-1)}
+{
+    for (std::size_t i = 0; i < specs.size(); i++)
+    {
+        JSONColumn &column = columns[i];
+
+        column.type = specs[i].type;
+        switch (column.type)
+        {
+            case JSONColumnType::Integer:
+                column.values = std::vector<JSONInteger>();
+                break;
+
+            case JSONColumnType::Float:
+                column.values = std::vector<JSONFloat>();
+                break;
+
+            case JSONColumnType::Boolean:
+                column.values = std::vector<std::uint8_t>();
+                break;
+
+            case JSONColumnType::String:
+                column.values = std::vector<std::u8string>();
+                break;
+
+            default:
+                throw JSONException("Invalid column type");
+        }
+
+        std::visit([&](auto &values) { values.reserve(rows); },
+                   column.values);
+        column.validity.reserve((rows + 63) / 64);
+    }
+}
+
+/*
+ *  ColumnBuilder::AddRow()
+ *
+ *  Description:
+ *      Add a row to each column, initially holding an invalid default value.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void ColumnBuilder::AddRow()
+{
+    row++;
+
+    for (auto &column : columns)
+    {
+        std::visit([](auto &values) { values.emplace_back(); },
+                   column.values);
+        if ((row % 64) == 0) column.validity.push_back(0);
+        column.invalid_count++;
+    }
+}
+
+/*
+ *  ColumnBuilder::Store()
+ *
+ *  Description:
+ *      Store the given value in the current row of the given column.
+ *
+ *  Parameters:
+ *      column [in]
+ *          The column in which to store the value.
+ *
+ *      value [in]
+ *          The value to store.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the value is not of the
+ *      column's type.
+ *
+ *  Comments:
+ *      A null value leaves the row invalid.
+ */
+void ColumnBuilder::Store(std::size_t column, const JSON &value)
+{
+    JSONColumnType type = columns[column].type;
+
+    switch (value.GetValueType())
+    {
+        case JSONValueType::Literal:
+        {
+            JSONLiteral literal = value.GetValue<JSONLiteral>();
+            if (literal == JSONLiteral::Null) return;
+            if (type != JSONColumnType::Boolean) WrongType(column);
+            Value<std::uint8_t>(column) = (literal == JSONLiteral::True);
+            break;
+        }
+
+        case JSONValueType::Number:
+        {
+            const JSONNumber &number = value.GetValue<JSONNumber>();
+            if ((type == JSONColumnType::Integer) && number.IsInteger())
+            {
+                Value<JSONInteger>(column) = number.GetInteger();
+            }
+            else if (type == JSONColumnType::Float)
+            {
+                Value<JSONFloat>(column) = number.GetFloat();
+            }
+            else
+            {
+                WrongType(column);
+            }
+            break;
+        }
+
+        case JSONValueType::String:
+            if (type != JSONColumnType::String) WrongType(column);
+            Value<std::u8string>(column) = *value.GetValue<JSONString>();
+            break;
+
+        default:
+            WrongType(column);
+    }
+
+    SetValid(column);
+}
+
+/*
+ *  ColumnBuilder::StoreText()
+ *
+ *  Description:
+ *      Store the value having the given text in the current row of the given
+ *      column.
+ *
+ *  Parameters:
+ *      column [in]
+ *          The column in which to store the value.
+ *
+ *      p [in]
+ *          The start of the value's text, which must be well-formed.
+ *
+ *      end [in]
+ *          One past the end of the value's text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the value is not of the
+ *      column's type or the number is out of range.
+ *
+ *  Comments:
+ *      A null value leaves the row invalid.
+ */
+void ColumnBuilder::StoreText(std::size_t column,
+                              const char8_t *p,
+                              const char8_t *end)
+{
+    JSONColumnType type = columns[column].type;
+    const char *first = reinterpret_cast<const char *>(p);
+    const char *last = reinterpret_cast<const char *>(end);
+    std::from_chars_result result{};
+
+    switch (*p)
+    {
+        case 'n':
+            return;
+
+        case 't':
+        case 'f':
+            if (type != JSONColumnType::Boolean) WrongType(column);
+            Value<std::uint8_t>(column) = (*p == 't');
+            break;
+
+        case '"':
+            if (type != JSONColumnType::String) WrongType(column);
+            Value<std::u8string>(column) =
+                DecodeString(std::u8string_view(p + 1, end - p - 2));
+            break;
+
+        case '{':
+        case '[':
+            WrongType(column);
+
+        default:
+            if (type == JSONColumnType::Integer)
+            {
+                if (std::u8string_view(p, end - p).find_first_of(u8".eE") !=
+                    std::u8string_view::npos)
+                {
+                    WrongType(column);
+                }
+                result = std::from_chars(first,
+                                         last,
+                                         Value<JSONInteger>(column));
+            }
+            else if (type == JSONColumnType::Float)
+            {
+                result = std::from_chars(first, last, Value<JSONFloat>(column));
+            }
+            else
+            {
+                WrongType(column);
+            }
+            if (result.ec != std::errc())
+            {
+                throw JSONException("Number out of range in element " +
+                                    std::to_string(row));
+            }
+            break;
+    }
+
+    SetValid(column);
+}
+
+/*
+ *  ColumnBuilder::SetValid()
+ *
+ *  Description:
+ *      Record that the current row of the given column holds a value.
+ *
+ *  Parameters:
+ *      column [in]
+ *          The column holding the value.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void ColumnBuilder::SetValid(std::size_t column)
+{
+    columns[column].validity[row / 64] |= std::uint64_t(1) << (row % 64);
+    columns[column].invalid_count--;
+}
+
+/*
+ *  ColumnBuilder::WrongType()
+ *
+ *  Description:
+ *      Report a value that is not of the column's type.
+ *
+ *  Parameters:
+ *      column [in]
+ *          The column for which the value was found.
+ *
+ *  Returns:
+ *      Does not return, as a JSONException is thrown.
+ *
+ *  Comments:
+ *      None.
+ */
+void ColumnBuilder::WrongType(std::size_t column) const
+{
+    throw JSONException("Element " + std::to_string(row) +
+                        " holds a value of the wrong type for column " +
+                        std::to_string(column));
+}
+
+// Node in the tree of keys formed by the column paths
+struct PathNode
+{
+    std::u8string_view key;                     // Key of the member
+    std::vector<std::size_t> columns;           // Columns holding the value
+    std::vector<PathNode> children;             // Members of the value
+};
+
+// Extractor of columns from JSON text
+class TextExtractor
+{
+    public:
+        TextExtractor(const std::u8string_view content,
+                      const std::vector<JSONColumnSpec> &specs,
+                      ColumnBuilder &builder);
+        ~TextExtractor() = default;
+
+        void Extract();
+
+    protected:
+        const char8_t *SkipWhitespace(const char8_t *p) const;
+        void ExtractValue(const PathNode &node,
+                          const char8_t *p,
+                          const char8_t *end);
+        void ExtractMembers(const PathNode &node, const char8_t *p);
+
+        const char8_t *begin;                   // Start of content
+        const char8_t *q;                       // One past end of content
+        ColumnBuilder &builder;                 // Builder of the columns
+        PathNode root;                          // Tree of column paths
+};
+
+/*
+ *  TextExtractor::TextExtractor()
+ *
+ *  Description:
+ *      Constructor for the TextExtractor, which arranges the column paths
+ *      as a tree of keys.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The well-formed JSON text from which to extract the columns.
+ *
+ *      specs [in]
+ *          The specification of each column, which must outlive this object.
+ *
+ *      builder [in]
+ *          The builder of the columns.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+TextExtractor::TextExtractor(const std::u8string_view content,
+                             const std::vector<JSONColumnSpec> &specs,
+                             ColumnBuilder &builder) :
+    begin{content.data()},
+    q{content.data() + content.size()},
+    builder{builder}
+{
+    for (std::size_t i = 0; i < specs.size(); i++)
+    {
+        PathNode *node = &root;
+
+        for (const auto &key : specs[i].path)
+        {
+            auto it = std::find_if(
+                node->children.begin(),
+                node->children.end(),
+                [&](const PathNode &child) { return child.key == key; });
+            if (it == node->children.end())
+            {
+                node->children.push_back(PathNode{key, {}, {}});
+                it = node->children.end() - 1;
+            }
+            node = &*it;
+        }
+
+        node->columns.push_back(i);
+    }
+}
+
+/*
+ *  TextExtractor::Extract()
+ *
+ *  Description:
+ *      Extract the columns from each element of the array.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the text is not an array or
+ *      a value is not of its column's type.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextExtractor::Extract()
+{
+    const char8_t *p = SkipWhitespace(begin);
+
+    if ((p >= q) || (*p != '['))
+    {
+        throw JSONException("JSON text is not an array");
+    }
+
+    p = SkipWhitespace(p + 1);
+    if (*p == ']') return;
+
+    while (true)
+    {
+        const char8_t *end = FindValueEnd(p, q);
+
+        builder.AddRow();
+        ExtractValue(root, p, end);
+
+        p = SkipWhitespace(end);
+        if (*p == ']') break;
+        p = SkipWhitespace(p + 1);
+    }
+}
+
+/*
+ *  TextExtractor::SkipWhitespace()
+ *
+ *  Description:
+ *      Move past any whitespace at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position within the content.
+ *
+ *  Returns:
+ *      The position of the first character that is not whitespace.
+ *
+ *  Comments:
+ *      None.
+ */
+const char8_t *TextExtractor::SkipWhitespace(const char8_t *p) const
+{
+    while ((p < q) &&
+           ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n')))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+/*
+ *  TextExtractor::ExtractValue()
+ *
+ *  Description:
+ *      Store the given value in the columns of the given node and extract
+ *      the members of the value that are in the tree.
+ *
+ *  Parameters:
+ *      node [in]
+ *          The node for the value.
+ *
+ *      p [in]
+ *          The start of the value's text.
+ *
+ *      end [in]
+ *          One past the end of the value's text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if a value is not of its
+ *      column's type.
+ *
+ *  Comments:
+ *      If names within an object are not unique, the first member having
+ *      the name and a value other than null is stored.
+ */
+void TextExtractor::ExtractValue(const PathNode &node,
+                                 const char8_t *p,
+                                 const char8_t *end)
+{
+    for (std::size_t column : node.columns)
+    {
+        if (!builder.Filled(column)) builder.StoreText(column, p, end);
+    }
+
+    if (!node.children.empty() && (*p == '{')) ExtractMembers(node, p);
+}
+
+/*
+ *  TextExtractor::ExtractMembers()
+ *
+ *  Description:
+ *      Extract the members of the object at the given position that are
+ *      children of the given node.
+ *
+ *  Parameters:
+ *      node [in]
+ *          The node for the object.
+ *
+ *      p [in]
+ *          The position of the object's opening brace.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if a value is not of its
+ *      column's type.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextExtractor::ExtractMembers(const PathNode &node, const char8_t *p)
+{
+    p = SkipWhitespace(p + 1);
+    if (*p == '}') return;
+
+    while (true)
+    {
+        const char8_t *name_end = FindValueEnd(p, q);
+        std::u8string_view name(p + 1, name_end - p - 2);
+
+        // Move past the colon to the value
+        p = SkipWhitespace(SkipWhitespace(name_end) + 1);
+        const char8_t *end = FindValueEnd(p, q);
+
+        for (const auto &child : node.children)
+        {
+            if (StringEquals(name, child.key))
+            {
+                ExtractValue(child, p, end);
+                break;
+            }
+        }
+
+        p = SkipWhitespace(end);
+        if (*p == '}') break;
+        p = SkipWhitespace(p + 1);
+    }
+}
+
+} // namespace
+
+/*
+ *  ExtractColumns()
+ *
+ *  Description:
+ *      Extract the given columns from an array of objects.
+ *
+ *  Parameters:
+ *      array [in]
+ *          The array from which to extract the columns.
+ *
+ *      columns [in]
+ *          The specification of each column.
+ *
+ *  Returns:
+ *      The columns, in the order specified.  A JSONException is thrown if a
+ *      value is not of its column's type.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<JSONColumn> ExtractColumns(
+                                const JSONArray &array,
+                                const std::vector<JSONColumnSpec> &columns)
+{
+    ColumnBuilder builder(columns, array.Size());
+
+    for (const auto &element : *array)
+    {
+        builder.AddRow();
+
+        for (std::size_t i = 0; i < columns.size(); i++)
+        {
+            const JSON *value = &element;
+
+            for (const auto &key : columns[i].path)
+            {
+                if (value->GetValueType() != JSONValueType::Object)
+                {
+                    value = nullptr;
+                    break;
+                }
+                value = value->GetValue<JSONObject>().Find(key);
+                if (value == nullptr) break;
+            }
+
+            if (value != nullptr) builder.Store(i, *value);
+        }
+    }
+
+    return builder.Finish();
+}
+
+/*
+ *  ExtractColumns()
+ *
+ *  Description:
+ *      Extract the given columns from JSON text holding an array of objects.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text from which to extract the columns.
+ *
+ *      columns [in]
+ *          The specification of each column.
+ *
+ *      max_depth [in]
+ *          The maximum depth to which objects and arrays may be nested, or
+ *          ParserOptions::No_Limit if there is no limit.
+ *
+ *  Returns:
+ *      The columns, in the order specified.  A JSONException is thrown if
+ *      the text is not a well-formed array, is nested too deeply, or a value
+ *      is not of its column's type.
+ *
+ *  Comments:
+ *      The text is verified to be well-formed, but is not parsed.
+ */
+std::vector<JSONColumn> ExtractColumns(
+                                const std::u8string_view content,
+                                const std::vector<JSONColumnSpec> &columns,
+                                std::size_t max_depth)
+{
+    ValidationResult result = Validate(content, max_depth);
+
+    if (!result)
+    {
+        throw JSONException(std::string("JSON text is invalid: ") +
+                            result.error + " at offset " +
+                            std::to_string(result.offset));
+    }
+
+    ColumnBuilder builder(columns, 0);
+    TextExtractor(content, columns, builder).Extract();
+
+    return builder.Finish();
+}
+
+/*
+ *  ExtractColumns()
+ *
+ *  Description:
+ *      Extract the given columns from JSON text holding an array of objects.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text from which to extract the columns.
+ *
+ *      columns [in]
+ *          The specification of each column.
+ *
+ *      max_depth [in]
+ *          The maximum depth to which objects and arrays may be nested, or
+ *          ParserOptions::No_Limit if there is no limit.
+ *
+ *  Returns:
+ *      The columns, in the order specified.  A JSONException is thrown if
+ *      the text is not a well-formed array, is nested too deeply, or a value
+ *      is not of its column's type.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<JSONColumn> ExtractColumns(
+                                const std::string_view content,
+                                const std::vector<JSONColumnSpec> &columns,
+                                std::size_t max_depth)
+{
+    return ExtractColumns(
+        std::u8string_view(reinterpret_cast<const char8_t *>(content.data()),
+                           content.size()),
+        columns,
+        max_depth);
+}
+
+} // namespace Terra::JSON
@@ -0,0 +1,145 @@
+/*
+ *  json_compact.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the Compact() function, which rebuilds a JSON
+ *      document such that its storage is allocated in depth-first order.
+ *      After a document has been built and modified over time, the nodes
+ *      of its maps and vectors become scattered across the heap, causing
+ *      traversals to frequently miss the cache.  Rebuilding the document
+ *      places each container's storage near that of its first child and
+ *      sizes every vector and string exactly.
+ *
+ *      When the library is built with the NodePool, the rebuilt document is
+ *      placed in a NodePool::SequentialRegion, so the storage for arrays and
+ *      objects is contiguous and in depth-first order.  Otherwise, the
+ *      placement of storage is left to the system allocator, which will
+ *      generally place successive allocations near one another.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+/*
+ *  CopyDepthFirst()
+ *
+ *  Description:
+ *      Copy the source JSON object into the target, allocating storage for
+ *      each container before that of its children.
+ *
+ *  Parameters:
+ *      target [out]
+ *          The JSON object into which the source is copied.
+ *
+ *      source [in]
+ *          The JSON object to copy.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void CopyDepthFirst(JSON &target, const JSON &source)
+{
+    switch (source.GetValueType())
+    {
+        case JSONValueType::String:
+            *target = JSONString(*source.GetValue<JSONString>());
+            break;
+
+        case JSONValueType::Number:
+            *target = source.GetValue<JSONNumber>();
+            break;
+
+        case JSONValueType::Object:
+        {
+            *target = JSONObject();
+            JSONObject &object = target.GetValue<JSONObject>();
+
+            // Members are visited in order, so each is inserted at the end
+            for (const auto &[key, value] : *source.GetValue<JSONObject>())
+            {
+                auto member = object.value.emplace_hint(object.value.end(),
+                                                        key,
+                                                        JSONValueType::Literal);
+                CopyDepthFirst(member->second, value);
+            }
+            break;
+        }
+
+        case JSONValueType::Array:
+        {
+            const JSONArray &source_array = source.GetValue<JSONArray>();
+
+            *target = JSONArray();
+            JSONArray &array = target.GetValue<JSONArray>();
+            array.value.reserve(source_array.Size());
+
+            for (const auto &element : *source_array)
+            {
+                array.value.emplace_back(JSONValueType::Literal);
+                CopyDepthFirst(array.value.back(), element);
+            }
+            break;
+        }
+
+        case JSONValueType::Literal:
+            *target = source.GetValue<JSONLiteral>();
+            break;
+
+        default:
+            throw JSONException("Unknown JSON object type");
+    }
+}
+
+} // namespace
+
+/*
+ *  Compact()
+ *
+ *  Description:
+ *      Rebuild the given JSON object such that its storage is allocated in
+ *      depth-first order and every vector and string is sized exactly.
+ *
+ *  Parameters:
+ *      json [in/out]
+ *          The JSON object to compact.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Any references or iterators into the JSON object are invalidated.
+ *      Both the original and the rebuilt documents exist in memory until the
+ *      rebuild is complete.
+ */
+void Compact(JSON &json)
+{
+#ifdef TERRA_JSON_NODE_POOL
+    NodePool::SequentialRegion region;
+#endif
+    JSON compacted(JSONValueType::Literal);
+
+    CopyDepthFirst(compacted, json);
+
+    // Exchange the values, after which the original storage is freed
+    (*json).swap(*compacted);
+}
+
+} // namespace Terra::JSON
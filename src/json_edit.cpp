@@ -0,0 +1,622 @@
+/*
+ *  json_edit.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements functions that edit JSON text in place.  A value
+ *      is identified by a JSON Pointer (RFC 6901) and located by moving over
+ *      the text without parsing it: objects and arrays that precede the
+ *      value are examined only to find their end.  The value's text is then
+ *      replaced, which moves the text following the value only once.
+ *
+ *      Only the text along the path to the value is examined, so the text is
+ *      not verified to be well-formed.  Replacement text is verified to be
+ *      well-formed JSON, and values are serialized with proper escaping.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <limits>
+#include <string>
+#include <terra/json/json.h>
+#include "json_scan.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Locator of values within JSON text
+class ValueLocator
+{
+    public:
+        ValueLocator(const std::u8string_view content) :
+            begin{content.data()},
+            q{content.data() + content.size()}
+        {
+        }
+        ~ValueLocator() = default;
+
+        JSONTextSpan Find(const std::u8string_view pointer) const;
+
+    protected:
+        const char8_t *SkipWhitespace(const char8_t *p) const;
+        const char8_t *FindMember(const char8_t *p,
+                                  const std::u8string_view name) const;
+        const char8_t *FindElement(const char8_t *p,
+                                   const std::u8string_view token) const;
+        const char8_t *SkipValue(const char8_t *p) const;
+        [[noreturn]] void Fail(const char *text, const char8_t *p) const;
+
+        const char8_t *begin;                   // Start of content
+        const char8_t *q;                       // One past end of content
+};
+
+/*
+ *  ValueLocator::Find()
+ *
+ *  Description:
+ *      Locate the value identified by the given JSON Pointer.
+ *
+ *  Parameters:
+ *      pointer [in]
+ *          The JSON Pointer identifying the value.
+ *
+ *  Returns:
+ *      The location of the value's text.  A JSONException is thrown if the
+ *      pointer is malformed, if there is no such value, or if malformed text
+ *      is encountered.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONTextSpan ValueLocator::Find(const std::u8string_view pointer) const
+{
+    const char8_t *p = SkipWhitespace(begin);
+
+    if (!pointer.empty() && (pointer.front() != '/'))
+    {
+        throw JSONException("JSON Pointer must be empty or start with '/'");
+    }
+
+    // Locate the value identified by each reference token in turn
+    for (std::size_t position = 0; position < pointer.size();)
+    {
+        std::size_t next = pointer.find(u8'/', position + 1);
+        if (next == std::u8string_view::npos) next = pointer.size();
+
+        // Decode the reference token, replacing "~1" and "~0"
+        std::u8string token;
+        for (std::size_t i = position + 1; i < next; i++)
+        {
+            if (pointer[i] != '~')
+            {
+                token.push_back(pointer[i]);
+                continue;
+            }
+            if ((i + 1 < next) && (pointer[i + 1] == '0'))
+            {
+                token.push_back('~');
+            }
+            else if ((i + 1 < next) && (pointer[i + 1] == '1'))
+            {
+                token.push_back('/');
+            }
+            else
+            {
+                throw JSONException("Invalid escape sequence in JSON Pointer");
+            }
+            i++;
+        }
+
+        if ((p < q) && (*p == '{'))
+        {
+            p = FindMember(p, token);
+        }
+        else if ((p < q) && (*p == '['))
+        {
+            p = FindElement(p, token);
+        }
+        else
+        {
+            throw JSONException("JSON Pointer does not identify a value");
+        }
+
+        position = next;
+    }
+
+    const char8_t *end = SkipValue(p);
+
+    return {static_cast<std::size_t>(p - begin),
+            static_cast<std::size_t>(end - p)};
+}
+
+/*
+ *  ValueLocator::SkipWhitespace()
+ *
+ *  Description:
+ *      Move past any whitespace at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position within the content.
+ *
+ *  Returns:
+ *      The position of the first character that is not whitespace.
+ *
+ *  Comments:
+ *      None.
+ */
+const char8_t *ValueLocator::SkipWhitespace(const char8_t *p) const
+{
+    while ((p < q) &&
+           ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n')))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+/*
+ *  ValueLocator::FindMember()
+ *
+ *  Description:
+ *      Locate the value of the named member of the object at the given
+ *      position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the object's opening brace.
+ *
+ *      name [in]
+ *          The name of the member.
+ *
+ *  Returns:
+ *      The position of the member's value.  A JSONException is thrown if
+ *      there is no such member.
+ *
+ *  Comments:
+ *      If names are not unique, the first member having the name is found.
+ */
+const char8_t *ValueLocator::FindMember(const char8_t *p,
+                                        const std::u8string_view name) const
+{
+    p = SkipWhitespace(p + 1);
+    if ((p < q) && (*p == '}'))
+    {
+        throw JSONException("JSON Pointer does not identify a value");
+    }
+
+    while (true)
+    {
+        if ((p >= q) || (*p != '"')) Fail("Expected a member name", p);
+        const char8_t *name_end = SkipValue(p);
+        std::u8string_view member_name(p + 1, name_end - p - 2);
+
+        p = SkipWhitespace(name_end);
+        if ((p >= q) || (*p != ':')) Fail("Expected ':'", p);
+        p = SkipWhitespace(p + 1);
+
+        if (StringEquals(member_name, name)) return p;
+
+        p = SkipWhitespace(SkipValue(p));
+        if ((p < q) && (*p == ','))
+        {
+            p = SkipWhitespace(p + 1);
+            continue;
+        }
+        if ((p < q) && (*p == '}'))
+        {
+            throw JSONException("JSON Pointer does not identify a value");
+        }
+        Fail("Expected ',' or '}'", p);
+    }
+}
+
+/*
+ *  ValueLocator::FindElement()
+ *
+ *  Description:
+ *      Locate the element of the array at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the array's opening bracket.
+ *
+ *      token [in]
+ *          The reference token holding the index of the element.
+ *
+ *  Returns:
+ *      The position of the element.  A JSONException is thrown if the token
+ *      is not an index or there is no such element.
+ *
+ *  Comments:
+ *      The token "-", which refers to the element following the last, does
+ *      not identify an existing value.
+ */
+const char8_t *ValueLocator::FindElement(const char8_t *p,
+                                         const std::u8string_view token) const
+{
+    std::size_t index = 0;
+
+    // The index must be digits without leading zeros
+    if (token.empty() || ((token.size() > 1) && (token.front() == '0')) ||
+        (token.size() > std::numeric_limits<std::size_t>::digits10))
+    {
+        throw JSONException("JSON Pointer does not identify a value");
+    }
+    for (char8_t c : token)
+    {
+        if ((c < '0') || (c > '9'))
+        {
+            throw JSONException("JSON Pointer does not identify a value");
+        }
+        index = (index * 10) + (c - '0');
+    }
+
+    p = SkipWhitespace(p + 1);
+    if ((p < q) && (*p == ']'))
+    {
+        throw JSONException("JSON Pointer does not identify a value");
+    }
+
+    for (std::size_t i = 0;; i++)
+    {
+        if (i == index) return p;
+
+        p = SkipWhitespace(SkipValue(p));
+        if ((p < q) && (*p == ','))
+        {
+            p = SkipWhitespace(p + 1);
+            continue;
+        }
+        if ((p < q) && (*p == ']'))
+        {
+            throw JSONException("JSON Pointer does not identify a value");
+        }
+        Fail("Expected ',' or ']'", p);
+    }
+}
+
+/*
+ *  ValueLocator::SkipValue()
+ *
+ *  Description:
+ *      Move past the value that starts at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the value.
+ *
+ *  Returns:
+ *      The position one past the end of the value.  A JSONException is
+ *      thrown if the value does not end.
+ *
+ *  Comments:
+ *      None.
+ */
+const char8_t *ValueLocator::SkipValue(const char8_t *p) const
+{
+    const char8_t *end = FindValueEnd(p, q);
+
+    if (end == nullptr) Fail("Expected a value", p);
+
+    return end;
+}
+
+/*
+ *  ValueLocator::Fail()
+ *
+ *  Description:
+ *      Report malformed text found while locating a value.
+ *
+ *  Parameters:
+ *      text [in]
+ *          A description of the error.
+ *
+ *      p [in]
+ *          The position at which the error was found.
+ *
+ *  Returns:
+ *      Does not return, as a JSONException is thrown.
+ *
+ *  Comments:
+ *      None.
+ */
+void ValueLocator::Fail(const char *text, const char8_t *p) const
+{
+    throw JSONException(std::string(text) + " at offset " +
+                        std::to_string(p - begin));
+}
+
+/*
+ *  AsUTF8()
+ *
+ *  Description:
+ *      View the given text as UTF-8 text.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to view.
+ *
+ *  Returns:
+ *      The same text as a std::u8string_view.
+ *
+ *  Comments:
+ *      None.
+ */
+std::u8string_view AsUTF8(const std::string_view text)
+{
+    return {reinterpret_cast<const char8_t *>(text.data()), text.size()};
+}
+
+/*
+ *  ReplaceText()
+ *
+ *  Description:
+ *      Replace the text of the value identified by the given JSON Pointer.
+ *
+ *  Parameters:
+ *      content [in/out]
+ *          The JSON text to edit.
+ *
+ *      pointer [in]
+ *          The JSON Pointer identifying the value to replace.
+ *
+ *      text [in]
+ *          The well-formed JSON text of the new value.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if there is no such value.
+ *
+ *  Comments:
+ *      The content is modified only if the value is found.
+ */
+template<typename T>
+void ReplaceText(std::basic_string<T> &content,
+                 const std::u8string_view pointer,
+                 const std::string_view text)
+{
+    JSONTextSpan span = FindValue(
+        std::u8string_view(reinterpret_cast<const char8_t *>(content.data()),
+                           content.size()),
+        pointer);
+
+    content.replace(span.offset,
+                    span.length,
+                    reinterpret_cast<const T *>(text.data()),
+                    text.size());
+}
+
+/*
+ *  VerifiedText()
+ *
+ *  Description:
+ *      Verify that the given text is well-formed JSON.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The JSON text to verify.
+ *
+ *  Returns:
+ *      The text, without leading or trailing whitespace.  A JSONException is
+ *      thrown if the text is not well-formed.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string_view VerifiedText(std::string_view text)
+{
+    ValidationResult result = Validate(text);
+
+    if (!result)
+    {
+        throw JSONException(std::string("Replacement text is invalid: ") +
+                            result.error + " at offset " +
+                            std::to_string(result.offset));
+    }
+
+    std::size_t first = text.find_first_not_of(" \t\r\n");
+    std::size_t last = text.find_last_not_of(" \t\r\n");
+
+    return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+/*
+ *  FindValue()
+ *
+ *  Description:
+ *      Locate the value identified by the given JSON Pointer (RFC 6901)
+ *      within JSON text.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text to search.
+ *
+ *      pointer [in]
+ *          The JSON Pointer identifying the value (e.g., "/items/0/name").
+ *
+ *  Returns:
+ *      The location of the value's text.  A JSONException is thrown if the
+ *      pointer is malformed, if there is no such value, or if malformed text
+ *      is encountered along the path to the value.
+ *
+ *  Comments:
+ *      The text is not parsed.  Objects and arrays that precede the value
+ *      are examined only to find their end.
+ */
+JSONTextSpan FindValue(const std::u8string_view content,
+                       const std::u8string_view pointer)
+{
+    return ValueLocator(content).Find(pointer);
+}
+
+/*
+ *  FindValue()
+ *
+ *  Description:
+ *      Locate the value identified by the given JSON Pointer (RFC 6901)
+ *      within JSON text.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text to search.
+ *
+ *      pointer [in]
+ *          The JSON Pointer identifying the value (e.g., "/items/0/name").
+ *
+ *  Returns:
+ *      The location of the value's text.  A JSONException is thrown if the
+ *      pointer is malformed, if there is no such value, or if malformed text
+ *      is encountered along the path to the value.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONTextSpan FindValue(const std::string_view content,
+                       const std::string_view pointer)
+{
+    return FindValue(AsUTF8(content), AsUTF8(pointer));
+}
+
+/*
+ *  ReplaceValue()
+ *
+ *  Description:
+ *      Replace the value identified by the given JSON Pointer within JSON
+ *      text with the given value.
+ *
+ *  Parameters:
+ *      content [in/out]
+ *          The JSON text to edit.
+ *
+ *      pointer [in]
+ *          The JSON Pointer identifying the value to replace.
+ *
+ *      value [in]
+ *          The new value, which is serialized into the text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if there is no such value, in
+ *      which case the content is not modified.
+ *
+ *  Comments:
+ *      None.
+ */
+void ReplaceValue(std::u8string &content,
+                  const std::u8string_view pointer,
+                  const JSON &value)
+{
+    ReplaceText(content, pointer, value.ToString());
+}
+
+/*
+ *  ReplaceValue()
+ *
+ *  Description:
+ *      Replace the value identified by the given JSON Pointer within JSON
+ *      text with the given value.
+ *
+ *  Parameters:
+ *      content [in/out]
+ *          The JSON text to edit.
+ *
+ *      pointer [in]
+ *          The JSON Pointer identifying the value to replace.
+ *
+ *      value [in]
+ *          The new value, which is serialized into the text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if there is no such value, in
+ *      which case the content is not modified.
+ *
+ *  Comments:
+ *      None.
+ */
+void ReplaceValue(std::string &content,
+                  const std::string_view pointer,
+                  const JSON &value)
+{
+    ReplaceText(content, AsUTF8(pointer), value.ToString());
+}
+
+/*
+ *  ReplaceValueText()
+ *
+ *  Description:
+ *      Replace the value identified by the given JSON Pointer within JSON
+ *      text with the given JSON text.
+ *
+ *  Parameters:
+ *      content [in/out]
+ *          The JSON text to edit.
+ *
+ *      pointer [in]
+ *          The JSON Pointer identifying the value to replace.
+ *
+ *      text [in]
+ *          The JSON text of the new value, which must be well-formed.
+ *          Leading and trailing whitespace is not inserted.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the text is not well-formed or
+ *      there is no such value, in which case the content is not modified.
+ *
+ *  Comments:
+ *      None.
+ */
+void ReplaceValueText(std::u8string &content,
+                      const std::u8string_view pointer,
+                      const std::u8string_view text)
+{
+    ReplaceText(content,
+                pointer,
+                VerifiedText({reinterpret_cast<const char *>(text.data()),
+                              text.size()}));
+}
+
+/*
+ *  ReplaceValueText()
+ *
+ *  Description:
+ *      Replace the value identified by the given JSON Pointer within JSON
+ *      text with the given JSON text.
+ *
+ *  Parameters:
+ *      content [in/out]
+ *          The JSON text to edit.
+ *
+ *      pointer [in]
+ *          The JSON Pointer identifying the value to replace.
+ *
+ *      text [in]
+ *          The JSON text of the new value, which must be well-formed.
+ *          Leading and trailing whitespace is not inserted.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the text is not well-formed or
+ *      there is no such value, in which case the content is not modified.
+ *
+ *  Comments:
+ *      None.
+ */
+void ReplaceValueText(std::string &content,
+                      const std::string_view pointer,
+                      const std::string_view text)
+{
+    ReplaceText(content, AsUTF8(pointer), VerifiedText(text));
+}
+
+} // namespace Terra::JSON
@@ -0,0 +1,56 @@
+/*
+ *  json_escape.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines functions that produce the JSON text for strings,
+ *      which are used to serialize both string values and the names of
+ *      object members without first copying them into a JSONString.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Append or write the quoted and escaped JSON text for the given string; a
+// JSONException is thrown if the string is not valid UTF-8
+void AppendEscaped(std::string &output, const std::u8string_view string);
+void WriteEscaped(std::ostream &o, const std::u8string_view string);
+void WriteEscaped(JSONTextSink &sink, const std::u8string_view string);
+
+// As above, for the value of a JSONString
+void AppendEscaped(std::string &output, const JSONString &string);
+void WriteEscaped(std::ostream &o, const JSONString &string);
+void WriteEscaped(JSONTextSink &sink, const JSONString &string);
+
+// Select the std::u8string_view form for std::u8string, which would otherwise
+// be ambiguous, as std::u8string converts implicitly to a JSONString
+inline void AppendEscaped(std::string &output, const std::u8string &string)
+{
+    AppendEscaped(output, std::u8string_view(string));
+}
+inline void WriteEscaped(std::ostream &o, const std::u8string &string)
+{
+    WriteEscaped(o, std::u8string_view(string));
+}
+inline void WriteEscaped(JSONTextSink &sink, const std::u8string &string)
+{
+    WriteEscaped(sink, std::u8string_view(string));
+}
+
+} // namespace Terra::JSON
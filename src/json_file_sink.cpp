@@ -0,0 +1,675 @@
+/*
+ *  json_file_sink.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the JSONFileSink object.
+ *
+ *      The text is written into the current block, which is the put area of
+ *      the std::streambuf.  When the block is full, it is handed to the
+ *      writer thread and the other block becomes current.  If the writer
+ *      thread is still writing the other block, the producer waits for it,
+ *      so at most two blocks are held in memory.
+ *
+ *  Portability Issues:
+ *      On POSIX systems, blocks are written using pwrite() and the file is
+ *      committed to storage using fsync().  Elsewhere, a std::ofstream is
+ *      used, and the file is only flushed when closed.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <thread>
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#define TERRA_JSON_PWRITE
+#else
+#include <fstream>
+#endif
+#include <terra/json/json_file_sink.h>
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Deleter for the aligned blocks
+struct BlockDelete
+{
+    void operator()(char *block) const
+    {
+        ::operator delete[](block,
+                            std::align_val_t{JSONFileSink::Block_Alignment});
+    }
+};
+
+// Block of text aligned to JSONFileSink::Block_Alignment
+using Block = std::unique_ptr<char[], BlockDelete>;
+
+// File to which the blocks are written
+class OutputFile
+{
+    public:
+        OutputFile(const std::filesystem::path &path);
+        OutputFile(const OutputFile &) = delete;
+        ~OutputFile();
+
+        OutputFile &operator=(const OutputFile &) = delete;
+
+        void Write(const char *data, std::size_t length, std::uint64_t offset);
+        void Close();
+
+    protected:
+        std::string name;                       // Name of the file
+#ifdef TERRA_JSON_PWRITE
+        int fd;                                 // File descriptor
+#else
+        std::ofstream file;                     // File stream
+#endif
+};
+
+/*
+ *  OutputFile::OutputFile()
+ *
+ *  Description:
+ *      Constructor for the OutputFile object, which creates the file or
+ *      truncates it if it exists.
+ *
+ *  Parameters:
+ *      path [in]
+ *          The path of the file to write.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the file cannot be opened.
+ *
+ *  Comments:
+ *      None.
+ */
+OutputFile::OutputFile(const std::filesystem::path &path) :
+    name{path.string()}
+{
+#ifdef TERRA_JSON_PWRITE
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) throw JSONException("Unable to open file " + name);
+#else
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw JSONException("Unable to open file " + name);
+#endif
+}
+
+/*
+ *  OutputFile::~OutputFile()
+ *
+ *  Description:
+ *      Destructor for the OutputFile object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The file is closed if Close() was not called, ignoring any error.
+ */
+OutputFile::~OutputFile()
+{
+#ifdef TERRA_JSON_PWRITE
+    if (fd >= 0) close(fd);
+#endif
+}
+
+/*
+ *  OutputFile::Write()
+ *
+ *  Description:
+ *      Write the given data to the file at the given offset.
+ *
+ *  Parameters:
+ *      data [in]
+ *          The data to write.
+ *
+ *      length [in]
+ *          The number of octets to write.
+ *
+ *      offset [in]
+ *          The offset within the file at which to write the data.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the data cannot be written.
+ *
+ *  Comments:
+ *      Blocks are written in order, so the offset is used only where the
+ *      file is written using pwrite().
+ */
+void OutputFile::Write(const char *data,
+                       std::size_t length,
+                       [[maybe_unused]] std::uint64_t offset)
+{
+#ifdef TERRA_JSON_PWRITE
+    while (length > 0)
+    {
+        ssize_t written =
+            pwrite(fd, data, length, static_cast<off_t>(offset));
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            throw JSONException("Unable to write file " + name);
+        }
+        data += written;
+        length -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+#else
+    if (!file.write(data, static_cast<std::streamsize>(length)))
+    {
+        throw JSONException("Unable to write file " + name);
+    }
+#endif
+}
+
+/*
+ *  OutputFile::Close()
+ *
+ *  Description:
+ *      Commit the content of the file to storage and close the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the file cannot be committed
+ *      to storage or closed, though the file is closed in either case.
+ *
+ *  Comments:
+ *      None.
+ */
+void OutputFile::Close()
+{
+#ifdef TERRA_JSON_PWRITE
+    int descriptor = fd;
+    fd = -1;
+
+    if (fsync(descriptor) != 0)
+    {
+        close(descriptor);
+        throw JSONException("Unable to commit file " + name);
+    }
+    if (close(descriptor) != 0)
+    {
+        throw JSONException("Unable to close file " + name);
+    }
+#else
+    file.close();
+    if (!file) throw JSONException("Unable to close file " + name);
+#endif
+}
+
+} // namespace
+
+// Writer thread and the state shared with it
+struct JSONFileSink::Writer
+{
+    Writer(const std::filesystem::path &path, std::size_t block_size);
+    ~Writer();
+
+    void Run();
+    void Stop();
+
+    OutputFile file;                            // File being written
+    Block blocks[2];                            // Blocks of text
+    std::size_t current;                        // Block being filled
+    std::uint64_t submitted;                    // Octets given to the thread
+    std::mutex mutex;                           // Protects the members below
+    std::condition_variable condition;          // Signaled on state changes
+    const char *pending;                        // Block to write
+    std::size_t pending_length;                 // Octets in the pending block
+    std::uint64_t pending_offset;               // File offset of the block
+    bool busy;                                  // Pending block not written
+    bool stopping;                              // Thread should exit
+    std::exception_ptr error;                   // Error writing the file
+    std::thread thread;                         // Writer thread
+};
+
+/*
+ *  JSONFileSink::Writer::Writer()
+ *
+ *  Description:
+ *      Constructor for the Writer object, which opens the file, allocates
+ *      the blocks, and starts the writer thread.
+ *
+ *  Parameters:
+ *      path [in]
+ *          The path of the file to write.
+ *
+ *      block_size [in]
+ *          The number of octets in each block.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the file cannot be opened.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONFileSink::Writer::Writer(const std::filesystem::path &path,
+                             std::size_t block_size) :
+    file{path},
+    current{0},
+    submitted{0},
+    pending{nullptr},
+    pending_length{0},
+    pending_offset{0},
+    busy{false},
+    stopping{false}
+{
+    for (auto &block : blocks)
+    {
+        block.reset(static_cast<char *>(::operator new[](
+            block_size,
+            std::align_val_t{Block_Alignment})));
+    }
+
+    thread = std::thread([this]() { Run(); });
+}
+
+/*
+ *  JSONFileSink::Writer::~Writer()
+ *
+ *  Description:
+ *      Destructor for the Writer object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The writer thread is stopped if Stop() was not called.
+ */
+JSONFileSink::Writer::~Writer()
+{
+    if (thread.joinable()) Stop();
+}
+
+/*
+ *  JSONFileSink::Writer::Run()
+ *
+ *  Description:
+ *      Write each block handed to the writer thread until stopped.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Once an error occurs, subsequent blocks are discarded; the error is
+ *      reported to the producer when it next hands over a block or closes
+ *      the sink.
+ */
+void JSONFileSink::Writer::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        condition.wait(lock, [&]() { return busy || stopping; });
+        if (!busy) return;
+
+        // Write the block without holding the lock
+        lock.unlock();
+        std::exception_ptr failure;
+        try
+        {
+            if (!error) file.Write(pending, pending_length, pending_offset);
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+        lock.lock();
+
+        if (failure) error = failure;
+        busy = false;
+        condition.notify_all();
+    }
+}
+
+/*
+ *  JSONFileSink::Writer::Stop()
+ *
+ *  Description:
+ *      Stop the writer thread once it has written the pending block.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void JSONFileSink::Writer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        condition.notify_all();
+    }
+
+    thread.join();
+}
+
+/*
+ *  JSONFileSink::JSONFileSink()
+ *
+ *  Description:
+ *      Constructor for the JSONFileSink object, which creates the file or
+ *      truncates it if it exists.
+ *
+ *  Parameters:
+ *      path [in]
+ *          The path of the file to write.
+ *
+ *      block_size [in]
+ *          The number of octets written to the file at once, which is
+ *          rounded up to a multiple of Block_Alignment.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the file cannot be opened.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONFileSink::JSONFileSink(const std::filesystem::path &path,
+                           std::size_t block_size) :
+    block_size{std::max(Block_Alignment,
+                        ((block_size + Block_Alignment - 1) /
+                         Block_Alignment) * Block_Alignment)},
+    writer{std::make_unique<Writer>(path, this->block_size)},
+    stream{this},
+    closed{false}
+{
+    char *block = writer->blocks[writer->current].get();
+    setp(block, block + this->block_size);
+}
+
+/*
+ *  JSONFileSink::~JSONFileSink()
+ *
+ *  Description:
+ *      Destructor for the JSONFileSink object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      If Close() was not called, the remaining text is written and the
+ *      file is closed, but any error is ignored.
+ */
+JSONFileSink::~JSONFileSink()
+{
+    try
+    {
+        Close();
+    }
+    catch (...)
+    {
+    }
+}
+
+/*
+ *  JSONFileSink::Write()
+ *
+ *  Description:
+ *      Write the given text to the file.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to write.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if an earlier block could not be
+ *      written or if the sink is closed.
+ *
+ *  Comments:
+ *      The text is copied into the current block and is written to the
+ *      file when the block is full or the sink is closed.
+ */
+void JSONFileSink::Write(const std::string_view text)
+{
+    xsputn(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+/*
+ *  JSONFileSink::Close()
+ *
+ *  Description:
+ *      Write the remaining text, commit the content of the file to storage,
+ *      and close the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if any of the text could not be
+ *      written or the file could not be committed to storage.
+ *
+ *  Comments:
+ *      Calling this function again has no effect.
+ */
+void JSONFileSink::Close()
+{
+    std::exception_ptr failure;
+
+    if (closed) return;
+
+    try
+    {
+        Submit();
+    }
+    catch (...)
+    {
+        failure = std::current_exception();
+    }
+
+    closed = true;
+    setp(nullptr, nullptr);
+    writer->Stop();
+
+    if (!failure) failure = writer->error;
+
+    try
+    {
+        writer->file.Close();
+    }
+    catch (...)
+    {
+        if (!failure) failure = std::current_exception();
+    }
+
+    if (failure) std::rethrow_exception(failure);
+}
+
+/*
+ *  JSONFileSink::Size()
+ *
+ *  Description:
+ *      Return the number of octets written to this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of octets written, including those not yet written to
+ *      the file.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint64_t JSONFileSink::Size() const
+{
+    return writer->submitted + static_cast<std::uint64_t>(pptr() - pbase());
+}
+
+/*
+ *  JSONFileSink::overflow()
+ *
+ *  Description:
+ *      Hand the full block to the writer thread and place the given
+ *      character in the next block.
+ *
+ *  Parameters:
+ *      c [in]
+ *          The character to write, or EOF if none.
+ *
+ *  Returns:
+ *      The character written, or a value other than EOF if none.  A
+ *      JSONException is thrown if an earlier block could not be written or
+ *      if the sink is closed.
+ *
+ *  Comments:
+ *      The std::ostream reports an exception by setting its badbit.
+ */
+JSONFileSink::int_type JSONFileSink::overflow(int_type c)
+{
+    Submit();
+
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        return traits_type::not_eof(c);
+    }
+
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+
+    return c;
+}
+
+/*
+ *  JSONFileSink::xsputn()
+ *
+ *  Description:
+ *      Write the given text into the blocks, handing each full block to the
+ *      writer thread.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to write.
+ *
+ *      length [in]
+ *          The length of the text.
+ *
+ *  Returns:
+ *      The number of characters written.  A JSONException is thrown if an
+ *      earlier block could not be written or if the sink is closed.
+ *
+ *  Comments:
+ *      None.
+ */
+std::streamsize JSONFileSink::xsputn(const char *text, std::streamsize length)
+{
+    std::size_t remaining = static_cast<std::size_t>(length);
+
+    while (remaining > 0)
+    {
+        if (pptr() == epptr()) Submit();
+
+        std::size_t count =
+            std::min({remaining,
+                      static_cast<std::size_t>(epptr() - pptr()),
+                      static_cast<std::size_t>(INT_MAX)});
+        std::memcpy(pptr(), text, count);
+        pbump(static_cast<int>(count));
+        text += count;
+        remaining -= count;
+    }
+
+    return length;
+}
+
+/*
+ *  JSONFileSink::sync()
+ *
+ *  Description:
+ *      Called when the stream is flushed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Zero.
+ *
+ *  Comments:
+ *      A partial block is not written when the stream is flushed, as doing
+ *      so would defeat writing the file in large blocks.  The text is
+ *      written when the block is full or the sink is closed.
+ */
+int JSONFileSink::sync()
+{
+    return 0;
+}
+
+/*
+ *  JSONFileSink::Submit()
+ *
+ *  Description:
+ *      Hand the current block to the writer thread and make the other block
+ *      current, waiting for the writer thread to finish writing it.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if an earlier block could not be
+ *      written or if the sink is closed.
+ *
+ *  Comments:
+ *      None.
+ */
+void JSONFileSink::Submit()
+{
+    if (closed) throw JSONException("The file sink is closed");
+
+    std::size_t length = static_cast<std::size_t>(pptr() - pbase());
+    if (length == 0) return;
+
+    {
+        std::unique_lock<std::mutex> lock(writer->mutex);
+        writer->condition.wait(lock, [&]() { return !writer->busy; });
+        if (writer->error) std::rethrow_exception(writer->error);
+
+        writer->pending = pbase();
+        writer->pending_length = length;
+        writer->pending_offset = writer->submitted;
+        writer->busy = true;
+        writer->submitted += length;
+        writer->condition.notify_all();
+    }
+
+    writer->current ^= 1;
+    char *block = writer->blocks[writer->current].get();
+    setp(block, block + block_size);
+}
+
+} // namespace Terra::JSON
@@ -0,0 +1,473 @@
+/*
+ *  json_flatten.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements Flatten() and FlattenText().
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <charconv>
+#include <string>
+#include <terra/json/json_flatten.h>
+#include "json_scan.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Buffer holding the JSON Pointer of the value being visited
+class PointerBuffer
+{
+    public:
+        PointerBuffer() = default;
+        ~PointerBuffer() = default;
+
+        std::size_t Push(const std::u8string_view key);
+        std::size_t Push(std::size_t index);
+        void Pop(std::size_t length) { pointer.resize(length); }
+
+        std::u8string_view View() const { return pointer; }
+
+    protected:
+        std::u8string pointer;                  // JSON Pointer
+};
+
+/*
+ *  PointerBuffer::Push()
+ *
+ *  Description:
+ *      Append the reference token for the given key to the pointer.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member being entered.
+ *
+ *  Returns:
+ *      The length of the pointer before the token was appended, which is
+ *      given to Pop() to remove the token.
+ *
+ *  Comments:
+ *      The characters '~' and '/' are escaped as "~0" and "~1".
+ */
+std::size_t PointerBuffer::Push(const std::u8string_view key)
+{
+    std::size_t length = pointer.size();
+
+    pointer.push_back('/');
+
+    // Most keys require no escaping
+    if (key.find_first_of(u8"~/") == std::u8string_view::npos)
+    {
+        pointer.append(key);
+        return length;
+    }
+
+    for (char8_t c : key)
+    {
+        if (c == '~')
+        {
+            pointer.append(u8"~0");
+        }
+        else if (c == '/')
+        {
+            pointer.append(u8"~1");
+        }
+        else
+        {
+            pointer.push_back(c);
+        }
+    }
+
+    return length;
+}
+
+/*
+ *  PointerBuffer::Push()
+ *
+ *  Description:
+ *      Append the reference token for the given array index to the pointer.
+ *
+ *  Parameters:
+ *      index [in]
+ *          The index of the element being entered.
+ *
+ *  Returns:
+ *      The length of the pointer before the token was appended, which is
+ *      given to Pop() to remove the token.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t PointerBuffer::Push(std::size_t index)
+{
+    std::size_t length = pointer.size();
+    char digits[24];
+
+    auto result = std::to_chars(digits, digits + sizeof(digits), index);
+
+    pointer.push_back('/');
+    pointer.append(reinterpret_cast<const char8_t *>(digits),
+                   result.ptr - digits);
+
+    return length;
+}
+
+/*
+ *  FlattenValue()
+ *
+ *  Description:
+ *      Pass each scalar within the given value to the consumer.
+ *
+ *  Parameters:
+ *      json [in]
+ *          The value to flatten.
+ *
+ *      pointer [in/out]
+ *          The JSON Pointer of the value.
+ *
+ *      consumer [in]
+ *          The function to which each scalar is passed.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Empty objects and arrays are passed to the consumer.
+ */
+void FlattenValue(const JSON &json,
+                  PointerBuffer &pointer,
+                  const JSONFlattenConsumer &consumer)
+{
+    switch (json.GetValueType())
+    {
+        case JSONValueType::Object:
+        {
+            const JSONObject &object = json.GetValue<JSONObject>();
+            if (object.Size() == 0) break;
+            for (const auto &[key, value] : *object)
+            {
+                std::size_t length = pointer.Push(key);
+                FlattenValue(value, pointer, consumer);
+                pointer.Pop(length);
+            }
+            return;
+        }
+
+        case JSONValueType::Array:
+        {
+            const JSONArray &array = json.GetValue<JSONArray>();
+            if (array.Size() == 0) break;
+            for (std::size_t i = 0; i < array.Size(); i++)
+            {
+                std::size_t length = pointer.Push(i);
+                FlattenValue(array[i], pointer, consumer);
+                pointer.Pop(length);
+            }
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    consumer(pointer.View(), json);
+}
+
+// Flattener of JSON text
+class TextFlattener
+{
+    public:
+        TextFlattener(const std::u8string_view content,
+                      const JSONFlattenTextConsumer &consumer) :
+            begin{content.data()},
+            q{content.data() + content.size()},
+            consumer{consumer}
+        {
+        }
+        ~TextFlattener() = default;
+
+        void Flatten() { FlattenValue(SkipWhitespace(begin)); }
+
+    protected:
+        const char8_t *SkipWhitespace(const char8_t *p) const;
+        const char8_t *FlattenValue(const char8_t *p);
+        const char8_t *FlattenObject(const char8_t *p);
+        const char8_t *FlattenArray(const char8_t *p);
+
+        const char8_t *begin;                   // Start of content
+        const char8_t *q;                       // One past end of content
+        const JSONFlattenTextConsumer &consumer;
+                                                // Function given each scalar
+        PointerBuffer pointer;                  // Pointer of current value
+};
+
+/*
+ *  TextFlattener::SkipWhitespace()
+ *
+ *  Description:
+ *      Move past any whitespace at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position within the content.
+ *
+ *  Returns:
+ *      The position of the first character that is not whitespace.
+ *
+ *  Comments:
+ *      None.
+ */
+const char8_t *TextFlattener::SkipWhitespace(const char8_t *p) const
+{
+    while ((p < q) &&
+           ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n')))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+/*
+ *  TextFlattener::FlattenValue()
+ *
+ *  Description:
+ *      Pass each scalar within the value at the given position to the
+ *      consumer.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the value, which must be well-formed.
+ *
+ *  Returns:
+ *      The position one past the end of the value.
+ *
+ *  Comments:
+ *      None.
+ */
+const char8_t *TextFlattener::FlattenValue(const char8_t *p)
+{
+    if (*p == '{') return FlattenObject(p);
+    if (*p == '[') return FlattenArray(p);
+
+    const char8_t *end = FindValueEnd(p, q);
+    consumer(pointer.View(), std::u8string_view(p, end - p));
+
+    return end;
+}
+
+/*
+ *  TextFlattener::FlattenObject()
+ *
+ *  Description:
+ *      Pass each scalar within the object at the given position to the
+ *      consumer.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the object's opening brace.
+ *
+ *  Returns:
+ *      The position one past the end of the object.
+ *
+ *  Comments:
+ *      An empty object is passed to the consumer.  Names containing escape
+ *      sequences are decoded before being added to the pointer.
+ */
+const char8_t *TextFlattener::FlattenObject(const char8_t *p)
+{
+    const char8_t *start = p;
+
+    p = SkipWhitespace(p + 1);
+    if (*p == '}')
+    {
+        consumer(pointer.View(), std::u8string_view(start, p + 1 - start));
+        return p + 1;
+    }
+
+    while (true)
+    {
+        const char8_t *name_end = FindValueEnd(p, q);
+        std::u8string_view name(p + 1, name_end - p - 2);
+        std::size_t length;
+
+        if (name.find(u8'\\') == std::u8string_view::npos)
+        {
+            length = pointer.Push(name);
+        }
+        else
+        {
+            length = pointer.Push(DecodeString(name));
+        }
+
+        // Move past the colon to the value
+        p = SkipWhitespace(SkipWhitespace(name_end) + 1);
+        p = SkipWhitespace(FlattenValue(p));
+        pointer.Pop(length);
+
+        if (*p == '}') return p + 1;
+        p = SkipWhitespace(p + 1);
+    }
+}
+
+/*
+ *  TextFlattener::FlattenArray()
+ *
+ *  Description:
+ *      Pass each scalar within the array at the given position to the
+ *      consumer.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the array's opening bracket.
+ *
+ *  Returns:
+ *      The position one past the end of the array.
+ *
+ *  Comments:
+ *      An empty array is passed to the consumer.
+ */
+const char8_t *TextFlattener::FlattenArray(const char8_t *p)
+{
+    const char8_t *start = p;
+
+    p = SkipWhitespace(p + 1);
+    if (*p == ']')
+    {
+        consumer(pointer.View(), std::u8string_view(start, p + 1 - start));
+        return p + 1;
+    }
+
+    for (std::size_t i = 0;; i++)
+    {
+        std::size_t length = pointer.Push(i);
+        p = SkipWhitespace(FlattenValue(p));
+        pointer.Pop(length);
+
+        if (*p == ']') return p + 1;
+        p = SkipWhitespace(p + 1);
+    }
+}
+
+} // namespace
+
+/*
+ *  Flatten()
+ *
+ *  Description:
+ *      Flatten the given JSON value into pairs of a JSON Pointer and a
+ *      scalar value.
+ *
+ *  Parameters:
+ *      json [in]
+ *          The value to flatten.
+ *
+ *      consumer [in]
+ *          The function to which each pointer and scalar are passed.
+ *
+ *  Returns:
+ *      Nothing.  Exceptions thrown by the consumer are propagated.
+ *
+ *  Comments:
+ *      If the value is itself a scalar, it is passed with an empty pointer.
+ */
+void Flatten(const JSON &json, const JSONFlattenConsumer &consumer)
+{
+    PointerBuffer pointer;
+
+    FlattenValue(json, pointer, consumer);
+}
+
+/*
+ *  FlattenText()
+ *
+ *  Description:
+ *      Flatten the given JSON text into pairs of a JSON Pointer and the text
+ *      of a scalar value.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text to flatten.
+ *
+ *      consumer [in]
+ *          The function to which each pointer and scalar's text are passed.
+ *
+ *      max_depth [in]
+ *          The maximum depth to which objects and arrays may be nested, or
+ *          ParserOptions::No_Limit if there is no limit.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the text is not well-formed
+ *      or is nested too deeply, in which case the consumer is not called.
+ *      Exceptions thrown by the consumer are propagated.
+ *
+ *  Comments:
+ *      The text is verified to be well-formed, but is not parsed.  Since
+ *      the text is flattened recursively, the limit on nesting also
+ *      protects the stack.
+ */
+void FlattenText(const std::u8string_view content,
+                 const JSONFlattenTextConsumer &consumer,
+                 std::size_t max_depth)
+{
+    ValidationResult result = Validate(content, max_depth);
+
+    if (!result)
+    {
+        throw JSONException(std::string("JSON text is invalid: ") +
+                            result.error + " at offset " +
+                            std::to_string(result.offset));
+    }
+
+    TextFlattener(content, consumer).Flatten();
+}
+
+/*
+ *  FlattenText()
+ *
+ *  Description:
+ *      Flatten the given JSON text into pairs of a JSON Pointer and the text
+ *      of a scalar value.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text to flatten.
+ *
+ *      consumer [in]
+ *          The function to which each pointer and scalar's text are passed.
+ *
+ *      max_depth [in]
+ *          The maximum depth to which objects and arrays may be nested, or
+ *          ParserOptions::No_Limit if there is no limit.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the text is not well-formed
+ *      or is nested too deeply, in which case the consumer is not called.
+ *      Exceptions thrown by the consumer are propagated.
+ *
+ *  Comments:
+ *      None.
+ */
+void FlattenText(const std::string_view content,
+                 const JSONFlattenTextConsumer &consumer,
+                 std::size_t max_depth)
+{
+    FlattenText(std::u8string_view(
+                    reinterpret_cast<const char8_t *>(content.data()),
+                    content.size()),
+                consumer,
+                max_depth);
+}
+
+} // namespace Terra::JSON
@@ -492,6 +492,7 @@ void JSONFormatter::PrintString()
         {
             // Produce the escaped character
             *o << static_cast<char>(*p);
+            AdvanceReadPosition();
 
             // Done with escape
             handle_escape = false;
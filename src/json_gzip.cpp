@@ -0,0 +1,495 @@
+/*
+ *  json_gzip.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the JSONGzipSource object and the functions that
+ *      parse JSON text compressed using gzip.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+#include <terra/json/json_gzip.h>
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Number of decompressed blocks that may await parsing
+constexpr std::size_t Maximum_Queued_Blocks = 4;
+
+// Largest size hint used to reserve space for decompressed text
+constexpr std::size_t Maximum_Size_Hint = std::size_t(1) << 31;
+
+// Largest ratio of decompressed to compressed size DEFLATE can produce
+constexpr std::size_t Maximum_Deflate_Ratio = 1032;
+
+/*
+ *  GzipSizeHint()
+ *
+ *  Description:
+ *      Determine the size of the decompressed text from the trailer of a
+ *      gzip stream, if possible.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The stream holding gzip-compressed data.
+ *
+ *  Returns:
+ *      The size of the decompressed text, or zero if it is not known.
+ *
+ *  Comments:
+ *      The gzip trailer holds the size modulo 2^32 of the last member only,
+ *      so the result is used only to reserve space.  Since the trailer is
+ *      not authenticated, the result is limited to the size the compressed
+ *      data could possibly produce.  The stream must be seekable, and its
+ *      position is restored.
+ */
+std::size_t GzipSizeHint(std::istream &input)
+{
+    unsigned char header[2]{};
+    unsigned char trailer[4]{};
+    std::size_t compressed_size = 0;
+
+    auto start = input.tellg();
+    if (start == std::istream::pos_type(-1)) return 0;
+
+    input.read(reinterpret_cast<char *>(header), sizeof(header));
+    bool gzip = input && (header[0] == 0x1f) && (header[1] == 0x8b);
+    if (gzip)
+    {
+        input.seekg(-4, std::ios::end);
+        auto trailer_position = input.tellg();
+        input.read(reinterpret_cast<char *>(trailer), sizeof(trailer));
+        gzip = static_cast<bool>(input) && (trailer_position > start);
+        if (gzip)
+        {
+            compressed_size =
+                static_cast<std::size_t>(trailer_position - start) + 4;
+        }
+    }
+
+    input.clear();
+    input.seekg(start);
+
+    if (!gzip) return 0;
+
+    std::size_t size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) |
+                       (std::uint32_t(trailer[3]) << 24);
+
+    return std::min({Maximum_Size_Hint,
+                     compressed_size * Maximum_Deflate_Ratio,
+                     size});
+}
+
+/*
+ *  ParseLine()
+ *
+ *  Description:
+ *      Parse the JSON value on a line of text, if any.
+ *
+ *  Parameters:
+ *      line [in]
+ *          The line, without its line ending.
+ *
+ *      parser [in]
+ *          The parser to use.
+ *
+ *      consumer [in]
+ *          The function to which the value is passed.
+ *
+ *  Returns:
+ *      True if a value was parsed, false if the line is blank.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ParseLine(std::u8string_view line,
+               JSONParser &parser,
+               const std::function<void(JSON &&)> &consumer)
+{
+    std::size_t first = line.find_first_not_of(u8" \t\r");
+    if (first == std::u8string_view::npos) return false;
+
+    consumer(parser.Parse(line.substr(first)));
+
+    return true;
+}
+
+// Blocks of decompressed text passed from the decompression thread
+class BlockQueue
+{
+    public:
+        BlockQueue() : finished{false}, stopped{false} {}
+        ~BlockQueue() = default;
+
+        // Push a block, waiting while the queue is full; returns false if
+        // the consumer has stopped
+        bool Push(std::u8string &&block)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            space_available.wait(lock, [&]() {
+                return stopped || (blocks.size() < Maximum_Queued_Blocks);
+            });
+            if (stopped) return false;
+            blocks.push_back(std::move(block));
+            block_available.notify_one();
+            return true;
+        }
+
+        // Pop a block, waiting while the queue is empty; returns false once
+        // all blocks have been popped, rethrowing any decompression error
+        bool Pop(std::u8string &block)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            block_available.wait(lock,
+                                 [&]() { return finished || !blocks.empty(); });
+            if (blocks.empty())
+            {
+                if (error) std::rethrow_exception(error);
+                return false;
+            }
+            block = std::move(blocks.front());
+            blocks.pop_front();
+            space_available.notify_one();
+            return true;
+        }
+
+        // Note that no more blocks will be pushed
+        void Finish(std::exception_ptr producer_error = {})
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+            error = producer_error;
+            block_available.notify_one();
+        }
+
+        // Note that no more blocks will be popped
+        void Stop()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+            space_available.notify_one();
+        }
+
+    protected:
+        std::mutex mutex;                       // Protects the members below
+        std::condition_variable block_available;
+                                                // Signaled on Push()/Finish()
+        std::condition_variable space_available;
+                                                // Signaled on Pop()/Stop()
+        std::deque<std::u8string> blocks;       // Blocks awaiting parsing
+        bool finished;                          // No more blocks
+        bool stopped;                           // Consumer stopped
+        std::exception_ptr error;               // Decompression error
+};
+
+} // namespace
+
+// Decompression state, which keeps zlib out of the public header
+struct JSONGzipSource::Stream
+{
+    z_stream z{};                               // zlib stream
+    std::vector<char> compressed;               // Block of compressed data
+};
+
+/*
+ *  JSONGzipSource::JSONGzipSource()
+ *
+ *  Description:
+ *      Constructor for the JSONGzipSource object.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The stream holding the compressed data, which must remain valid
+ *          while this object exists.
+ *
+ *      block_size [in]
+ *          The number of octets of compressed data to read at once.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if zlib cannot be initialized.
+ *
+ *  Comments:
+ *      Both the gzip and zlib formats are accepted.
+ */
+JSONGzipSource::JSONGzipSource(std::istream &input, std::size_t block_size) :
+    input{input},
+    block_size{std::max<std::size_t>(block_size, 1)},
+    stream{std::make_unique<Stream>()},
+    finished{false}
+{
+    stream->compressed.resize(this->block_size);
+
+    // Adding 32 to the window size detects the gzip or zlib header
+    if (inflateInit2(&stream->z, MAX_WBITS + 32) != Z_OK)
+    {
+        throw JSONException("Unable to initialize decompression");
+    }
+}
+
+/*
+ *  JSONGzipSource::~JSONGzipSource()
+ *
+ *  Description:
+ *      Destructor for the JSONGzipSource object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONGzipSource::~JSONGzipSource()
+{
+    inflateEnd(&stream->z);
+}
+
+/*
+ *  JSONGzipSource::Read()
+ *
+ *  Description:
+ *      Decompress the next block of text, appending it to the given string.
+ *
+ *  Parameters:
+ *      text [in/out]
+ *          The string onto which the text is appended.
+ *
+ *  Returns:
+ *      True if text was appended, or false once all of the text has been
+ *      read.  A JSONException is thrown if the compressed data is invalid
+ *      or incomplete.
+ *
+ *  Comments:
+ *      The text is decompressed directly into the given string.  Text
+ *      compressed as several concatenated gzip members is read in full.
+ */
+bool JSONGzipSource::Read(std::u8string &text)
+{
+    z_stream &z = stream->z;
+
+    while (!finished)
+    {
+        // Read more compressed data if all of it was consumed
+        if (z.avail_in == 0)
+        {
+            input.read(stream->compressed.data(),
+                       static_cast<std::streamsize>(block_size));
+            z.next_in = reinterpret_cast<Bytef *>(stream->compressed.data());
+            z.avail_in = static_cast<uInt>(input.gcount());
+            if (z.avail_in == 0)
+            {
+                if (input.bad())
+                {
+                    throw JSONException("Error reading compressed data");
+                }
+                throw JSONException("Incomplete compressed data");
+            }
+        }
+
+        // Decompress directly into the end of the string
+        std::size_t length = text.size();
+        text.resize(length + block_size);
+        z.next_out = reinterpret_cast<Bytef *>(text.data() + length);
+        z.avail_out = static_cast<uInt>(block_size);
+
+        int result = inflate(&z, Z_NO_FLUSH);
+        text.resize(length + block_size - z.avail_out);
+
+        if (result == Z_STREAM_END)
+        {
+            // Another gzip member might follow
+            if ((z.avail_in == 0) &&
+                (input.peek() == std::istream::traits_type::eof()))
+            {
+                input.clear(input.rdstate() & ~std::ios::failbit);
+                finished = true;
+            }
+            else
+            {
+                inflateReset(&z);
+            }
+        }
+        else if ((result != Z_OK) && (result != Z_BUF_ERROR))
+        {
+            throw JSONException("Invalid compressed data");
+        }
+
+        if (text.size() > length) return true;
+    }
+
+    return false;
+}
+
+/*
+ *  ParseGzip()
+ *
+ *  Description:
+ *      Parse the JSON document compressed within the given stream.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The stream holding the gzip or zlib compressed JSON text.
+ *
+ *      options [in]
+ *          The options used to parse the document.
+ *
+ *  Returns:
+ *      The parsed document.  A JSONException is thrown if the data cannot
+ *      be decompressed or the text cannot be parsed.
+ *
+ *  Comments:
+ *      The text is decompressed into a single buffer that is then parsed.
+ *      If the stream is seekable, the size recorded in the gzip trailer is
+ *      used to allocate the buffer once.  Decompression stops as soon as
+ *      the text exceeds the maximum document size.
+ */
+JSON ParseGzip(std::istream &input, const ParserOptions &options)
+{
+    std::u8string text;
+
+    text.reserve(std::min(GzipSizeHint(input), options.max_document_size) +
+                 JSONGzipSource::Default_Block_Size);
+
+    JSONGzipSource source(input);
+    while (source.Read(text))
+    {
+        if (text.size() > options.max_document_size)
+        {
+            throw JSONException(
+                "The content exceeds the maximum document size");
+        }
+    }
+
+    return JSONParser(options).Parse(text);
+}
+
+/*
+ *  ParseGzipLines()
+ *
+ *  Description:
+ *      Parse the JSON values, one per line, compressed within the given
+ *      stream.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The stream holding the gzip or zlib compressed JSON text.
+ *
+ *      consumer [in]
+ *          The function to which each value is passed, in order.
+ *
+ *      options [in]
+ *          The options used to parse each value.
+ *
+ *  Returns:
+ *      The number of values parsed.  A JSONException is thrown if the data
+ *      cannot be decompressed or a line cannot be parsed, and exceptions
+ *      thrown by the consumer are propagated.
+ *
+ *  Comments:
+ *      A separate thread decompresses the text while the calling thread
+ *      parses it.  The consumer is called on the calling thread.  Each line
+ *      is subject to the maximum document size, and decompression stops as
+ *      soon as a partial line exceeds it.
+ */
+std::size_t ParseGzipLines(std::istream &input,
+                           const std::function<void(JSON &&)> &consumer,
+                           const ParserOptions &options)
+{
+    BlockQueue queue;
+    JSONParser parser(options);
+    std::u8string pending;
+    std::u8string block;
+    std::size_t scan = 0;
+    std::size_t count = 0;
+
+    // Decompress on a separate thread
+    std::thread decompressor([&]() {
+        try
+        {
+            JSONGzipSource source(input);
+            std::u8string text;
+            while (source.Read(text))
+            {
+                if (!queue.Push(std::move(text))) return;
+                text.clear();
+            }
+            queue.Finish();
+        }
+        catch (...)
+        {
+            queue.Finish(std::current_exception());
+        }
+    });
+
+    try
+    {
+        while (queue.Pop(block))
+        {
+            // Avoid copying the block if no partial line is pending
+            if (pending.empty())
+            {
+                pending.swap(block);
+            }
+            else
+            {
+                pending += block;
+            }
+
+            // Parse each complete line, searching only the text that was
+            // not searched when previous blocks were received
+            std::size_t start = 0;
+            std::size_t end;
+            while ((end = pending.find(u8'\n', scan)) != std::u8string::npos)
+            {
+                std::u8string_view line(pending.data() + start, end - start);
+                if (ParseLine(line, parser, consumer)) count++;
+                start = scan = end + 1;
+            }
+            pending.erase(0, start);
+            scan = pending.size();
+
+            if (pending.size() > options.max_document_size)
+            {
+                throw JSONException(
+                    "The content exceeds the maximum document size");
+            }
+        }
+
+        // The last line need not end with a newline
+        if (ParseLine(pending, parser, consumer)) count++;
+    }
+    catch (...)
+    {
+        queue.Stop();
+        decompressor.join();
+        throw;
+    }
+
+    decompressor.join();
+
+    return count;
+}
+
+} // namespace Terra::JSON
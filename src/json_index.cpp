@@ -0,0 +1,417 @@
+/*
+ *  json_index.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the JSONArrayIndex object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cmath>
+#include <terra/json/json_index.h>
+
+namespace Terra::JSON
+{
+
+/*
+ *  JSONArrayIndex::JSONArrayIndex()
+ *
+ *  Description:
+ *      Constructor for the JSONArrayIndex that indexes the elements of the
+ *      given array by the value of the given member.
+ *
+ *  Parameters:
+ *      array [in]
+ *          The array of objects to index.
+ *
+ *      key [in]
+ *          The key of the member whose value is indexed.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONArrayIndex::JSONArrayIndex(JSONArray &array, const std::u8string &key) :
+    JSONArrayIndex(array, std::vector<std::u8string>{key})
+{
+}
+
+/*
+ *  JSONArrayIndex::JSONArrayIndex()
+ *
+ *  Description:
+ *      Constructor for the JSONArrayIndex that indexes the elements of the
+ *      given array by the value of the given member.
+ *
+ *  Parameters:
+ *      array [in]
+ *          The array of objects to index.
+ *
+ *      key [in]
+ *          The key of the member whose value is indexed.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONArrayIndex::JSONArrayIndex(JSONArray &array, const std::string &key) :
+    JSONArrayIndex(array, std::u8string(key.cbegin(), key.cend()))
+{
+}
+
+/*
+ *  JSONArrayIndex::JSONArrayIndex()
+ *
+ *  Description:
+ *      Constructor for the JSONArrayIndex that indexes the elements of the
+ *      given array by the value of a member of a nested object.
+ *
+ *  Parameters:
+ *      array [in]
+ *          The array of objects to index.
+ *
+ *      path [in]
+ *          The keys leading from each element to the indexed member.  For
+ *          example, {u8"user", u8"id"} indexes elements by the "id" member
+ *          of the object that is the value of each element's "user" member.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONArrayIndex::JSONArrayIndex(JSONArray &array,
+                               std::vector<std::u8string> path) :
+    array{array},
+    path{std::move(path)},
+    version{},
+    element_version{},
+    size{}
+{
+    if (this->path.empty())
+    {
+        throw JSONException("The path to the indexed member is empty");
+    }
+
+    Rebuild();
+}
+
+/*
+ *  JSONArrayIndex::Rebuild()
+ *
+ *  Description:
+ *      Rebuild the index from the present content of the array.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void JSONArrayIndex::Rebuild()
+{
+    const JSONArray &elements = array;
+
+    positions.clear();
+    positions.reserve(elements.Size());
+    size = 0;
+
+    IndexElements();
+
+    version = elements.Version();
+    element_version = elements.ElementVersion();
+}
+
+/*
+ *  JSONArrayIndex::IndexElement()
+ *
+ *  Description:
+ *      Add the array element at the given position to the index.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the element in the array.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      If another element having the same key precedes this one, that
+ *      element remains the one found.  Any entry for a key the element
+ *      previously held is left in place and is detected as stale when found.
+ */
+void JSONArrayIndex::IndexElement(std::size_t position)
+{
+    const JSONArray &elements = array;
+    const JSON *value = Lookup(elements[position]);
+    Key key;
+
+    if ((value == nullptr) || !MakeKey(*value, key)) return;
+
+    auto [it, inserted] = positions.try_emplace(std::move(key), position);
+    if (!inserted && (position < it->second)) it->second = position;
+}
+
+/*
+ *  JSONArrayIndex::IndexElements()
+ *
+ *  Description:
+ *      Add the elements of the array that follow those already indexed to
+ *      the index.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Elements already indexed take precedence, so the first element having
+ *      a given key is the one found.
+ */
+void JSONArrayIndex::IndexElements()
+{
+    const JSONArray &elements = array;
+
+    for (std::size_t i = size; i < elements.Size(); i++) IndexElement(i);
+
+    size = elements.Size();
+}
+
+/*
+ *  JSONArrayIndex::FindPosition()
+ *
+ *  Description:
+ *      Find the position of the array element whose indexed member has the
+ *      given value.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The value of the indexed member to find.
+ *
+ *  Returns:
+ *      The position of the element in the array or Not_Found if there is
+ *      no such element.
+ *
+ *  Comments:
+ *      If elements were inserted, erased, or reordered since the index was
+ *      built, the index is rebuilt before searching.  Elements appended via
+ *      Emplace() are added to the index, as is an element accessed via the
+ *      array's non-const operator[] if it is the only one accessed since
+ *      the previous search.  Otherwise, the element found is verified to
+ *      still hold the key, and the index is rebuilt only if it does not or
+ *      if the key is not found after elements were modified.  Either way,
+ *      the index is brought up to date, so the index is rebuilt at most
+ *      once per change to the array.
+ */
+std::size_t JSONArrayIndex::FindPosition(const JSON &key)
+{
+    const JSONArray &elements = array;
+    Key search_key;
+
+    // Only scalar values are indexed
+    if (!MakeKey(key, search_key)) return Not_Found;
+
+    // Rebuild the index if elements were inserted, erased, or reordered
+    if ((elements.Version() != version) || (elements.Size() < size))
+    {
+        Rebuild();
+    }
+    else if (elements.ElementVersion() != element_version)
+    {
+        // Each append or element access advances the element version by
+        // one, so if the only changes were appends and at most one access
+        // via operator[], the index can be brought up to date directly
+        std::uint64_t changes = elements.ElementVersion() - element_version;
+        std::size_t appended = elements.Size() - size;
+
+        IndexElements();
+
+        if (changes == appended + 1)
+        {
+            if (elements.LastAccessed() < elements.Size())
+            {
+                IndexElement(elements.LastAccessed());
+            }
+            changes = appended;
+        }
+
+        if (changes == appended) element_version = elements.ElementVersion();
+    }
+
+    for (bool rebuilt = false;; rebuilt = true)
+    {
+        auto it = positions.find(search_key);
+
+        if (it != positions.end())
+        {
+            // Verify the element still holds the requested key
+            if (it->second < elements.Size())
+            {
+                const JSON *value = Lookup(elements[it->second]);
+                Key element_key;
+                if ((value != nullptr) && MakeKey(*value, element_key) &&
+                    (element_key == search_key))
+                {
+                    return it->second;
+                }
+            }
+        }
+        else if (elements.ElementVersion() == element_version)
+        {
+            // No element was modified since the index was built
+            return Not_Found;
+        }
+
+        // The index may be stale; rebuild it once and try again
+        if (rebuilt) return Not_Found;
+        Rebuild();
+    }
+}
+
+/*
+ *  JSONArrayIndex::Find()
+ *
+ *  Description:
+ *      Find the array element whose indexed member has the given value.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The value of the indexed member to find.
+ *
+ *  Returns:
+ *      A pointer to the element or nullptr if there is no such element.
+ *
+ *  Comments:
+ *      To modify the element, access it via the array using the position
+ *      returned by FindPosition() so the change is noted by the index.
+ *      Changing values other than the indexed member does not require the
+ *      index to be rebuilt.
+ */
+const JSON *JSONArrayIndex::Find(const JSON &key)
+{
+    std::size_t position = FindPosition(key);
+
+    if (position == Not_Found) return nullptr;
+
+    return &static_cast<const JSONArray &>(array)[position];
+}
+
+/*
+ *  JSONArrayIndex::MakeKey()
+ *
+ *  Description:
+ *      Produce the normalized key for the given value.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The value for which to produce a key.
+ *
+ *      key [out]
+ *          The normalized key.
+ *
+ *  Returns:
+ *      True if a key was produced or false if the value is not a type of
+ *      value that is indexed.
+ *
+ *  Comments:
+ *      Floating point values having an integral value are converted to
+ *      integers so that numerically equal values produce the same key.
+ */
+bool JSONArrayIndex::MakeKey(const JSON &value, Key &key)
+{
+    switch (value.GetValueType())
+    {
+        case JSONValueType::String:
+            key = *value.GetValue<JSONString>();
+            return true;
+
+        case JSONValueType::Number:
+        {
+            const JSONNumber &number = value.GetValue<JSONNumber>();
+
+            if (number.IsInteger())
+            {
+                key = number.GetInteger();
+                return true;
+            }
+
+            constexpr auto Minimum = static_cast<JSONFloat>(
+                std::numeric_limits<JSONInteger>::min());
+            constexpr auto Maximum = static_cast<JSONFloat>(
+                std::numeric_limits<JSONInteger>::max());
+            JSONFloat float_value = number.GetFloat();
+
+            if ((std::trunc(float_value) == float_value) &&
+                (float_value >= Minimum) && (float_value < Maximum))
+            {
+                key = static_cast<JSONInteger>(float_value);
+            }
+            else
+            {
+                key = float_value;
+            }
+            return true;
+        }
+
+        case JSONValueType::Literal:
+            key = value.GetValue<JSONLiteral>();
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/*
+ *  JSONArrayIndex::Lookup()
+ *
+ *  Description:
+ *      Follow the path from the given element to the indexed member.
+ *
+ *  Parameters:
+ *      element [in]
+ *          The array element.
+ *
+ *  Returns:
+ *      A pointer to the indexed member or nullptr if the element does not
+ *      contain the member.
+ *
+ *  Comments:
+ *      None.
+ */
+const JSON *JSONArrayIndex::Lookup(const JSON &element) const
+{
+    const JSON *current = &element;
+
+    for (const auto &key : path)
+    {
+        if (current->GetValueType() != JSONValueType::Object) return nullptr;
+
+        const JSONObjectMap &members = *current->GetValue<JSONObject>();
+        auto it = members.find(key);
+        if (it == members.end()) return nullptr;
+
+        current = &it->second;
+    }
+
+    return current;
+}
+
+} // namespace Terra::JSON
@@ -0,0 +1,701 @@
+/*
+ *  json_node_pool.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the NodePool, a size-class pool allocator with
+ *      per-thread caches and support for freeing blocks from any thread.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <terra/json/json_node_pool.h>
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Block sizes for each size class
+constexpr std::array<std::size_t, NodePoolStats::Size_Classes> Class_Sizes =
+{
+    16, 32, 48, 64, 80, 96, 128, 160, 192, 256, 384, 512
+};
+
+// Space at the start of each chunk reserved for the chunk header
+constexpr std::size_t Chunk_Header_Size = 64;
+
+// Alignment used to avoid false sharing between threads
+constexpr std::size_t Cache_Line_Size = 64;
+
+/*
+ *  ClassIndexTable()
+ *
+ *  Description:
+ *      Produce a table that maps a request size, expressed in units of
+ *      NodePool::Alignment (rounded up), to the smallest size class able
+ *      to satisfy the request.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The size class lookup table.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr auto ClassIndexTable()
+{
+    std::array<std::uint8_t,
+               NodePool::Maximum_Block_Size / NodePool::Alignment + 1> table{};
+    std::size_t size_class = 0;
+
+    for (std::size_t i = 0; i < table.size(); i++)
+    {
+        while (Class_Sizes[size_class] < i * NodePool::Alignment) size_class++;
+        table[i] = static_cast<std::uint8_t>(size_class);
+    }
+
+    return table;
+}
+
+// Table used to map request sizes to size classes
+constexpr auto Class_Index = ClassIndexTable();
+
+// Free blocks are linked through their first octets
+struct FreeBlock
+{
+    FreeBlock *next;
+};
+
+struct ThreadCache;
+
+// Header placed at the start of every chunk
+struct ChunkHeader
+{
+    ThreadCache *owner;                         // Owner (if in a size class)
+    std::size_t size_class;                     // Size class of the chunk
+    NodePool::SequentialRegion::State *region;  // Region (if in a region)
+    char *next_chunk;                           // Next chunk in the region
+};
+
+static_assert(sizeof(ChunkHeader) <= Chunk_Header_Size);
+static_assert(Chunk_Header_Size % NodePool::Alignment == 0);
+
+// Blocks and counters for a single size class within a thread cache
+struct alignas(Cache_Line_Size) SizeClassCache
+{
+    // Used only by the owning thread
+    FreeBlock *free_list{};
+    char *carve_position{};
+    char *carve_end{};
+
+    // Counters written only by the owning thread
+    std::atomic<std::uint64_t> allocations{};
+    std::atomic<std::uint64_t> deallocations{};
+    std::atomic<std::uint64_t> chunks{};
+
+    // Written by other threads, so kept on a separate cache line
+    alignas(Cache_Line_Size) std::atomic<FreeBlock *> remote_free_list{};
+    std::atomic<std::uint64_t> remote_deallocations{};
+};
+
+// Per-thread cache of blocks for every size class
+struct ThreadCache
+{
+    std::array<SizeClassCache, NodePoolStats::Size_Classes> classes;
+
+    // Counters written only by the owning thread
+    std::atomic<std::uint64_t> refills{};
+    std::atomic<std::uint64_t> refill_nanoseconds{};
+    std::atomic<std::uint64_t> max_refill_nanoseconds{};
+};
+
+// Registry of every thread cache created, including orphaned caches
+struct CacheRegistry
+{
+    std::mutex mutex;
+    std::vector<ThreadCache *> caches;
+    std::vector<ThreadCache *> orphans;
+};
+
+/*
+ *  Registry()
+ *
+ *  Description:
+ *      Return the registry of thread caches.  The registry is intentionally
+ *      never destroyed, as blocks may be freed during program termination.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the cache registry.
+ *
+ *  Comments:
+ *      None.
+ */
+CacheRegistry &Registry()
+{
+    static CacheRegistry *registry = new CacheRegistry;
+
+    return *registry;
+}
+
+// Number of requests passed to operator new
+std::atomic<std::uint64_t> Large_Allocations{};
+
+// Number of blocks allocated from sequential regions
+std::atomic<std::uint64_t> Region_Allocations{};
+
+// Number of bytes presently held by sequential regions
+std::atomic<std::uint64_t> Region_Bytes_Reserved{};
+
+// The sequential region in use by the calling thread, if any
+thread_local NodePool::SequentialRegion::State *Local_Region{};
+
+// Holds the calling thread's cache, orphaning it when the thread exits
+struct ThreadCacheHandle
+{
+    ThreadCache *cache{};
+
+    ~ThreadCacheHandle()
+    {
+        if (cache == nullptr) return;
+
+        CacheRegistry &registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.orphans.push_back(cache);
+        cache = nullptr;
+    }
+};
+
+thread_local ThreadCacheHandle Local_Cache;
+
+/*
+ *  Increment()
+ *
+ *  Description:
+ *      Increment a counter that is only ever written by a single thread.
+ *      Since there is only one writer, no read-modify-write operation is
+ *      required.
+ *
+ *  Parameters:
+ *      counter [in/out]
+ *          The counter to increment.
+ *
+ *      amount [in]
+ *          The amount by which to increment the counter.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+inline void Increment(std::atomic<std::uint64_t> &counter,
+                      std::uint64_t amount = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount,
+                  std::memory_order_relaxed);
+}
+
+/*
+ *  LocalCache()
+ *
+ *  Description:
+ *      Return the calling thread's cache, adopting an orphaned cache or
+ *      creating a new one if the thread does not yet have a cache.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the calling thread's cache.
+ *
+ *  Comments:
+ *      None.
+ */
+ThreadCache &LocalCache()
+{
+    if (Local_Cache.cache != nullptr) return *Local_Cache.cache;
+
+    CacheRegistry &registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    if (!registry.orphans.empty())
+    {
+        Local_Cache.cache = registry.orphans.back();
+        registry.orphans.pop_back();
+    }
+    else
+    {
+        Local_Cache.cache = new ThreadCache;
+        registry.caches.push_back(Local_Cache.cache);
+    }
+
+    return *Local_Cache.cache;
+}
+
+/*
+ *  IsLargeRequest()
+ *
+ *  Description:
+ *      Determine whether the request must be passed to operator new.
+ *
+ *  Parameters:
+ *      size [in]
+ *          The size of the request in octets.
+ *
+ *      alignment [in]
+ *          The required alignment of the request.
+ *
+ *  Returns:
+ *      True if the request cannot be satisfied by a size class.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr bool IsLargeRequest(std::size_t size, std::size_t alignment)
+{
+    return (size > NodePool::Maximum_Block_Size) ||
+           (alignment > NodePool::Alignment);
+}
+
+/*
+ *  Refill()
+ *
+ *  Description:
+ *      Obtain a block when the free list of the given size class is empty
+ *      and the current chunk is exhausted.  Blocks freed by other threads are
+ *      reclaimed first; otherwise, a new chunk is obtained.
+ *
+ *  Parameters:
+ *      cache [in/out]
+ *          The calling thread's cache.
+ *
+ *      size_class [in]
+ *          The size class from which a block is required.
+ *
+ *  Returns:
+ *      A pointer to the allocated block.
+ *
+ *  Comments:
+ *      The time spent in this function is recorded in the statistics.
+ */
+void *Refill(ThreadCache &cache, std::size_t size_class)
+{
+    SizeClassCache &entry = cache.classes[size_class];
+    void *block{};
+    auto start = std::chrono::steady_clock::now();
+
+    // Reclaim all blocks freed by other threads
+    FreeBlock *reclaimed =
+        entry.remote_free_list.exchange(nullptr, std::memory_order_acquire);
+
+    if (reclaimed != nullptr)
+    {
+        entry.free_list = reclaimed->next;
+        block = reclaimed;
+    }
+    else
+    {
+        // Obtain a new chunk aligned such that its header can be located
+        // from the address of any block within it
+        char *chunk = static_cast<char *>(
+            ::operator new(NodePool::Chunk_Size,
+                           std::align_val_t(NodePool::Chunk_Size)));
+        new (chunk) ChunkHeader{&cache, size_class, nullptr, nullptr};
+
+        entry.carve_position = chunk + Chunk_Header_Size;
+        entry.carve_end = chunk + NodePool::Chunk_Size;
+        Increment(entry.chunks);
+
+        block = entry.carve_position;
+        entry.carve_position += Class_Sizes[size_class];
+    }
+
+    // Record the time spent in the slow path
+    auto elapsed = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    Increment(cache.refills);
+    Increment(cache.refill_nanoseconds, elapsed);
+    if (elapsed > cache.max_refill_nanoseconds.load(std::memory_order_relaxed))
+    {
+        cache.max_refill_nanoseconds.store(elapsed, std::memory_order_relaxed);
+    }
+
+    return block;
+}
+
+} // namespace
+
+// State of a sequential region
+struct NodePool::SequentialRegion::State
+{
+    // One reference for the SequentialRegion plus one per allocated block
+    std::atomic<std::size_t> references{1};
+    char *position{};
+    char *end{};
+    char *chunks{};
+};
+
+namespace
+{
+
+/*
+ *  AllocateFromRegion()
+ *
+ *  Description:
+ *      Allocate a block by carving it from the end of the given region,
+ *      obtaining a new chunk when the current chunk is exhausted.
+ *
+ *  Parameters:
+ *      region [in/out]
+ *          The region from which to allocate the block.
+ *
+ *      size [in]
+ *          The number of octets required.
+ *
+ *  Returns:
+ *      A pointer to the allocated block.
+ *
+ *  Comments:
+ *      None.
+ */
+void *AllocateFromRegion(NodePool::SequentialRegion::State &region,
+                         std::size_t size)
+{
+    // Round up the size such that the next block is also aligned
+    size = std::max(size, NodePool::Alignment);
+    size = (size + NodePool::Alignment - 1) & ~(NodePool::Alignment - 1);
+
+    if (static_cast<std::size_t>(region.end - region.position) < size)
+    {
+        char *chunk = static_cast<char *>(
+            ::operator new(NodePool::Chunk_Size,
+                           std::align_val_t(NodePool::Chunk_Size)));
+        new (chunk) ChunkHeader{nullptr, 0, &region, region.chunks};
+
+        region.chunks = chunk;
+        region.position = chunk + Chunk_Header_Size;
+        region.end = chunk + NodePool::Chunk_Size;
+        Region_Bytes_Reserved.fetch_add(NodePool::Chunk_Size,
+                                        std::memory_order_relaxed);
+    }
+
+    void *block = region.position;
+    region.position += size;
+    region.references.fetch_add(1, std::memory_order_relaxed);
+    Region_Allocations.fetch_add(1, std::memory_order_relaxed);
+
+    return block;
+}
+
+/*
+ *  ReleaseRegion()
+ *
+ *  Description:
+ *      Release one reference to the given region, freeing all of its chunks
+ *      when the last reference is released.
+ *
+ *  Parameters:
+ *      region [in]
+ *          The region to release.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void ReleaseRegion(NodePool::SequentialRegion::State *region) noexcept
+{
+    if (region->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    while (region->chunks != nullptr)
+    {
+        char *chunk = region->chunks;
+        region->chunks = reinterpret_cast<ChunkHeader *>(chunk)->next_chunk;
+        ::operator delete(chunk, std::align_val_t(NodePool::Chunk_Size));
+        Region_Bytes_Reserved.fetch_sub(NodePool::Chunk_Size,
+                                        std::memory_order_relaxed);
+    }
+
+    delete region;
+}
+
+} // namespace
+
+/*
+ *  NodePool::Allocate()
+ *
+ *  Description:
+ *      Allocate a block of memory of at least the given size.
+ *
+ *  Parameters:
+ *      size [in]
+ *          The number of octets required.
+ *
+ *      alignment [in]
+ *          The required alignment of the memory.
+ *
+ *  Returns:
+ *      A pointer to the allocated memory.  If memory cannot be allocated,
+ *      std::bad_alloc is thrown.
+ *
+ *  Comments:
+ *      The same size and alignment must be provided to Deallocate().
+ */
+void *NodePool::Allocate(std::size_t size, std::size_t alignment)
+{
+    // Requests not served by a size class are given to operator new
+    if (IsLargeRequest(size, alignment))
+    {
+        Large_Allocations.fetch_add(1, std::memory_order_relaxed);
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return ::operator new(size, std::align_val_t(alignment));
+        }
+        return ::operator new(size);
+    }
+
+    // Place the block in the sequential region, if one is in use
+    if (Local_Region != nullptr) return AllocateFromRegion(*Local_Region, size);
+
+    ThreadCache &cache = LocalCache();
+    std::size_t size_class =
+        Class_Index[(size + NodePool::Alignment - 1) / NodePool::Alignment];
+    SizeClassCache &entry = cache.classes[size_class];
+
+    Increment(entry.allocations);
+
+    // Take a block from the free list, if available
+    if (entry.free_list != nullptr)
+    {
+        FreeBlock *block = entry.free_list;
+        entry.free_list = block->next;
+        return block;
+    }
+
+    // Carve a new block from the current chunk, if there is room
+    if (static_cast<std::size_t>(entry.carve_end - entry.carve_position) >=
+        Class_Sizes[size_class])
+    {
+        void *block = entry.carve_position;
+        entry.carve_position += Class_Sizes[size_class];
+        return block;
+    }
+
+    return Refill(cache, size_class);
+}
+
+/*
+ *  NodePool::Deallocate()
+ *
+ *  Description:
+ *      Return a block of memory previously obtained from Allocate().  This
+ *      function may be called from any thread.
+ *
+ *  Parameters:
+ *      pointer [in]
+ *          The block of memory to free.
+ *
+ *      size [in]
+ *          The size given to Allocate() when the block was allocated.
+ *
+ *      alignment [in]
+ *          The alignment given to Allocate() when the block was allocated.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void NodePool::Deallocate(void *pointer,
+                          std::size_t size,
+                          std::size_t alignment) noexcept
+{
+    if (pointer == nullptr) return;
+
+    // Requests not served by a size class were given to operator new
+    if (IsLargeRequest(size, alignment))
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(pointer, std::align_val_t(alignment));
+            return;
+        }
+        ::operator delete(pointer);
+        return;
+    }
+
+    // Locate the header of the chunk containing this block
+    const ChunkHeader *header = reinterpret_cast<const ChunkHeader *>(
+        reinterpret_cast<std::uintptr_t>(pointer) &
+        ~static_cast<std::uintptr_t>(NodePool::Chunk_Size - 1));
+
+    // Blocks in a sequential region are released along with the region
+    if (header->region != nullptr)
+    {
+        ReleaseRegion(header->region);
+        return;
+    }
+
+    SizeClassCache &entry = header->owner->classes[header->size_class];
+    FreeBlock *block = static_cast<FreeBlock *>(pointer);
+
+    // Blocks owned by this thread go directly onto the free list
+    if (header->owner == Local_Cache.cache)
+    {
+        block->next = entry.free_list;
+        entry.free_list = block;
+        Increment(entry.deallocations);
+        return;
+    }
+
+    // Push the block onto the owning cache's remote free list
+    block->next = entry.remote_free_list.load(std::memory_order_relaxed);
+    while (!entry.remote_free_list.compare_exchange_weak(
+        block->next,
+        block,
+        std::memory_order_release,
+        std::memory_order_relaxed))
+    {
+    }
+    entry.remote_deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+ *  NodePool::GetStats()
+ *
+ *  Description:
+ *      Return statistics describing the use of the pool across all threads.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The pool statistics.
+ *
+ *  Comments:
+ *      Since other threads may be allocating memory while the statistics
+ *      are gathered, the values are approximate.
+ */
+NodePoolStats NodePool::GetStats()
+{
+    NodePoolStats stats;
+    CacheRegistry &registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (const ThreadCache *cache : registry.caches)
+    {
+        for (std::size_t i = 0; i < NodePoolStats::Size_Classes; i++)
+        {
+            const SizeClassCache &entry = cache->classes[i];
+            std::uint64_t allocations =
+                entry.allocations.load(std::memory_order_relaxed);
+            std::uint64_t deallocations =
+                entry.deallocations.load(std::memory_order_relaxed);
+            std::uint64_t remote_deallocations =
+                entry.remote_deallocations.load(std::memory_order_relaxed);
+            std::uint64_t chunks = entry.chunks.load(std::memory_order_relaxed);
+            std::uint64_t blocks_freed = deallocations + remote_deallocations;
+            std::uint64_t blocks_in_use =
+                (allocations > blocks_freed) ? allocations - blocks_freed : 0;
+
+            stats.allocations += allocations;
+            stats.deallocations += blocks_freed;
+            stats.remote_deallocations += remote_deallocations;
+            stats.chunks += chunks;
+            stats.class_bytes_in_use[i] += blocks_in_use * Class_Sizes[i];
+            stats.class_bytes_reserved[i] += chunks * NodePool::Chunk_Size;
+            stats.bytes_in_use += blocks_in_use * Class_Sizes[i];
+            stats.bytes_reserved += chunks * NodePool::Chunk_Size;
+        }
+
+        stats.refills += cache->refills.load(std::memory_order_relaxed);
+        stats.refill_nanoseconds +=
+            cache->refill_nanoseconds.load(std::memory_order_relaxed);
+        stats.max_refill_nanoseconds = std::max(
+            stats.max_refill_nanoseconds,
+            cache->max_refill_nanoseconds.load(std::memory_order_relaxed));
+    }
+
+    stats.large_allocations =
+        Large_Allocations.load(std::memory_order_relaxed);
+    stats.region_allocations =
+        Region_Allocations.load(std::memory_order_relaxed);
+    stats.region_bytes_reserved =
+        Region_Bytes_Reserved.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+/*
+ *  NodePool::SequentialRegion::SequentialRegion()
+ *
+ *  Description:
+ *      Create a sequential region and make it the region used by the calling
+ *      thread for subsequent allocations.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+NodePool::SequentialRegion::SequentialRegion() :
+    state{new State},
+    previous{Local_Region}
+{
+    Local_Region = state;
+}
+
+/*
+ *  NodePool::SequentialRegion::~SequentialRegion()
+ *
+ *  Description:
+ *      Restore the region previously used by the calling thread.  The memory
+ *      held by this region remains in use until all blocks allocated from it
+ *      are freed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The object must be destroyed by the thread that created it.
+ */
+NodePool::SequentialRegion::~SequentialRegion()
+{
+    Local_Region = previous;
+    ReleaseRegion(state);
+}
+
+} // namespace Terra::JSON
@@ -19,10 +19,13 @@
 #include <sstream>
 #include <format>
 #include <cmath>
+#include <charconv>
+#include <algorithm>
 #ifdef TERRA_DISABLE_STD_FORMAT
 #include <iomanip>
 #endif
 #include <terra/json/json.h>
+#include "json_number_text.h"
 
 namespace Terra::JSON
 {
@@ -158,4 +161,127 @@ std::string JSONNumber::ToString() const
     return oss.str();
 }
 
+/*
+ *  FormatNumber()
+ *
+ *  Description:
+ *      Produce the JSON text for the given number in the given buffer.  The
+ *      text is the same as that produced by the streaming operator for a
+ *      JSONNumber.
+ *
+ *  Parameters:
+ *      number [in]
+ *          The number to format.
+ *
+ *      buffer [out]
+ *          The buffer into which the text is written.
+ *
+ *  Returns:
+ *      A view of the text within the buffer.  A JSONException is thrown if
+ *      the number is infinity or NaN.
+ *
+ *  Comments:
+ *      The shortest text that represents a floating point number exactly,
+ *      which is what std::format("{}") produces, requires at most 24 octets.
+ */
+std::string_view FormatNumber(const JSONNumber &number,
+                              char (&buffer)[Number_Text_Size])
+{
+    if (number.IsInteger())
+    {
+        auto result = std::to_chars(buffer,
+                                    buffer + Number_Text_Size,
+                                    number.GetInteger());
+        return std::string_view(buffer, result.ptr - buffer);
+    }
+
+    JSONFloat value = number.GetFloat();
+
+    // Infinity and NaN are not permitted in JSON
+    if (std::isinf(value))
+    {
+        throw JSONException("Value of infinity is disallowed in JSON");
+    }
+    if (std::isnan(value))
+    {
+        throw JSONException("Value of NaN is disallowed in JSON");
+    }
+
+    // If this is a -0 value, produce a 0
+    if (value == -0.0) value = 0.0;
+
+#ifndef TERRA_DISABLE_STD_FORMAT
+    auto result = std::format_to_n(buffer, Number_Text_Size, "{}", value);
+    return std::string_view(buffer, result.out - buffer);
+#else
+    std::ostringstream oss;
+    oss << value;
+    std::string text = oss.str();
+    std::size_t length = std::min(text.size(), Number_Text_Size);
+    text.copy(buffer, length);
+    return std::string_view(buffer, length);
+#endif
+}
+
+
+/*
+ *  ToJSONText()
+ *
+ *  Description:
+ *      Produce the JSON text for an array of the given values without first
+ *      constructing a JSONArray.
+ *
+ *  Parameters:
+ *      values [in]
+ *          The values to serialize.
+ *
+ *  Returns:
+ *      The JSON text, which is the same as that produced for a JSONArray
+ *      holding the values.  A JSONException is thrown if a value cannot be
+ *      represented in JSON.
+ *
+ *  Comments:
+ *      None.
+ */
+template<JSONArithmetic T>
+std::string ToJSONText(std::span<const T> values)
+{
+    std::string output;
+    bool need_comma = false;
+
+    output.reserve(values.size() * 4 + 2);
+    output.push_back('[');
+
+    for (const T value : values)
+    {
+        char buffer[Number_Text_Size];
+
+        if (need_comma) output += ", ";
+        output += FormatNumber(JSONNumber(value), buffer);
+        need_comma = true;
+    }
+
+    output.push_back(']');
+
+    return output;
+}
+
+// Instantiate the above for each JSONArithmetic type
+template std::string ToJSONText<signed char>(std::span<const signed char>);
+template std::string ToJSONText<short>(std::span<const short>);
+template std::string ToJSONText<int>(std::span<const int>);
+template std::string ToJSONText<long>(std::span<const long>);
+template std::string ToJSONText<long long>(std::span<const long long>);
+template std::string ToJSONText<unsigned char>(
+                                        std::span<const unsigned char>);
+template std::string ToJSONText<unsigned short>(
+                                        std::span<const unsigned short>);
+template std::string ToJSONText<unsigned>(std::span<const unsigned>);
+template std::string ToJSONText<unsigned long>(
+                                        std::span<const unsigned long>);
+template std::string ToJSONText<unsigned long long>(
+                                        std::span<const unsigned long long>);
+template std::string ToJSONText<float>(std::span<const float>);
+template std::string ToJSONText<double>(std::span<const double>);
+
 } // namespace Terra::JSON
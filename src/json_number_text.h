@@ -0,0 +1,37 @@
+/*
+ *  json_number_text.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines a function that produces the JSON text for a number
+ *      in a caller-provided buffer, which is used by serializers that should
+ *      not allocate memory for each number.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <terra/json/json.h>
+
+namespace Terra::JSON
+{
+
+// Size of a buffer sufficient to hold the JSON text for any number
+constexpr std::size_t Number_Text_Size = 32;
+
+// Produce the JSON text for the given number in the given buffer, returning
+// a view of the text; a JSONException is thrown for infinity or NaN
+std::string_view FormatNumber(const JSONNumber &number,
+                              char (&buffer)[Number_Text_Size]);
+
+} // namespace Terra::JSON
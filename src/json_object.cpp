@@ -18,6 +18,7 @@
 
 #include <sstream>
 #include <terra/json/json.h>
+#include "json_escape.h"
 
 namespace Terra::JSON
 {
@@ -53,7 +54,8 @@ std::ostream &operator<<(std::ostream &o, const JSONObject &object)
     for (const auto &[key, value] : *object)
     {
         if (need_comma) o << ", ";
-        o << JSONString(key) << ": " << value;
+        WriteEscaped(o, key);
+        o << ": " << value;
         need_comma = true;
     }
 
@@ -115,6 +117,154 @@ JSONObject::JSONObject(
     }
 }
 
+/*
+ *  JSONObject::Member()
+ *
+ *  Description:
+ *      Return the member having the given key, inserting a new member if
+ *      there is no such member.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member to return.
+ *
+ *  Returns:
+ *      A reference to the member's JSON value.
+ *
+ *  Comments:
+ *      A std::u8string is constructed only if a member is inserted.
+ */
+JSON &JSONObject::Member(const std::u8string_view key)
+{
+    auto it = value.lower_bound(key);
+
+    if ((it != value.end()) && (it->first == key)) return it->second;
+
+    return value.try_emplace(it, std::u8string(key))->second;
+}
+
+/*
+ *  JSONObject::Member()
+ *
+ *  Description:
+ *      Return the member having the given key.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member to return.
+ *
+ *  Returns:
+ *      A reference to the member's JSON value.  If there is no such member,
+ *      std::out_of_range is thrown.
+ *
+ *  Comments:
+ *      None.
+ */
+const JSON &JSONObject::Member(const std::u8string_view key) const
+{
+    auto it = value.find(key);
+
+    if (it == value.end()) throw std::out_of_range("JSONObject key not found");
+
+    return it->second;
+}
+
+/*
+ *  JSONObject::Find()
+ *
+ *  Description:
+ *      Find the member having the given key.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member to find.
+ *
+ *  Returns:
+ *      A pointer to the member's JSON value or nullptr if there is no such
+ *      member.
+ *
+ *  Comments:
+ *      None.
+ */
+JSON *JSONObject::Find(const std::u8string_view key)
+{
+    auto it = value.find(key);
+
+    return (it == value.end()) ? nullptr : &it->second;
+}
+
+/*
+ *  JSONObject::Find()
+ *
+ *  Description:
+ *      Find the member having the given key.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member to find.
+ *
+ *  Returns:
+ *      A pointer to the member's JSON value or nullptr if there is no such
+ *      member.
+ *
+ *  Comments:
+ *      None.
+ */
+const JSON *JSONObject::Find(const std::u8string_view key) const
+{
+    auto it = value.find(key);
+
+    return (it == value.end()) ? nullptr : &it->second;
+}
+
+/*
+ *  JSONObject::Extract()
+ *
+ *  Description:
+ *      Remove the member having the given key from the object.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member to remove.
+ *
+ *  Returns:
+ *      A node owning the member's key and value, which is empty if there is
+ *      no such member.
+ *
+ *  Comments:
+ *      Neither the key nor the value is copied.
+ */
+JSONObjectMap::node_type JSONObject::Extract(const std::u8string_view key)
+{
+    auto it = value.find(key);
+
+    if (it == value.end()) return {};
+
+    return value.extract(it);
+}
+
+/*
+ *  JSONObject::Extract()
+ *
+ *  Description:
+ *      Remove the member having the given key from the object.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key of the member to remove.
+ *
+ *  Returns:
+ *      A node owning the member's key and value, which is empty if there is
+ *      no such member.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONObjectMap::node_type JSONObject::Extract(const JSONKey &key)
+{
+    return Extract(key.View());
+}
+
 /*
  *  JSONObject::ToString()
  *
@@ -0,0 +1,878 @@
+/*
+ *  json_offset_index.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the JSONOffsetIndex object.
+ *
+ *      The index file is a sequence of 64-bit unsigned integers in the byte
+ *      order of the machine that wrote it:
+ *
+ *          Header:  magic, version, layout, flags, data size, number of
+ *                   values, number of members
+ *          Values:  offset and length of each value
+ *          Members: (only if members are indexed) the position of the first
+ *                   member of each value followed by the total number of
+ *                   members, then the offset and length of the name (without
+ *                   quotes) and the offset and length of the value of each
+ *                   member
+ *
+ *      Each value requires 16 octets, and each member another 32 octets.
+ *
+ *  Portability Issues:
+ *      Files are mapped into memory on POSIX systems.  Elsewhere, the files
+ *      are read into memory instead.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TERRA_JSON_MMAP
+#endif
+#include <terra/json/json_offset_index.h>
+#include "json_scan.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Values in the index file header
+constexpr std::uint64_t Index_Magic = 0x5844'4e49'4e4f'534a;
+constexpr std::uint64_t Index_Version = 1;
+constexpr std::uint64_t Index_Members = 0x01;
+constexpr std::size_t Header_Words = 7;
+constexpr std::size_t Value_Words = 2;
+constexpr std::size_t Member_Words = 4;
+
+/*
+ *  MapFile()
+ *
+ *  Description:
+ *      Make the content of the given file available in memory.
+ *
+ *  Parameters:
+ *      path [in]
+ *          The path of the file to map.
+ *
+ *      content [out]
+ *          The content of the file.
+ *
+ *  Returns:
+ *      An object that owns the memory holding the content, which remains
+ *      valid until the object is destroyed.
+ *
+ *  Comments:
+ *      Files are mapped into memory where possible and are otherwise read
+ *      into memory.  Empty files are not mapped.
+ */
+std::shared_ptr<const void> MapFile(const std::filesystem::path &path,
+                                    std::u8string_view &content)
+{
+    content = {};
+
+#ifdef TERRA_JSON_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw JSONException("Unable to open file " + path.string());
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        throw JSONException("Unable to determine size of " + path.string());
+    }
+
+    std::size_t size = static_cast<std::size_t>(status.st_size);
+    if (size == 0)
+    {
+        close(fd);
+        return {};
+    }
+
+    void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        throw JSONException("Unable to map file " + path.string());
+    }
+
+    content = {static_cast<const char8_t *>(address), size};
+
+    return {address, [size](const void *p) {
+                munmap(const_cast<void *>(p), size);
+            }};
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw JSONException("Unable to open file " + path.string());
+
+    auto buffer = std::make_shared<std::vector<char8_t>>(
+        static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(buffer->data()),
+                   static_cast<std::streamsize>(buffer->size())))
+    {
+        throw JSONException("Unable to read file " + path.string());
+    }
+
+    content = {buffer->data(), buffer->size()};
+
+    return buffer;
+#endif
+}
+
+// Builder that locates the values within a JSON file
+class OffsetIndexBuilder
+{
+    public:
+        OffsetIndexBuilder(std::u8string_view content, bool index_members) :
+            begin{content.data()},
+            q{content.data() + content.size()},
+            index_members{index_members}
+        {
+        }
+        ~OffsetIndexBuilder() = default;
+
+        void IndexArray();
+        void IndexLines();
+        void Write(const std::filesystem::path &index_file,
+                   JSONOffsetIndex::Layout layout) const;
+
+    protected:
+        const char8_t *SkipWhitespace(const char8_t *p) const;
+        const char8_t *SkipValue(const char8_t *p) const;
+        void AddValue(const char8_t *start, const char8_t *end);
+        void IndexMembers(const char8_t *p, const char8_t *end);
+        void AddExtent(std::vector<std::uint64_t> &words,
+                       const char8_t *start,
+                       const char8_t *end) const;
+        [[noreturn]] void Fail(const char *text, const char8_t *p) const;
+
+        const char8_t *begin;                   // Start of content
+        const char8_t *q;                       // One past end of content
+        bool index_members;                     // Index members of objects
+        std::vector<std::uint64_t> values;      // Offsets and lengths
+        std::vector<std::uint64_t> firsts;      // First member of values
+        std::vector<std::uint64_t> members;     // Member names and values
+};
+
+/*
+ *  OffsetIndexBuilder::IndexArray()
+ *
+ *  Description:
+ *      Locate the elements of the array that is the content.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the content is not an array.
+ *
+ *  Comments:
+ *      None.
+ */
+void OffsetIndexBuilder::IndexArray()
+{
+    const char8_t *p = SkipWhitespace(begin);
+
+    if ((p >= q) || (*p != '[')) Fail("Expected an array", p);
+
+    p = SkipWhitespace(p + 1);
+    if ((p < q) && (*p == ']'))
+    {
+        p++;
+    }
+    else
+    {
+        while (true)
+        {
+            const char8_t *end = SkipValue(p);
+            AddValue(p, end);
+
+            p = SkipWhitespace(end);
+            if ((p < q) && (*p == ','))
+            {
+                p = SkipWhitespace(p + 1);
+                continue;
+            }
+            if ((p < q) && (*p == ']'))
+            {
+                p++;
+                break;
+            }
+            Fail("Expected ',' or ']'", p);
+        }
+    }
+
+    p = SkipWhitespace(p);
+    if (p < q) Fail("Unexpected content following the array", p);
+}
+
+/*
+ *  OffsetIndexBuilder::IndexLines()
+ *
+ *  Description:
+ *      Locate the values within the content, which has one value per line.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if a line holds more than one
+ *      value.
+ *
+ *  Comments:
+ *      Lines that hold only whitespace are ignored.
+ */
+void OffsetIndexBuilder::IndexLines()
+{
+    const char8_t *p = begin;
+
+    while (p < q)
+    {
+        const char8_t *line_end =
+            static_cast<const char8_t *>(std::memchr(p, '\n', q - p));
+        if (line_end == nullptr) line_end = q;
+
+        // Trim whitespace from either end of the line
+        while ((p < line_end) &&
+               ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+        {
+            p++;
+        }
+        const char8_t *end = line_end;
+        while ((end > p) &&
+               ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\r')))
+        {
+            end--;
+        }
+
+        if (p < end)
+        {
+            if (SkipValue(p) != end) Fail("Expected one value per line", p);
+            AddValue(p, end);
+        }
+
+        p = line_end + ((line_end < q) ? 1 : 0);
+    }
+}
+
+/*
+ *  OffsetIndexBuilder::Write()
+ *
+ *  Description:
+ *      Write the index file.
+ *
+ *  Parameters:
+ *      index_file [in]
+ *          The path of the index file to write.
+ *
+ *      layout [in]
+ *          The arrangement of values within the content.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the file cannot be written.
+ *
+ *  Comments:
+ *      None.
+ */
+void OffsetIndexBuilder::Write(const std::filesystem::path &index_file,
+                               JSONOffsetIndex::Layout layout) const
+{
+    std::uint64_t header[Header_Words] =
+    {
+        Index_Magic,
+        Index_Version,
+        static_cast<std::uint64_t>(layout),
+        index_members ? Index_Members : 0,
+        static_cast<std::uint64_t>(q - begin),
+        values.size() / Value_Words,
+        members.size() / Member_Words
+    };
+
+    std::ofstream file(index_file, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw JSONException("Unable to create file " + index_file.string());
+    }
+
+    auto write = [&](const std::uint64_t *words, std::size_t count)
+    {
+        file.write(reinterpret_cast<const char *>(words),
+                   static_cast<std::streamsize>(count * sizeof(*words)));
+    };
+
+    write(header, Header_Words);
+    write(values.data(), values.size());
+    if (index_members)
+    {
+        write(firsts.data(), firsts.size());
+        std::uint64_t total = members.size() / Member_Words;
+        write(&total, 1);
+        write(members.data(), members.size());
+    }
+
+    if (!file.flush())
+    {
+        throw JSONException("Unable to write file " + index_file.string());
+    }
+}
+
+/*
+ *  OffsetIndexBuilder::SkipWhitespace()
+ *
+ *  Description:
+ *      Move past any whitespace at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position within the content.
+ *
+ *  Returns:
+ *      The position of the first character that is not whitespace.
+ *
+ *  Comments:
+ *      None.
+ */
+const char8_t *OffsetIndexBuilder::SkipWhitespace(const char8_t *p) const
+{
+    while ((p < q) &&
+           ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n')))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+/*
+ *  OffsetIndexBuilder::SkipValue()
+ *
+ *  Description:
+ *      Move past the value that starts at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the value.
+ *
+ *  Returns:
+ *      The position one past the end of the value.  A JSONException is
+ *      thrown if the value does not end.
+ *
+ *  Comments:
+ *      Objects and arrays are examined only to find their end, and other
+ *      values extend to the next delimiter.
+ */
+const char8_t *OffsetIndexBuilder::SkipValue(const char8_t *p) const
+{
+    const char8_t *end = FindValueEnd(p, q);
+
+    if (end == nullptr) Fail("Expected a value", p);
+
+    return end;
+}
+
+/*
+ *  OffsetIndexBuilder::AddValue()
+ *
+ *  Description:
+ *      Record the location of a top-level value and, if requested and the
+ *      value is an object, the location of its members.
+ *
+ *  Parameters:
+ *      start [in]
+ *          The position of the value.
+ *
+ *      end [in]
+ *          The position one past the end of the value.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void OffsetIndexBuilder::AddValue(const char8_t *start, const char8_t *end)
+{
+    AddExtent(values, start, end);
+
+    if (!index_members) return;
+
+    firsts.push_back(members.size() / Member_Words);
+    if (*start == '{') IndexMembers(start, end);
+}
+
+/*
+ *  OffsetIndexBuilder::IndexMembers()
+ *
+ *  Description:
+ *      Record the location of the name and value of each member of the
+ *      object at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the object's opening brace.
+ *
+ *      end [in]
+ *          The position one past the object's closing brace.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if a member is malformed.
+ *
+ *  Comments:
+ *      None.
+ */
+void OffsetIndexBuilder::IndexMembers(const char8_t *p, const char8_t *end)
+{
+    p = SkipWhitespace(p + 1);
+    if ((p < end) && (*p == '}')) return;
+
+    while (p < end)
+    {
+        if (*p != '"') Fail("Expected a member name", p);
+        const char8_t *name_end = SkipValue(p);
+        AddExtent(members, p + 1, name_end - 1);
+
+        p = SkipWhitespace(name_end);
+        if ((p >= end) || (*p != ':')) Fail("Expected ':'", p);
+
+        p = SkipWhitespace(p + 1);
+        const char8_t *value_end = SkipValue(p);
+        AddExtent(members, p, value_end);
+
+        p = SkipWhitespace(value_end);
+        if ((p < end) && (*p == ','))
+        {
+            p = SkipWhitespace(p + 1);
+            continue;
+        }
+        if ((p < end) && (*p == '}')) return;
+        Fail("Expected ',' or '}'", p);
+    }
+
+    Fail("Expected a member name", p);
+}
+
+/*
+ *  OffsetIndexBuilder::AddExtent()
+ *
+ *  Description:
+ *      Append the offset and length of a span of the content.
+ *
+ *  Parameters:
+ *      words [in/out]
+ *          The vector to which the offset and length are appended.
+ *
+ *      start [in]
+ *          The position of the span.
+ *
+ *      end [in]
+ *          The position one past the end of the span.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void OffsetIndexBuilder::AddExtent(std::vector<std::uint64_t> &words,
+                                   const char8_t *start,
+                                   const char8_t *end) const
+{
+    words.push_back(static_cast<std::uint64_t>(start - begin));
+    words.push_back(static_cast<std::uint64_t>(end - start));
+}
+
+/*
+ *  OffsetIndexBuilder::Fail()
+ *
+ *  Description:
+ *      Report an error found while indexing.
+ *
+ *  Parameters:
+ *      text [in]
+ *          A description of the error.
+ *
+ *      p [in]
+ *          The position at which the error was found.
+ *
+ *  Returns:
+ *      Does not return, as a JSONException is thrown.
+ *
+ *  Comments:
+ *      None.
+ */
+void OffsetIndexBuilder::Fail(const char *text, const char8_t *p) const
+{
+    throw JSONException(std::string(text) + " at offset " +
+                        std::to_string(p - begin));
+}
+
+} // namespace
+
+/*
+ *  JSONOffsetIndex::JSONOffsetIndex()
+ *
+ *  Description:
+ *      Constructor for the JSONOffsetIndex, which maps the given data file
+ *      and the index file previously built for it.
+ *
+ *  Parameters:
+ *      data_file [in]
+ *          The path of the JSON file.
+ *
+ *      index_file [in]
+ *          The path of the index file produced by Build().
+ *
+ *      options [in]
+ *          The options used to parse values.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if either file cannot be mapped
+ *      or if the index file is invalid or does not match the data file.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONOffsetIndex::JSONOffsetIndex(const std::filesystem::path &data_file,
+                                 const std::filesystem::path &index_file,
+                                 const ParserOptions &options) :
+    options{options},
+    layout{Layout::Array},
+    members_indexed{false},
+    elements{0},
+    members{0}
+{
+    data_map = MapFile(data_file, data);
+    index_map = MapFile(index_file, index);
+
+    // Verify the header
+    if ((index.size() < Header_Words * sizeof(std::uint64_t)) ||
+        (index.size() % sizeof(std::uint64_t) != 0) ||
+        (ReadIndex(0) != Index_Magic) ||
+        (ReadIndex(1) != Index_Version))
+    {
+        throw JSONException("Invalid index file " + index_file.string());
+    }
+    if (ReadIndex(4) != data.size())
+    {
+        throw JSONException("Index file " + index_file.string() +
+                            " does not match " + data_file.string());
+    }
+
+    std::uint64_t words = index.size() / sizeof(std::uint64_t);
+    std::uint64_t value_count = ReadIndex(5);
+    std::uint64_t member_count = ReadIndex(6);
+
+    layout = static_cast<Layout>(ReadIndex(2));
+    members_indexed = (ReadIndex(3) & Index_Members) != 0;
+
+    // Verify the index file holds exactly the values and members
+    bool valid = (value_count <= words / Value_Words) &&
+                 (member_count <= words / Member_Words);
+    if (valid)
+    {
+        std::uint64_t expected = Header_Words + (value_count * Value_Words);
+        if (members_indexed)
+        {
+            expected += value_count + 1 + (member_count * Member_Words);
+        }
+        valid = (expected == words);
+    }
+    if (!valid)
+    {
+        throw JSONException("Invalid index file " + index_file.string());
+    }
+
+    elements = static_cast<std::size_t>(value_count);
+    members = static_cast<std::size_t>(member_count);
+}
+
+/*
+ *  JSONOffsetIndex::Build()
+ *
+ *  Description:
+ *      Build the index file for the given JSON file.
+ *
+ *  Parameters:
+ *      data_file [in]
+ *          The path of the JSON file to index.
+ *
+ *      index_file [in]
+ *          The path of the index file to write.
+ *
+ *      layout [in]
+ *          The arrangement of values within the JSON file.
+ *
+ *      index_members [in]
+ *          True if the members of values that are objects should also be
+ *          indexed, allowing them to be accessed individually.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the file is not arranged as
+ *      indicated or if either file cannot be accessed.
+ *
+ *  Comments:
+ *      The data file is examined once, from start to end.
+ */
+void JSONOffsetIndex::Build(const std::filesystem::path &data_file,
+                            const std::filesystem::path &index_file,
+                            Layout layout,
+                            bool index_members)
+{
+    std::u8string_view content;
+    std::shared_ptr<const void> content_map = MapFile(data_file, content);
+
+    OffsetIndexBuilder builder(content, index_members);
+
+    if (layout == Layout::Array)
+    {
+        builder.IndexArray();
+    }
+    else
+    {
+        builder.IndexLines();
+    }
+
+    builder.Write(index_file, layout);
+}
+
+/*
+ *  JSONOffsetIndex::Text()
+ *
+ *  Description:
+ *      Return the JSON text of the value at the given position.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the value (the array index or the number of the
+ *          line, excluding blank lines).
+ *
+ *  Returns:
+ *      The JSON text of the value, which remains valid for the lifetime of
+ *      this object.  A std::out_of_range exception is thrown if there is no
+ *      value at the given position.
+ *
+ *  Comments:
+ *      None.
+ */
+std::u8string_view JSONOffsetIndex::Text(std::size_t position) const
+{
+    if (position >= elements)
+    {
+        throw std::out_of_range("JSONOffsetIndex position out of range");
+    }
+
+    return Extent(Header_Words + (position * Value_Words));
+}
+
+/*
+ *  JSONOffsetIndex::Get()
+ *
+ *  Description:
+ *      Parse the value at the given position.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the value.
+ *
+ *  Returns:
+ *      The parsed value.  A std::out_of_range exception is thrown if there is
+ *      no value at the given position, and a JSONException is thrown if the
+ *      value is malformed.
+ *
+ *  Comments:
+ *      Only the requested value is parsed.
+ */
+JSON JSONOffsetIndex::Get(std::size_t position) const
+{
+    return JSONParser(options).Parse(Text(position));
+}
+
+/*
+ *  JSONOffsetIndex::MemberText()
+ *
+ *  Description:
+ *      Return the JSON text of the value of the named member of the object
+ *      at the given position.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the object.
+ *
+ *      name [in]
+ *          The name of the member.
+ *
+ *  Returns:
+ *      The JSON text of the member's value, or an empty view if the value
+ *      at the given position is not an object or has no such member.  A
+ *      std::out_of_range exception is thrown if there is no value at the
+ *      given position, and a JSONException is thrown if members were not
+ *      indexed.
+ *
+ *  Comments:
+ *      The object's members are examined in the order they appear.  Names
+ *      that contain escape sequences are decoded before being compared.
+ */
+std::u8string_view JSONOffsetIndex::MemberText(
+                                        std::size_t position,
+                                        const std::u8string_view name) const
+{
+    if (position >= elements)
+    {
+        throw std::out_of_range("JSONOffsetIndex position out of range");
+    }
+    if (!members_indexed)
+    {
+        throw JSONException("Members were not indexed");
+    }
+
+    std::size_t firsts = Header_Words + (elements * Value_Words);
+    std::size_t base = firsts + elements + 1;
+    std::uint64_t first = ReadIndex(firsts + position);
+    std::uint64_t last = ReadIndex(firsts + position + 1);
+
+    if ((first > last) || (last > members)) return {};
+
+    for (std::uint64_t member = first; member < last; member++)
+    {
+        std::size_t word = base + static_cast<std::size_t>(member) *
+                                      Member_Words;
+        if (StringEquals(Extent(word), name)) return Extent(word + 2);
+    }
+
+    return {};
+}
+
+/*
+ *  JSONOffsetIndex::GetMember()
+ *
+ *  Description:
+ *      Parse the value of the named member of the object at the given
+ *      position.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the object.
+ *
+ *      name [in]
+ *          The name of the member.
+ *
+ *  Returns:
+ *      The parsed value of the member.  A JSONException is thrown if the
+ *      member does not exist or members were not indexed.
+ *
+ *  Comments:
+ *      Only the member's value is parsed.
+ */
+JSON JSONOffsetIndex::GetMember(std::size_t position,
+                                const std::u8string_view name) const
+{
+    std::u8string_view text = MemberText(position, name);
+
+    if (text.empty()) throw JSONException("Member not found");
+
+    return JSONParser(options).Parse(text);
+}
+
+/*
+ *  JSONOffsetIndex::GetMember()
+ *
+ *  Description:
+ *      Parse the value of the named member of the object at the given
+ *      position.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the object.
+ *
+ *      name [in]
+ *          The name of the member.
+ *
+ *  Returns:
+ *      The parsed value of the member.  A JSONException is thrown if the
+ *      member does not exist or members were not indexed.
+ *
+ *  Comments:
+ *      None.
+ */
+JSON JSONOffsetIndex::GetMember(std::size_t position,
+                                const std::string_view name) const
+{
+    return GetMember(position,
+                     std::u8string_view(
+                         reinterpret_cast<const char8_t *>(name.data()),
+                         name.size()));
+}
+
+/*
+ *  JSONOffsetIndex::ReadIndex()
+ *
+ *  Description:
+ *      Read the word at the given position within the index file.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the 64-bit word to read.
+ *
+ *  Returns:
+ *      The value of the word.
+ *
+ *  Comments:
+ *      The word is copied, as the index file content might not be aligned.
+ */
+std::uint64_t JSONOffsetIndex::ReadIndex(std::size_t position) const
+{
+    std::uint64_t word;
+
+    std::memcpy(&word,
+                index.data() + (position * sizeof(std::uint64_t)),
+                sizeof(word));
+
+    return word;
+}
+
+/*
+ *  JSONOffsetIndex::Extent()
+ *
+ *  Description:
+ *      Return the span of the data file described by the offset and length
+ *      at the given position within the index file.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the offset within the index file.
+ *
+ *  Returns:
+ *      The span of the data file.  A JSONException is thrown if the span
+ *      lies outside of the data file.
+ *
+ *  Comments:
+ *      None.
+ */
+std::u8string_view JSONOffsetIndex::Extent(std::size_t position) const
+{
+    std::uint64_t offset = ReadIndex(position);
+    std::uint64_t length = ReadIndex(position + 1);
+
+    if ((offset > data.size()) || (length > data.size() - offset))
+    {
+        throw JSONException("Index file does not match the data file");
+    }
+
+    return data.substr(static_cast<std::size_t>(offset),
+                       static_cast<std::size_t>(length));
+}
+
+} // namespace Terra::JSON
@@ -0,0 +1,327 @@
+/*
+ *  json_parse_cache.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the JSONParseCache object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cstring>
+#include <iterator>
+#include <terra/json/json_parse_cache.h>
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+/*
+ *  Mix()
+ *
+ *  Description:
+ *      Thoroughly mix the bits of the given value.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The value to mix.
+ *
+ *  Returns:
+ *      The mixed value.
+ *
+ *  Comments:
+ *      This is the finalizer of the SplitMix64 generator.
+ */
+constexpr std::uint64_t Mix(std::uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xbf58'476d'1ce4'e5b9;
+    value = (value ^ (value >> 27)) * 0x94d0'49bb'1331'11eb;
+
+    return value ^ (value >> 31);
+}
+
+/*
+ *  HashContent()
+ *
+ *  Description:
+ *      Compute a 64-bit hash of the given text.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The text to hash.
+ *
+ *  Returns:
+ *      The hash of the text.
+ *
+ *  Comments:
+ *      This is a fast, non-cryptographic hash that consumes eight octets
+ *      at a time.  Since the hash is not secure, cached text is always
+ *      compared with the text being parsed.
+ */
+std::uint64_t HashContent(const std::u8string_view content)
+{
+    const char8_t *p = content.data();
+    std::size_t remaining = content.size();
+    std::uint64_t hash = Mix(remaining ^ 0x9e37'79b9'7f4a'7c15);
+    std::uint64_t word;
+
+    while (remaining >= sizeof(word))
+    {
+        std::memcpy(&word, p, sizeof(word));
+        hash = (hash ^ Mix(word)) * 0x9e37'79b9'7f4a'7c15;
+        p += sizeof(word);
+        remaining -= sizeof(word);
+    }
+
+    if (remaining > 0)
+    {
+        word = 0;
+        std::memcpy(&word, p, remaining);
+        hash = (hash ^ Mix(word)) * 0x9e37'79b9'7f4a'7c15;
+    }
+
+    return Mix(hash);
+}
+
+} // namespace
+
+/*
+ *  JSONParseCache::JSONParseCache()
+ *
+ *  Description:
+ *      Constructor for the JSONParseCache.
+ *
+ *  Parameters:
+ *      capacity [in]
+ *          The maximum number of documents to hold.  If zero, no documents
+ *          are cached.
+ *
+ *      options [in]
+ *          The options used to parse documents.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The lazy option is ignored, as cached documents are shared.
+ */
+JSONParseCache::JSONParseCache(std::size_t capacity,
+                               const ParserOptions &options) :
+    capacity{capacity},
+    options{options}
+{
+    this->options.lazy = false;
+}
+
+/*
+ *  JSONParseCache::Parse()
+ *
+ *  Description:
+ *      Parse the given JSON text, returning the cached document if the same
+ *      text was parsed previously.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text to parse.
+ *
+ *  Returns:
+ *      The parsed document, which is shared and must not be modified.  A
+ *      JSONException is thrown if the text cannot be parsed.
+ *
+ *  Comments:
+ *      None.
+ */
+std::shared_ptr<const JSON> JSONParseCache::Parse(
+                                            const std::string_view content)
+{
+    return Parse(std::u8string_view(
+                    reinterpret_cast<const char8_t *>(content.data()),
+                    content.size()));
+}
+
+/*
+ *  JSONParseCache::Parse()
+ *
+ *  Description:
+ *      Parse the given JSON text, returning the cached document if the same
+ *      text was parsed previously.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The JSON text to parse.
+ *
+ *  Returns:
+ *      The parsed document, which is shared and must not be modified.  A
+ *      JSONException is thrown if the text cannot be parsed.
+ *
+ *  Comments:
+ *      The text is parsed without holding the lock, so threads parsing
+ *      different text do not wait for one another.  If two threads parse
+ *      the same text concurrently, the first document cached is returned
+ *      to both.
+ */
+std::shared_ptr<const JSON> JSONParseCache::Parse(
+                                            const std::u8string_view content)
+{
+    std::uint64_t hash = HashContent(content);
+
+    // Return the cached document, if any
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto entry = Find(hash, content);
+        if (entry != entries.end())
+        {
+            statistics.hits++;
+            entries.splice(entries.begin(), entries, entry);
+            return entry->json;
+        }
+
+        statistics.misses++;
+    }
+
+    auto json = std::make_shared<const JSON>(
+                                        JSONParser(options).Parse(content));
+
+    if (capacity == 0) return json;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Another thread might have cached the same document
+    auto entry = Find(hash, content);
+    if (entry != entries.end()) return entry->json;
+
+    // Evict the least recently used document if the cache is full
+    if (entries.size() >= capacity)
+    {
+        auto last = std::prev(entries.end());
+        auto [first, end] = lookup.equal_range(last->hash);
+        for (auto it = first; it != end; ++it)
+        {
+            if (it->second == last)
+            {
+                lookup.erase(it);
+                break;
+            }
+        }
+        entries.pop_back();
+        statistics.evictions++;
+    }
+
+    entries.push_front({hash, std::u8string(content), json});
+    lookup.emplace(hash, entries.begin());
+
+    return json;
+}
+
+/*
+ *  JSONParseCache::GetStatistics()
+ *
+ *  Description:
+ *      Return counters describing the use of the cache.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A copy of the counters.
+ *
+ *  Comments:
+ *      None.
+ */
+JSONParseCacheStatistics JSONParseCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return statistics;
+}
+
+/*
+ *  JSONParseCache::Size()
+ *
+ *  Description:
+ *      Return the number of documents cached.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of documents cached.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t JSONParseCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return entries.size();
+}
+
+/*
+ *  JSONParseCache::Clear()
+ *
+ *  Description:
+ *      Remove all documents from the cache.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The statistics are not reset.  Documents held by callers remain
+ *      valid.
+ */
+void JSONParseCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    lookup.clear();
+    entries.clear();
+}
+
+/*
+ *  JSONParseCache::Find()
+ *
+ *  Description:
+ *      Find the cache entry for the given text.
+ *
+ *  Parameters:
+ *      hash [in]
+ *          The hash of the text.
+ *
+ *      content [in]
+ *          The text.
+ *
+ *  Returns:
+ *      The entry, or entries.end() if the text is not cached.
+ *
+ *  Comments:
+ *      The lock must be held by the caller.
+ */
+JSONParseCache::EntryList::iterator JSONParseCache::Find(
+                                            std::uint64_t hash,
+                                            const std::u8string_view content)
+{
+    auto [first, end] = lookup.equal_range(hash);
+
+    for (auto it = first; it != end; ++it)
+    {
+        if (it->second->content == content) return it->second;
+    }
+
+    return entries.end();
+}
+
+} // namespace Terra::JSON
@@ -21,6 +21,8 @@
 #include <sstream>
 #endif
 #include <terra/json/json.h>
+#include "json_scan.h"
+#include "json_transcode.h"
 #include "unicode_constants.h"
 
 namespace Terra::JSON
@@ -173,6 +175,56 @@ JSON JSONParser::Parse(const std::string_view content)
                            content.length()));
 }
 
+/*
+ *  JSONParser::Parse()
+ *
+ *  Description:
+ *      Function to parse the given UTF-16 text and return a JSON object.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The UTF-16 text to parse, which may begin with a byte order mark.
+ *          If the byte order mark indicates that the order of octets within
+ *          each code unit is reversed, the order is corrected.
+ *
+ *  Returns:
+ *      A JSON object containing the parsed JSON content.  If there is an
+ *      error transcoding or parsing the content, an exception will be
+ *      thrown.
+ *
+ *  Comments:
+ *      The text is transcoded to UTF-8 in a single pass before parsing.
+ */
+JSON JSONParser::Parse(const std::u16string_view content)
+{
+    return Parse(std::u8string_view(TranscodeToUTF8(content)));
+}
+
+/*
+ *  JSONParser::Parse()
+ *
+ *  Description:
+ *      Function to parse the given UTF-32 text and return a JSON object.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The UTF-32 text to parse, which may begin with a byte order mark.
+ *          If the byte order mark indicates that the order of octets within
+ *          each code unit is reversed, the order is corrected.
+ *
+ *  Returns:
+ *      A JSON object containing the parsed JSON content.  If there is an
+ *      error transcoding or parsing the content, an exception will be
+ *      thrown.
+ *
+ *  Comments:
+ *      The text is transcoded to UTF-8 in a single pass before parsing.
+ */
+JSON JSONParser::Parse(const std::u32string_view content)
+{
+    return Parse(std::u8string_view(TranscodeToUTF8(content)));
+}
+
 /*
  *  JSONParser::Parse()
  *
@@ -194,6 +246,30 @@ JSON JSONParser::Parse(const std::string_view content)
  */
 JSON JSONParser::Parse(const std::u8string_view content)
 {
+    // This is not a preview
+    preview = nullptr;
+
+    // Ensure the content does not exceed the maximum document size
+    if (content.size() > options.max_document_size)
+    {
+        throw JSONException("The content exceeds the maximum document size");
+    }
+
+    // If parsing lazily, verify the content is well-formed and within the
+    // limits; if not, it is parsed below so that the error is reported as
+    // usual
+    if (options.lazy)
+    {
+        JSONScanner scanner({.number_range = true,
+                             .unique_names = true,
+                             .max_depth = options.max_depth,
+                             .max_values = options.max_values,
+                             .max_string_length = options.max_string_length,
+                             .max_members = options.max_members,
+                             .max_elements = options.max_elements});
+        if (scanner.Scan(content)) return ParseDeferred(content);
+    }
+
     // Ensure the content is not empty
     if (content.empty()) throw JSONException("The content string is empty");
 
@@ -202,6 +278,8 @@ JSON JSONParser::Parse(const std::u8string_view content)
     q = content.data() + content.size();
     line = 0;
     column = 0;
+    depth = 0;
+    values = 0;
 
     // Skip over whitespace
     ConsumeWhitespace();
@@ -212,9 +290,124 @@ JSON JSONParser::Parse(const std::u8string_view content)
         throw JSONException("The content string contains only whitespace");
     }
 
+    // Learn the number of elements in each array so storage for each can
+    // be allocated exactly once
+    IndexArraySizes();
+
     // Create a JSON object holding the expected type
     JSON json(ParseValue(DetermineValueType()));
 
+    // Release the array size index, as it is no longer needed
+    array_sizes.clear();
+
+    // Consume any trailing whitespace
+    ConsumeWhitespace();
+
+    // Ensure all input is consumed
+    if (!EndOfInput())
+    {
+        throw JSONException(
+            ParsingErrorString(line, column, "Unexpected character"));
+    }
+
+    return json;
+}
+
+/*
+ *  JSONParser::Preview()
+ *
+ *  Description:
+ *      Function to parse the beginning of the given input span within the
+ *      given budgets and return a JSON object.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The content to parse when generating a JSON object.  The content
+ *          is assumed to be UTF-8 text.
+ *
+ *      budget [in]
+ *          Budgets that limit the content to parse.
+ *
+ *  Returns:
+ *      A JSON object containing the parsed JSON content.  If there is an
+ *      error parsing the content, an exception will be thrown.
+ *
+ *  Comments:
+ *      None.
+ */
+JSON JSONParser::Preview(const std::string_view content,
+                         const PreviewOptions &budget)
+{
+    return Preview(
+        std::u8string_view(reinterpret_cast<const char8_t *>(content.data()),
+                           content.length()),
+        budget);
+}
+
+/*
+ *  JSONParser::Preview()
+ *
+ *  Description:
+ *      Function to parse the beginning of the given input span within the
+ *      given budgets and return a JSON object.  Array elements, object
+ *      members, nested objects and arrays, and portions of strings beyond
+ *      the budget are skipped and replaced with the PreviewOptions::Elision
+ *      marker.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The content to parse when generating a JSON object.  The content
+ *          is assumed to be UTF-8 text.
+ *
+ *      budget [in]
+ *          Budgets that limit the content to parse.
+ *
+ *  Returns:
+ *      A JSON object containing the parsed JSON content.  If there is an
+ *      error parsing the content, an exception will be thrown.
+ *
+ *  Comments:
+ *      Skipped content is only examined to find the end of the strings,
+ *      objects, and arrays containing it and is otherwise not verified.
+ *      The limits in ParserOptions also apply, though lazy parsing does not.
+ */
+JSON JSONParser::Preview(const std::u8string_view content,
+                         const PreviewOptions &budget)
+{
+    JSON json(JSONValueType::Literal);
+
+    // Ensure the content does not exceed the maximum document size
+    if (content.size() > options.max_document_size)
+    {
+        throw JSONException("The content exceeds the maximum document size");
+    }
+
+    // Ensure the content is not empty
+    if (content.empty()) throw JSONException("The content string is empty");
+
+    // Initialize the parsing context variables
+    p = content.data();
+    q = content.data() + content.size();
+    line = 0;
+    column = 0;
+    depth = 0;
+    values = 0;
+    array_sizes.clear();
+    array_index = 0;
+    preview = &budget;
+
+    // Skip over whitespace
+    ConsumeWhitespace();
+
+    // Ensure there is still data to consider
+    if (EndOfInput())
+    {
+        throw JSONException("The content string contains only whitespace");
+    }
+
+    // Parse the value within the budget
+    ParseElement(json);
+
     // Consume any trailing whitespace
     ConsumeWhitespace();
 
@@ -225,6 +418,8 @@ JSON JSONParser::Parse(const std::u8string_view content)
             ParsingErrorString(line, column, "Unexpected character"));
     }
 
+    preview = nullptr;
+
     return json;
 }
 
@@ -268,6 +463,110 @@ void JSONParser::ConsumeWhitespace()
     }
 }
 
+/*
+ *  JSONParser::IndexArraySizes()
+ *
+ *  Description:
+ *      Perform a lightweight scan over the remaining input to determine the
+ *      number of elements held by each array.  The element counts are stored
+ *      in array_sizes in the order in which the opening brackets appear in
+ *      the input, which is the same order in which ParseArray() will be
+ *      called.  This allows ParseArray() to reserve storage exactly once.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This function does not validate the input and does not advance the
+ *      read position.  Syntax errors are detected and reported by the parsing
+ *      functions, which treat the collected sizes only as a hint.
+ */
+void JSONParser::IndexArraySizes()
+{
+    // Entry for each open array or object (Object_Index denotes an object)
+    struct Container
+    {
+        std::size_t index;
+        bool empty;
+    };
+    constexpr std::size_t Object_Index = static_cast<std::size_t>(-1);
+    std::vector<Container> open_containers;
+
+    // Initialize the array size index
+    array_sizes.clear();
+    array_index = 0;
+
+    // Iterate over the input, skipping over strings
+    for (const char8_t *r = p; r < q; r++)
+    {
+        // Whitespace does not affect element counts
+        if ((*r == ' ') || (*r == '\t') || (*r == '\r') || (*r == '\n'))
+        {
+            continue;
+        }
+
+        // Any other octet within an array indicates it is not empty
+        if (!open_containers.empty() && (*r != ']') && (*r != '}'))
+        {
+            open_containers.back().empty = false;
+        }
+
+        switch (*r)
+        {
+            case '"':
+                // Skip to the closing quote, stepping over escaped octets
+                for (r++; (r < q) && (*r != '"'); r++)
+                {
+                    if (*r == '\\') r++;
+                }
+                break;
+
+            case '[':
+                // Stop if the nesting is too deep; the parser will report it
+                if (open_containers.size() >= options.max_depth) return;
+                open_containers.push_back({array_sizes.size(), true});
+                array_sizes.push_back(0);
+                break;
+
+            case '{':
+                if (open_containers.size() >= options.max_depth) return;
+                open_containers.push_back({Object_Index, true});
+                break;
+
+            case ',':
+                // Each comma within an array introduces another element
+                if (!open_containers.empty() &&
+                    (open_containers.back().index != Object_Index))
+                {
+                    array_sizes[open_containers.back().index]++;
+                }
+                break;
+
+            case ']':
+                [[fallthrough]];
+
+            case '}':
+                // Stop if the input is malformed; the parser will report it
+                if (open_containers.empty()) return;
+
+                // A non-empty array has one more element than commas
+                if ((open_containers.back().index != Object_Index) &&
+                    !open_containers.back().empty)
+                {
+                    array_sizes[open_containers.back().index]++;
+                }
+                open_containers.pop_back();
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
 /*
  *  JSONParser::DetermineValueType()
  *
@@ -370,6 +669,15 @@ JSONValueType JSONParser::DetermineValueType() const
  */
 JSONValue JSONParser::ParseValue(JSONValueType value_type)
 {
+    // Ensure the maximum number of values is not exceeded
+    if (values++ >= options.max_values)
+    {
+        throw JSONException(ParsingErrorString(line,
+                                               column,
+                                               "Maximum number of values "
+                                               "exceeded"));
+    }
+
     // Each distinct type requires entirely different parsing logic
     switch (value_type)
     {
@@ -439,9 +747,68 @@ JSONString JSONParser::ParseString()
     // Advance the parsing position
     AdvanceReadPosition();
 
+    // Locate the closing quote, noting whether the string requires decoding;
+    // the search stops once the string exceeds the maximum length
+    const char8_t *r = p;
+    const char8_t *end = (RemainingInput() > options.max_string_length) ?
+                             p + options.max_string_length + 1 :
+                             q;
+    bool plain_text = true;
+    while ((r < end) && (*r != '"'))
+    {
+        if ((*r == '\\') || (*r < 0x20))
+        {
+            plain_text = false;
+            if ((*r == '\\') && (q - r > 1)) r++;
+        }
+        r++;
+    }
+
+    // Ensure the string does not exceed the maximum length
+    if (static_cast<std::size_t>(r - p) > options.max_string_length)
+    {
+        throw JSONException(ParsingErrorString(line,
+                                               column,
+                                               "Maximum string length "
+                                               "exceeded"));
+    }
+
+    // When previewing, parse only the beginning of a long string
+    const char8_t *stop = q;
+    if ((preview != nullptr) && (r < q) &&
+        (static_cast<std::size_t>(r - p) > preview->max_string_length))
+    {
+        stop = p + preview->max_string_length;
+    }
+
+    // If no decoding is required, copy the string in one operation
+    if (plain_text && (r < q))
+    {
+        json_string.value.assign(p, std::min(r, stop));
+        if (stop < r)
+        {
+            TrimPartialCharacter(json_string.value);
+            json_string.value.append(PreviewOptions::Elision);
+        }
+        AdvanceReadPosition(r - p + 1);
+        return json_string;
+    }
+
+    // Escape sequences only shrink when decoded, so this is sufficient
+    json_string.value.reserve(r - p);
+
     // Everything else is a part of the string
     while (!EndOfInput())
     {
+        // Elide the remainder of a string exceeding the preview budget
+        if (!handle_escape && (p >= stop))
+        {
+            TrimPartialCharacter(json_string.value);
+            json_string.value.append(PreviewOptions::Elision);
+            AdvanceReadPosition(r - p + 1);
+            return json_string;
+        }
+
         // Control characters are not permitted in strings
         if (*p < 0x20)
         {
@@ -965,6 +1332,16 @@ JSONObject JSONParser::ParseObject()
             ParsingErrorString(line, column, "Expected leading brace"));
     }
 
+    // Ensure the maximum depth is not exceeded
+    if (depth >= options.max_depth)
+    {
+        throw JSONException(ParsingErrorString(line,
+                                               column,
+                                               "Maximum nesting depth "
+                                               "exceeded"));
+    }
+    depth++;
+
     // Advance the parsing position
     AdvanceReadPosition();
 
@@ -1014,6 +1391,27 @@ JSONObject JSONParser::ParseObject()
             }
         }
 
+        // When previewing, members beyond the budget are elided
+        if ((preview != nullptr) &&
+            (json_object.value.size() >= preview->max_members))
+        {
+            SkipElided();
+            json_object.value.try_emplace(
+                std::u8string(PreviewOptions::Elision),
+                JSONString(std::u8string(PreviewOptions::Elision)));
+            first_member_seen = true;
+            continue;
+        }
+
+        // Ensure the maximum number of members is not exceeded
+        if (json_object.value.size() >= options.max_members)
+        {
+            throw JSONException(ParsingErrorString(line,
+                                                   column,
+                                                   "Maximum number of object "
+                                                   "members exceeded"));
+        }
+
         // Determine the type of the initial value
         auto value_type = DetermineValueType();
 
@@ -1027,8 +1425,11 @@ JSONObject JSONParser::ParseObject()
         // Parse the string for the name value
         JSONString name = ParseString();
 
-        // Ensure this name is not already in use
-        if (json_object.HasKey(*name))
+        // Insert the name, ensuring it is not already in use
+        auto [member, inserted] = json_object.value.try_emplace(
+            std::move(*name),
+            JSONValueType::Literal);
+        if (!inserted)
         {
             throw JSONException(
                 ParsingErrorString(line, column, "Duplicate name"));
@@ -1057,7 +1458,7 @@ JSONObject JSONParser::ParseObject()
         if (EndOfInput()) break;
 
         // Parse the JSON value that follows, placing it into the map
-        json_object.value[*name] = ParseValue(DetermineValueType());
+        ParseElement(member->second);
 
         // Note that the first member was seen
         first_member_seen = true;
@@ -1070,6 +1471,8 @@ JSONObject JSONParser::ParseObject()
             ParsingErrorString(line, column, "Unexpected end of JSON object"));
     }
 
+    depth--;
+
     return json_object;
 }
 
@@ -1111,9 +1514,27 @@ JSONArray JSONParser::ParseArray()
             ParsingErrorString(line, column, "Expected leading bracket"));
     }
 
+    // Ensure the maximum depth is not exceeded
+    if (depth >= options.max_depth)
+    {
+        throw JSONException(ParsingErrorString(line,
+                                               column,
+                                               "Maximum nesting depth "
+                                               "exceeded"));
+    }
+    depth++;
+
     // Advance the parsing position
     AdvanceReadPosition();
 
+    // Reserve storage for the number of elements found by IndexArraySizes()
+    if (array_index < array_sizes.size())
+    {
+        json_array.value.reserve(
+            std::min(array_sizes[array_index], options.max_elements));
+    }
+    array_index++;
+
     // Everything else is a part of the JSON object
     while (!EndOfInput())
     {
@@ -1160,8 +1581,28 @@ JSONArray JSONParser::ParseArray()
             }
         }
 
-        // Parse the JSON value that follows, placing it into the map
-        json_array.value.emplace_back(ParseValue(DetermineValueType()));
+        // When previewing, elements beyond the budget are elided
+        if ((preview != nullptr) &&
+            (json_array.value.size() >= preview->max_elements))
+        {
+            SkipElided();
+            json_array.value.emplace_back(
+                JSONString(std::u8string(PreviewOptions::Elision)));
+            first_member_seen = true;
+            continue;
+        }
+
+        // Ensure the maximum number of elements is not exceeded
+        if (json_array.value.size() >= options.max_elements)
+        {
+            throw JSONException(ParsingErrorString(line,
+                                                   column,
+                                                   "Maximum number of array "
+                                                   "elements exceeded"));
+        }
+
+        // Parse the JSON value that follows, placing it into the array
+        ParseElement(json_array.value.emplace_back(JSONValueType::Literal));
 
         // Note that the first member was seen
         first_member_seen = true;
@@ -1174,6 +1615,8 @@ JSONArray JSONParser::ParseArray()
             ParsingErrorString(line, column, "Unexpected end of JSON array"));
     }
 
+    depth--;
+
     return json_array;
 }
 
@@ -1249,4 +1692,216 @@ JSONLiteral JSONParser::ParseLiteral()
         ParsingErrorString(line, column, "Unknown JSON literal"));
 }
 
+/*
+ *  JSONParser::ParseElement()
+ *
+ *  Description:
+ *      This function will parse the next value, which is a member of an
+ *      object or an element of an array, and assign it to the given JSON
+ *      object.  When parsing lazily, objects and arrays are not parsed, but
+ *      rather the position of their text is recorded.
+ *
+ *  Parameters:
+ *      json [out]
+ *          The JSON object to which the parsed value is assigned.
+ *
+ *  Returns:
+ *      Nothing.  An exception will be thrown if there is a parsing error.
+ *
+ *  Comments:
+ *      None.
+ */
+void JSONParser::ParseElement(JSON &json)
+{
+    JSONValueType value_type = DetermineValueType();
+
+    // Defer parsing of objects and arrays if parsing lazily
+    if (deferred_text && ((value_type == JSONValueType::Object) ||
+                          (value_type == JSONValueType::Array)))
+    {
+        std::size_t elements{};
+
+        json.AssignType(value_type);
+        json.annex.reset(new JSON::Annex{
+            std::shared_ptr<const char8_t>(deferred_text, p), {}});
+        AdvanceReadPosition(SkipContainer(p, elements) - p);
+
+        return;
+    }
+
+    // When previewing, objects and arrays beyond the maximum depth are
+    // elided, leaving only the elision marker within them
+    if ((preview != nullptr) && (depth >= preview->max_depth) &&
+        ((value_type == JSONValueType::Object) ||
+         (value_type == JSONValueType::Array)))
+    {
+        AdvanceReadPosition();
+        SkipElided();
+        AdvanceReadPosition();
+
+        JSONString elision(std::u8string(PreviewOptions::Elision));
+        if (value_type == JSONValueType::Object)
+        {
+            json = JSONObject{{std::u8string(PreviewOptions::Elision),
+                               elision}};
+        }
+        else
+        {
+            json = JSONArray{elision};
+        }
+
+        return;
+    }
+
+    json.value = ParseValue(value_type);
+}
+
+/*
+ *  JSONParser::SkipElided()
+ *
+ *  Description:
+ *      Skip over the remaining content of the object or array being parsed
+ *      when previewing, leaving the read position at its closing brace or
+ *      bracket.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.  An exception will be thrown if the end of the object or
+ *      array is not found.
+ *
+ *  Comments:
+ *      The skipped content is not verified.
+ */
+void JSONParser::SkipElided()
+{
+    const char8_t *end = FindContainerEnd(p, q);
+
+    if (end == q)
+    {
+        throw JSONException(ParsingErrorString(line,
+                                               column,
+                                               "Unexpected end of JSON text"));
+    }
+
+    AdvanceReadPosition(end - p);
+}
+
+/*
+ *  JSONParser::ParseDeferred()
+ *
+ *  Description:
+ *      Function to parse the given input span lazily, returning a JSON object
+ *      that parses objects and arrays as they are accessed.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The content to parse, which has been verified to be well-formed.
+ *
+ *  Returns:
+ *      A JSON object containing the parsed JSON content.
+ *
+ *  Comments:
+ *      A copy of the content is shared by the returned JSON object and any
+ *      JSON objects within it that have not been parsed.
+ */
+JSON JSONParser::ParseDeferred(const std::u8string_view content)
+{
+    JSON json(JSONValueType::Literal);
+
+    // Retain a copy of the content for parsing objects and arrays later
+    auto text = std::make_shared<const std::u8string>(content);
+
+    // Initialize the parsing context variables
+    p = text->data();
+    q = text->data() + text->size();
+    line = 0;
+    column = 0;
+    depth = 0;
+    values = 0;
+    deferred_text = std::shared_ptr<const char8_t>(text, text->data());
+
+    // Skip over whitespace
+    ConsumeWhitespace();
+
+    // Parse the value, deferring the parsing of any object or array
+    ParseElement(json);
+
+    deferred_text.reset();
+
+    return json;
+}
+
+/*
+ *  JSONParser::ExpandDeferred()
+ *
+ *  Description:
+ *      Parse the object or array whose parsing was deferred by the given JSON
+ *      object.  Objects and arrays within it are again deferred.
+ *
+ *  Parameters:
+ *      json [in/out]
+ *          The JSON object whose value is to be parsed.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The text was verified to be well-formed when first parsed.
+ */
+void JSONParser::ExpandDeferred(const JSON &json)
+{
+    std::size_t elements{};
+
+    // Initialize the parsing context variables to span only this value
+    p = json.annex->deferred.get();
+    q = SkipContainer(p, elements);
+    line = 0;
+    column = 0;
+    depth = 0;
+    values = 0;
+    deferred_text = std::move(json.annex->deferred);
+
+    // The number of elements is known, so storage is allocated only once
+    array_sizes.assign(1, elements);
+    array_index = 0;
+
+    // Parse the object or array
+    if (*p == '{')
+    {
+        json.value = ParseObject();
+    }
+    else
+    {
+        json.value = ParseArray();
+    }
+
+    json.annex.reset();
+    deferred_text.reset();
+}
+
+/*
+ *  JSON::ExpandDeferred()
+ *
+ *  Description:
+ *      Parse the object or array whose parsing was deferred when this JSON
+ *      object was parsed lazily.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is called via Expand() before the value is accessed.
+ */
+void JSON::ExpandDeferred() const
+{
+    JSONParser parser;
+
+    parser.ExpandDeferred(*this);
+}
+
 } // namespace Terra::JSON
@@ -0,0 +1,1147 @@
+/*
+ *  json_scan.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the JSONScanner object and utility functions for
+ *      moving over well-formed JSON text.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "json_scan.h"
+#include "json_transcode.h"
+#include "unicode_constants.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+/*
+ *  IsDigit()
+ *
+ *  Description:
+ *      Determine whether the given octet is a decimal digit.
+ *
+ *  Parameters:
+ *      octet [in]
+ *          The octet to check.
+ *
+ *  Returns:
+ *      True if the octet is a decimal digit, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr bool IsDigit(char8_t octet)
+{
+    return (octet >= '0') && (octet <= '9');
+}
+
+/*
+ *  ReadHex()
+ *
+ *  Description:
+ *      Read four hex digits as an unsigned integer.
+ *
+ *  Parameters:
+ *      p [in]
+ *          A pointer to the first of four hex digits.
+ *
+ *      value [out]
+ *          The value of the hex digits.
+ *
+ *  Returns:
+ *      True if all four octets were hex digits, false if not.
+ *
+ *  Comments:
+ *      The caller must ensure four octets are available.
+ */
+bool ReadHex(const char8_t *p, std::uint32_t &value)
+{
+    value = 0;
+
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        value <<= 4;
+
+        if (IsDigit(p[i]))
+        {
+            value |= p[i] - '0';
+        }
+        else if ((p[i] >= 'a') && (p[i] <= 'f'))
+        {
+            value |= p[i] - 'a' + 10;
+        }
+        else if ((p[i] >= 'A') && (p[i] <= 'F'))
+        {
+            value |= p[i] - 'A' + 10;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+/*
+ *  JSONScanner::Scan()
+ *
+ *  Description:
+ *      Verify that the given content is a well-formed JSON text.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The UTF-8 JSON text to verify.
+ *
+ *  Returns:
+ *      True if the content is well-formed or false if not, in which case
+ *      ErrorOffset() and ErrorText() describe the first error found.
+ *
+ *  Comments:
+ *      The checks are at least as strict as those made by JSONParser, so
+ *      text accepted by the scanner will be accepted by the parser.
+ */
+bool JSONScanner::Scan(const std::u8string_view content)
+{
+    // Initialize the scanning context variables
+    begin = content.data();
+    p = content.data();
+    q = content.data() + content.size();
+    depth = 0;
+    values = 0;
+    error_position = nullptr;
+    error_text = nullptr;
+    names.clear();
+
+    // Ensure the content is not empty
+    if (EndOfInput()) return Fail("The content string is empty");
+
+    // Skip over whitespace
+    ConsumeWhitespace();
+
+    // Ensure there is still data to consider
+    if (EndOfInput())
+    {
+        return Fail("The content string contains only whitespace");
+    }
+
+    // Scan the value
+    if (!ScanValue()) return false;
+
+    // Consume any trailing whitespace
+    ConsumeWhitespace();
+
+    // Ensure all input is consumed
+    if (!EndOfInput()) return Fail("Unexpected character");
+
+    return true;
+}
+
+/*
+ *  JSONScanner::ConsumeWhitespace()
+ *
+ *  Description:
+ *      Consume whitespace characters until the first non-whitespace character
+ *      or the end of input is reached.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void JSONScanner::ConsumeWhitespace()
+{
+    while (!EndOfInput() &&
+           ((*p == ' ') || (*p == '\n') || (*p == '\r') || (*p == '\t')))
+    {
+        p++;
+    }
+}
+
+/*
+ *  JSONScanner::ScanValue()
+ *
+ *  Description:
+ *      Scan over the value at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the value is well-formed, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool JSONScanner::ScanValue()
+{
+    // Do not read beyond the buffer
+    if (EndOfInput()) return Fail("Incomplete JSON text");
+
+    // Ensure the maximum number of values is not exceeded
+    if (values++ >= rules.max_values)
+    {
+        return Fail("Maximum number of values exceeded");
+    }
+
+    // The initial character reveals the type of value
+    switch (*p)
+    {
+        case '"':
+            return ScanString();
+
+        case '{':
+            return ScanObject();
+
+        case '[':
+            return ScanArray();
+
+        case 't':
+            [[fallthrough]];
+
+        case 'f':
+            [[fallthrough]];
+
+        case 'n':
+            return ScanLiteral();
+
+        default:
+            if ((*p == '-') || IsDigit(*p)) return ScanNumber();
+            break;
+    }
+
+    return Fail("Unknown value type");
+}
+
+/*
+ *  JSONScanner::ScanString()
+ *
+ *  Description:
+ *      Scan over the string at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the string is well-formed, false if not.
+ *
+ *  Comments:
+ *      It is assumed the read position is at the leading quote.
+ */
+bool JSONScanner::ScanString()
+{
+    // Advance over the leading quote
+    const char8_t *start = ++p;
+
+    while (!EndOfInput())
+    {
+        // Move quickly over printable ASCII characters
+        if ((*p >= 0x20) && (*p < 0x80) && (*p != '"') && (*p != '\\'))
+        {
+            p++;
+            continue;
+        }
+
+        // If this is the end of the string, stop processing
+        if (*p == '"')
+        {
+            if (static_cast<std::size_t>(p - start) > rules.max_string_length)
+            {
+                p = start;
+                return Fail("Maximum string length exceeded");
+            }
+            p++;
+            return true;
+        }
+
+        // Verify any escape sequence
+        if (*p == '\\')
+        {
+            if (!ScanEscape()) return false;
+            continue;
+        }
+
+        // Control characters are not permitted in strings
+        if (*p < 0x20) return Fail("Illegal control character in string");
+
+        // Verify any multi-octet UTF-8 character
+        if (rules.utf8)
+        {
+            if (!ScanUTF8()) return false;
+            continue;
+        }
+
+        p++;
+    }
+
+    return Fail("No closing quote parsing string");
+}
+
+/*
+ *  JSONScanner::ScanEscape()
+ *
+ *  Description:
+ *      Scan over the escape sequence at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the escape sequence is valid, false if not.
+ *
+ *  Comments:
+ *      It is assumed the read position is at the backslash.  Escaped UTF-16
+ *      surrogates must appear as a high / low surrogate pair.
+ */
+bool JSONScanner::ScanEscape()
+{
+    std::uint32_t code_value{};
+
+    // Advance over the backslash
+    p++;
+
+    if (EndOfInput()) return Fail("No closing quote parsing string");
+
+    switch (*p)
+    {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            p++;
+            return true;
+
+        case 'u':
+            p++;
+            break;
+
+        default:
+            return Fail("Invalid escape sequence");
+    }
+
+    // Read the hex digits of the escaped character
+    if ((q - p) < 4)
+    {
+        return Fail("Insufficient input following \\u sequence");
+    }
+    if (!ReadHex(p, code_value)) return Fail("Invalid hex digit");
+    p += 4;
+
+    // Characters outside of the surrogate range are complete
+    if ((code_value < Unicode::Surrogate_High_Min) ||
+        (code_value > Unicode::Surrogate_Low_Max))
+    {
+        return true;
+    }
+
+    // Ensure the code value is not in the low surrogate range
+    if (code_value >= Unicode::Surrogate_Low_Min)
+    {
+        return Fail("Unexpected low Unicode surrogate found");
+    }
+
+    // The following characters should be '\uNNNN' where 'N' is hex
+    if (((q - p) < 6) || (p[0] != '\\') || (p[1] != 'u'))
+    {
+        return Fail("Expected low Unicode surrogate, but did not find one");
+    }
+    p += 2;
+    if (!ReadHex(p, code_value)) return Fail("Invalid hex digit");
+
+    // Ensure the low surrogate value is within the expected range
+    if ((code_value < Unicode::Surrogate_Low_Min) ||
+        (code_value > Unicode::Surrogate_Low_Max))
+    {
+        return Fail("Expected low Unicode surrogate value");
+    }
+    p += 4;
+
+    return true;
+}
+
+/*
+ *  JSONScanner::ScanUTF8()
+ *
+ *  Description:
+ *      Scan over the multi-octet UTF-8 character at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the character is valid UTF-8, false if not.
+ *
+ *  Comments:
+ *      Overlong encodings, surrogates, and values beyond U+10FFFF are
+ *      rejected, per RFC 3629.
+ */
+bool JSONScanner::ScanUTF8()
+{
+    std::size_t length{};
+    char8_t minimum = 0x80;
+    char8_t maximum = 0xbf;
+
+    // The leading octet determines the length and the valid range of the
+    // second octet
+    if ((*p >= 0xc2) && (*p <= 0xdf))
+    {
+        length = 2;
+    }
+    else if ((*p >= 0xe0) && (*p <= 0xef))
+    {
+        length = 3;
+        if (*p == 0xe0) minimum = 0xa0;
+        if (*p == 0xed) maximum = 0x9f;
+    }
+    else if ((*p >= 0xf0) && (*p <= 0xf4))
+    {
+        length = 4;
+        if (*p == 0xf0) minimum = 0x90;
+        if (*p == 0xf4) maximum = 0x8f;
+    }
+    else
+    {
+        return Fail("Invalid UTF-8 character");
+    }
+
+    // Ensure the whole character is present
+    if (static_cast<std::size_t>(q - p) < length)
+    {
+        return Fail("Invalid UTF-8 character");
+    }
+
+    // Verify the second octet, then the remaining continuation octets
+    if ((p[1] < minimum) || (p[1] > maximum))
+    {
+        return Fail("Invalid UTF-8 character");
+    }
+    for (std::size_t i = 2; i < length; i++)
+    {
+        if ((p[i] & 0xc0) != 0x80) return Fail("Invalid UTF-8 character");
+    }
+
+    p += length;
+
+    return true;
+}
+
+/*
+ *  JSONScanner::ScanNumber()
+ *
+ *  Description:
+ *      Scan over the number at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the number is well-formed, false if not.
+ *
+ *  Comments:
+ *      If the number_range rule is applied, integers must fit within a
+ *      JSONInteger and other numbers must convert to a JSONFloat without
+ *      overflow or underflow, as is required by JSONParser.
+ */
+bool JSONScanner::ScanNumber()
+{
+    const char8_t *start = p;
+    bool negative = false;
+    bool is_float = false;
+
+    // Consume the sign
+    if (*p == '-')
+    {
+        negative = true;
+        p++;
+    }
+
+    // There must be at least one integer digit
+    if (EndOfInput() || !IsDigit(*p)) return Fail("Invalid number");
+    const char8_t *integer = p;
+    while (!EndOfInput() && IsDigit(*p)) p++;
+
+    // RFC 8259 does not permit leading zeros
+    if (rules.strict_numbers && (*integer == '0') && (p - integer > 1))
+    {
+        p = integer;
+        return Fail("Invalid number");
+    }
+
+    // Consume any fraction
+    if (!EndOfInput() && (*p == '.'))
+    {
+        p++;
+        if (EndOfInput() || !IsDigit(*p)) return Fail("Invalid number");
+        while (!EndOfInput() && IsDigit(*p)) p++;
+        is_float = true;
+    }
+
+    // Consume any exponent
+    if (!EndOfInput() && ((*p == 'e') || (*p == 'E')))
+    {
+        p++;
+        if (!EndOfInput() && ((*p == '-') || (*p == '+'))) p++;
+        if (EndOfInput() || !IsDigit(*p)) return Fail("Invalid number");
+        while (!EndOfInput() && IsDigit(*p)) p++;
+        is_float = true;
+    }
+
+    if (!rules.number_range) return true;
+
+    // Ensure integers fit within a JSONInteger
+    if (!is_float)
+    {
+        const std::uint64_t limit =
+            negative ? std::uint64_t(1) << 63 : (std::uint64_t(1) << 63) - 1;
+        std::uint64_t value = 0;
+
+        for (const char8_t *r = integer; r < p; r++)
+        {
+            std::uint64_t digit = *r - '0';
+            if (value > (limit - digit) / 10)
+            {
+                return Fail("Number out of range");
+            }
+            value = value * 10 + digit;
+        }
+
+        return true;
+    }
+
+    // Ensure the number converts to a JSONFloat as std::stod() would
+    std::string number(reinterpret_cast<const char *>(start), p - start);
+    errno = 0;
+    std::strtod(number.c_str(), nullptr);
+    if (errno == ERANGE) return Fail("Number out of range");
+
+    return true;
+}
+
+/*
+ *  JSONScanner::ScanObject()
+ *
+ *  Description:
+ *      Scan over the object at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the object is well-formed, false if not.
+ *
+ *  Comments:
+ *      It is assumed the read position is at the leading brace.
+ */
+bool JSONScanner::ScanObject()
+{
+    std::size_t first_name = names.size();
+    std::size_t members = 0;
+
+    // Ensure the maximum depth is not exceeded
+    if (depth >= rules.max_depth)
+    {
+        return Fail("Maximum nesting depth exceeded");
+    }
+
+    // Advance over the leading brace
+    p++;
+    depth++;
+    ConsumeWhitespace();
+
+    // Check for an empty object
+    if (!EndOfInput() && (*p == '}'))
+    {
+        p++;
+        depth--;
+        return true;
+    }
+
+    while (true)
+    {
+        // Ensure the maximum number of members is not exceeded
+        if (members++ >= rules.max_members)
+        {
+            return Fail("Maximum number of object members exceeded");
+        }
+
+        // Each member starts with a name
+        if (EndOfInput()) return Fail("Unexpected end of JSON object");
+        if (*p != '"') return Fail("Expected a string");
+        const char8_t *name = p + 1;
+        if (!ScanString()) return false;
+        if (rules.unique_names) names.emplace_back(name, p - 1 - name);
+
+        // Next, there should be a : separator
+        ConsumeWhitespace();
+        if (EndOfInput()) return Fail("Unexpected end of JSON object");
+        if (*p != ':') return Fail("Expected a colon");
+        p++;
+
+        // Scan the value that follows
+        ConsumeWhitespace();
+        if (!ScanValue()) return false;
+
+        // There should be either a comma or the closing brace
+        ConsumeWhitespace();
+        if (EndOfInput()) return Fail("Unexpected end of JSON object");
+        if (*p == '}') break;
+        if (*p != ',') return Fail("Expected a comma");
+        p++;
+        ConsumeWhitespace();
+    }
+
+    // Verify the names are unique, then forget them
+    if (rules.unique_names)
+    {
+        if (!CheckUniqueNames(first_name)) return false;
+        names.resize(first_name);
+    }
+
+    // Advance over the closing brace
+    p++;
+    depth--;
+
+    return true;
+}
+
+/*
+ *  JSONScanner::ScanArray()
+ *
+ *  Description:
+ *      Scan over the array at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the array is well-formed, false if not.
+ *
+ *  Comments:
+ *      It is assumed the read position is at the leading bracket.
+ */
+bool JSONScanner::ScanArray()
+{
+    // Ensure the maximum depth is not exceeded
+    if (depth >= rules.max_depth)
+    {
+        return Fail("Maximum nesting depth exceeded");
+    }
+
+    // Advance over the leading bracket
+    p++;
+    depth++;
+    ConsumeWhitespace();
+
+    // Check for an empty array
+    if (!EndOfInput() && (*p == ']'))
+    {
+        p++;
+        depth--;
+        return true;
+    }
+
+    for (std::size_t elements = 0;; elements++)
+    {
+        // Ensure the maximum number of elements is not exceeded
+        if (elements >= rules.max_elements)
+        {
+            return Fail("Maximum number of array elements exceeded");
+        }
+
+        // Scan the element
+        if (!ScanValue()) return false;
+
+        // There should be either a comma or the closing bracket
+        ConsumeWhitespace();
+        if (EndOfInput()) return Fail("Unexpected end of JSON array");
+        if (*p == ']') break;
+        if (*p != ',') return Fail("Expected a comma");
+        p++;
+        ConsumeWhitespace();
+    }
+
+    // Advance over the closing bracket
+    p++;
+    depth--;
+
+    return true;
+}
+
+/*
+ *  JSONScanner::ScanLiteral()
+ *
+ *  Description:
+ *      Scan over the literal at the read position.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the literal is valid, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool JSONScanner::ScanLiteral()
+{
+    for (const std::u8string_view literal : {std::u8string_view(u8"true"),
+                                             std::u8string_view(u8"false"),
+                                             std::u8string_view(u8"null")})
+    {
+        if ((static_cast<std::size_t>(q - p) >= literal.size()) &&
+            (std::memcmp(p, literal.data(), literal.size()) == 0))
+        {
+            p += literal.size();
+            return true;
+        }
+    }
+
+    return Fail("Unknown JSON literal");
+}
+
+/*
+ *  JSONScanner::CheckUniqueNames()
+ *
+ *  Description:
+ *      Verify that the names of the object's members are unique.
+ *
+ *  Parameters:
+ *      first_name [in]
+ *          The position in names of the object's first member's name.
+ *
+ *  Returns:
+ *      True if the names are unique, false if not.
+ *
+ *  Comments:
+ *      Names are compared in their encoded form unless one contains an
+ *      escape sequence, in which case the names are decoded.
+ */
+bool JSONScanner::CheckUniqueNames(std::size_t first_name)
+{
+    auto first = names.begin() + first_name;
+
+    // An object with fewer than two members has unique names
+    if (names.end() - first < 2) return true;
+
+    // Compare names in their encoded form if none have escape sequences
+    if (std::none_of(first,
+                     names.end(),
+                     [](const std::u8string_view name) {
+                         return name.find(u8'\\') != name.npos;
+                     }))
+    {
+        std::sort(first, names.end());
+        if (std::adjacent_find(first, names.end()) != names.end())
+        {
+            return Fail("Duplicate name");
+        }
+        return true;
+    }
+
+    // Otherwise, compare the decoded names
+    std::vector<std::u8string> decoded;
+    decoded.reserve(names.end() - first);
+    for (auto it = first; it != names.end(); it++)
+    {
+        decoded.emplace_back(DecodeString(*it));
+    }
+    std::sort(decoded.begin(), decoded.end());
+    if (std::adjacent_find(decoded.begin(), decoded.end()) != decoded.end())
+    {
+        return Fail("Duplicate name");
+    }
+
+    return true;
+}
+
+/*
+ *  JSONScanner::Fail()
+ *
+ *  Description:
+ *      Record an error at the read position.
+ *
+ *  Parameters:
+ *      text [in]
+ *          Description of the error.
+ *
+ *  Returns:
+ *      False, so that the caller may return the result of this function.
+ *
+ *  Comments:
+ *      None.
+ */
+bool JSONScanner::Fail(const char *text)
+{
+    error_position = std::min(p, q);
+    error_text = text;
+
+    return false;
+}
+
+/*
+ *  SkipContainer()
+ *
+ *  Description:
+ *      Move over the object or array that starts at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          A pointer to the leading brace or bracket of the container.
+ *
+ *      elements [out]
+ *          The number of members or elements held by the container.
+ *
+ *  Returns:
+ *      A pointer one past the container's closing brace or bracket.
+ *
+ *  Comments:
+ *      The text must be well-formed, as verified by JSONScanner, since the
+ *      end of input is not checked.  Only strings and brackets are examined.
+ */
+const char8_t *SkipContainer(const char8_t *p, std::size_t &elements)
+{
+    std::size_t depth = 0;
+    bool empty = true;
+
+    elements = 0;
+
+    for (;; p++)
+    {
+        switch (*p)
+        {
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+                break;
+
+            case '"':
+                if (depth == 1) empty = false;
+                for (p++; *p != '"'; p++)
+                {
+                    if (*p == '\\') p++;
+                }
+                break;
+
+            case '{':
+            case '[':
+                if (depth == 1) empty = false;
+                depth++;
+                break;
+
+            case '}':
+            case ']':
+                if (--depth == 0)
+                {
+                    if (!empty) elements++;
+                    return p + 1;
+                }
+                break;
+
+            case ',':
+                if (depth == 1) elements++;
+                break;
+
+            default:
+                if (depth == 1) empty = false;
+                break;
+        }
+    }
+}
+
+/*
+ *  FindContainerEnd()
+ *
+ *  Description:
+ *      Find the end of the object or array containing the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          A position within an object or array, outside of any string.
+ *
+ *      q [in]
+ *          One past the end of the input.
+ *
+ *  Returns:
+ *      A pointer to the closing brace or bracket or q if it is not found.
+ *
+ *  Comments:
+ *      The text is not verified; only strings and brackets are examined.
+ */
+const char8_t *FindContainerEnd(const char8_t *p, const char8_t *q)
+{
+    std::size_t depth = 0;
+
+    for (; p < q; p++)
+    {
+        switch (*p)
+        {
+            case '"':
+                for (p++; (p < q) && (*p != '"'); p++)
+                {
+                    if ((*p == '\\') && (q - p > 1)) p++;
+                }
+                if (p >= q) return q;
+                break;
+
+            case '{':
+            case '[':
+                depth++;
+                break;
+
+            case '}':
+            case ']':
+                if (depth == 0) return p;
+                depth--;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return q;
+}
+
+/*
+ *  DecodeString()
+ *
+ *  Description:
+ *      Decode the escape sequences within the given string content.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The content of a well-formed string, excluding the quotes.
+ *
+ *  Returns:
+ *      The decoded string.
+ *
+ *  Comments:
+ *      None.
+ */
+std::u8string DecodeString(const std::u8string_view text)
+{
+    std::u8string string;
+    std::uint32_t code_value{};
+    std::uint32_t low_code_value{};
+
+    string.reserve(text.size());
+
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] != '\\')
+        {
+            string.push_back(text[i]);
+            continue;
+        }
+
+        switch (text[++i])
+        {
+            case 'b':
+                string.push_back('\b');
+                break;
+
+            case 'f':
+                string.push_back('\f');
+                break;
+
+            case 'n':
+                string.push_back('\n');
+                break;
+
+            case 'r':
+                string.push_back('\r');
+                break;
+
+            case 't':
+                string.push_back('\t');
+                break;
+
+            case 'u':
+                ReadHex(text.data() + i + 1, code_value);
+                i += 4;
+                if ((code_value >= Unicode::Surrogate_High_Min) &&
+                    (code_value <= Unicode::Surrogate_High_Max))
+                {
+                    ReadHex(text.data() + i + 3, low_code_value);
+                    i += 6;
+                    code_value = (code_value << 10) + low_code_value +
+                                 Unicode::Surrogate_Offset;
+                }
+                AppendUTF8(string, code_value);
+                break;
+
+            default:
+                string.push_back(text[i]);
+                break;
+        }
+    }
+
+    return string;
+}
+
+/*
+ *  FindValueEnd()
+ *
+ *  Description:
+ *      Find the end of the value that starts at the given position.
+ *
+ *  Parameters:
+ *      p [in]
+ *          The position of the first character of the value.
+ *
+ *      q [in]
+ *          One past the end of the text.
+ *
+ *  Returns:
+ *      A pointer one past the end of the value, or nullptr if the value does
+ *      not end before q.
+ *
+ *  Comments:
+ *      Objects and arrays are examined only to find their end, and other
+ *      values that are not strings extend to the next delimiter, so the
+ *      value is not verified to be well-formed.
+ */
+const char8_t *FindValueEnd(const char8_t *p, const char8_t *q)
+{
+    const char8_t *end = p;
+
+    if (p >= q) return nullptr;
+
+    switch (*p)
+    {
+        case '{':
+        case '[':
+            end = FindContainerEnd(p + 1, q);
+            if ((end >= q) || (*end != ((*p == '{') ? '}' : ']')))
+            {
+                return nullptr;
+            }
+            return end + 1;
+
+        case '"':
+            for (end++; end < q; end++)
+            {
+                if (*end == '"') return end + 1;
+                if ((*end == '\\') && (q - end > 1)) end++;
+            }
+            return nullptr;
+
+        default:
+            while ((end < q) && (*end != ',') && (*end != ']') &&
+                   (*end != '}') && (*end != ' ') && (*end != '\t') &&
+                   (*end != '\r') && (*end != '\n'))
+            {
+                end++;
+            }
+            return (end > p) ? end : nullptr;
+    }
+}
+
+/*
+ *  StringEquals()
+ *
+ *  Description:
+ *      Determine whether the given string content represents the given
+ *      string.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The content of a string within JSON text (i.e., without the
+ *          quotation marks), which might contain escape sequences.
+ *
+ *      string [in]
+ *          The string to compare with.
+ *
+ *  Returns:
+ *      True if the content represents the given string, false otherwise.
+ *
+ *  Comments:
+ *      Content containing escape sequences is verified to be well-formed
+ *      before being decoded, so it may come from text that has not been
+ *      verified.  Malformed content represents no string.
+ */
+bool StringEquals(const std::u8string_view text,
+                  const std::u8string_view string)
+{
+    if (text.find(u8'\\') == std::u8string_view::npos) return text == string;
+
+    std::u8string quoted;
+    quoted.reserve(text.size() + 2);
+    quoted.push_back(u8'"');
+    quoted.append(text);
+    quoted.push_back(u8'"');
+
+    if (!JSONScanner().Scan(quoted)) return false;
+
+    return DecodeString(text) == string;
+}
+
+/*
+ *  TrimPartialCharacter()
+ *
+ *  Description:
+ *      Remove an incomplete UTF-8 character from the end of a string.
+ *
+ *  Parameters:
+ *      string [in/out]
+ *          The string to trim.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is used when truncating a string, which might otherwise divide
+ *      a multi-octet character.
+ */
+void TrimPartialCharacter(std::u8string &string)
+{
+    std::size_t position = string.size();
+
+    // Locate the first octet of the last character
+    while ((position > 0) && ((string[position - 1] & 0xc0) == 0x80))
+    {
+        position--;
+    }
+    if (position == 0) return;
+    position--;
+
+    // Determine the length the character should have
+    char8_t octet = string[position];
+    std::size_t length = (octet < 0xc0) ? 1 :
+                         (octet < 0xe0) ? 2 :
+                         (octet < 0xf0) ? 3 :
+                                          4;
+
+    // Remove the character if it is incomplete
+    if (string.size() - position < length) string.resize(position);
+}
+
+} // namespace Terra::JSON
@@ -0,0 +1,132 @@
+/*
+ *  json_scan.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines the JSONScanner, which verifies that JSON text is
+ *      well-formed without producing JSON objects, and utility functions for
+ *      moving over JSON text that is already known to be well-formed.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Terra::JSON
+{
+
+// Rules the JSONScanner applies in addition to the JSON grammar
+struct ScanRules
+{
+    // Value of a limit that does not limit
+    static constexpr std::size_t No_Limit =
+        std::numeric_limits<std::size_t>::max();
+
+    // Numbers must be representable by JSONInteger or JSONFloat
+    bool number_range{false};
+
+    // Names within an object must be unique
+    bool unique_names{false};
+
+    // Numbers must not have leading zeros, as required by RFC 8259
+    bool strict_numbers{false};
+
+    // Strings must be valid UTF-8
+    bool utf8{false};
+
+    // Limits on the content (see ParserOptions)
+    std::size_t max_depth{No_Limit};
+    std::size_t max_values{No_Limit};
+    std::size_t max_string_length{No_Limit};
+    std::size_t max_members{No_Limit};
+    std::size_t max_elements{No_Limit};
+};
+
+// Scanner that verifies JSON text is well-formed
+class JSONScanner
+{
+    public:
+        JSONScanner(const ScanRules &rules = {}) :
+            rules{rules},
+            begin{nullptr},
+            p{nullptr},
+            q{nullptr},
+            depth{0},
+            values{0},
+            error_position{nullptr},
+            error_text{nullptr}
+        {
+        }
+        ~JSONScanner() = default;
+
+        bool Scan(const std::u8string_view content);
+
+        // Offset and description of the error found by Scan()
+        std::size_t ErrorOffset() const { return error_position - begin; }
+        const char *ErrorText() const { return error_text; }
+
+    protected:
+        constexpr bool EndOfInput() const { return p >= q; }
+        void ConsumeWhitespace();
+        bool ScanValue();
+        bool ScanString();
+        bool ScanEscape();
+        bool ScanUTF8();
+        bool ScanNumber();
+        bool ScanObject();
+        bool ScanArray();
+        bool ScanLiteral();
+        bool CheckUniqueNames(std::size_t first_name);
+        bool Fail(const char *text);
+
+        ScanRules rules;                        // Rules to apply
+        const char8_t *begin;                   // Start of content
+        const char8_t *p;                       // Current read position
+        const char8_t *q;                       // One past end of data
+        std::size_t depth;                      // Depth of nesting
+        std::size_t values;                     // Number of values scanned
+        const char8_t *error_position;          // Location of error
+        const char *error_text;                 // Description of error
+        std::vector<std::u8string_view> names;  // Names in open objects
+};
+
+// Return a pointer one past the end of the object or array that starts at
+// the given position, storing the number of members or elements it holds;
+// the text must be well-formed
+const char8_t *SkipContainer(const char8_t *p, std::size_t &elements);
+
+// Return a pointer to the closing brace or bracket of the object or array
+// containing the given position, or q if it is not found; the text need not
+// be well-formed, as only strings and brackets are examined
+const char8_t *FindContainerEnd(const char8_t *p, const char8_t *q);
+
+// Return a pointer one past the end of the value that starts at the given
+// position, or nullptr if it does not end before q; the text need not be
+// well-formed, as objects and arrays are examined only to find their end
+const char8_t *FindValueEnd(const char8_t *p, const char8_t *q);
+
+// Decode the escape sequences within the given well-formed string content
+std::u8string DecodeString(const std::u8string_view text);
+
+// Determine whether the given string content, which might contain escape
+// sequences, represents the given string
+bool StringEquals(const std::u8string_view text,
+                  const std::u8string_view string);
+
+// Remove an incomplete UTF-8 character from the end of a truncated string
+void TrimPartialCharacter(std::u8string &string);
+
+} // namespace Terra::JSON
@@ -0,0 +1,766 @@
+/*
+ *  json_serializer.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements JSON::ToString(const SerializerOptions &), which
+ *      serializes JSON objects into text of bounded size.  This is intended
+ *      for logging, where a single large document should not be allowed to
+ *      flood a log.
+ *
+ *      When the budget is exhausted, the value being written is replaced
+ *      with the Elision_Marker (an array element or a member whose name and
+ *      value are both the marker) and every open object and array is closed,
+ *      so the result is always well-formed JSON text.  Space for the closing
+ *      brackets and the marker is reserved before each value is written.
+ *
+ *      This file also implements JSON::ToCachedString(), which retains the
+ *      text produced for the largest objects and arrays whose text does not
+ *      exceed Cached_Text_Granularity.  Text is retained by an object or
+ *      array only if it is not retained by any enclosing value, so at most
+ *      one copy of the text is retained.  Non-const member functions of JSON
+ *      that return a reference into the value mark it as exposed, replacing
+ *      any retained text.  Since a value nested within a document can only
+ *      be reached for modification via those functions of each enclosing
+ *      JSON object, every value enclosing one that might be modified, even
+ *      via a reference retained for later use, is exposed.  Exposed values
+ *      never retain text, so retained text is never stale, while the text
+ *      of values that were not accessed is reused verbatim.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <terra/json/json.h>
+#include "json_escape.h"
+#include "json_number_text.h"
+#include "json_scan.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Largest text retained by an object or array for ToCachedString(); larger
+// objects and arrays retain no text of their own, but rather reuse the text
+// retained by the values within them
+constexpr std::size_t Cached_Text_Granularity = 4096;
+
+// Outcome of writing a value within the budget
+enum class WriteResult
+{
+    Complete,                                   // All of the value written
+    Truncated,                                  // Value written, then elided
+    Omitted                                     // Nothing written
+};
+
+// Serializer that writes JSON text within a byte budget
+class BoundedSerializer
+{
+    public:
+        BoundedSerializer(const SerializerOptions &options);
+        ~BoundedSerializer() = default;
+
+        std::string Serialize(const JSON &json);
+
+    protected:
+        bool WriteComplete(const JSON &json);
+        std::size_t Available(std::size_t closers) const;
+        WriteResult Write(const JSON &json, std::size_t closers);
+        WriteResult WriteText(const std::string &text, std::size_t closers);
+        WriteResult WriteString(const std::u8string &string,
+                                std::size_t closers);
+        WriteResult WriteObject(const JSONObject &object,
+                                std::size_t closers);
+        WriteResult WriteArray(const JSONArray &array, std::size_t closers);
+        static std::string Escape(const std::u8string_view string,
+                                  bool elided);
+
+        const SerializerOptions &options;       // Limits to observe
+        std::size_t budget;                     // Octets of output allowed
+        std::string marker;                     // Serialized Elision_Marker
+        std::size_t reserve;                    // Octets for elided member
+        std::string output;                     // Text produced
+};
+
+/*
+ *  BoundedSerializer::BoundedSerializer()
+ *
+ *  Description:
+ *      Constructor for the BoundedSerializer.
+ *
+ *  Parameters:
+ *      options [in]
+ *          The limits to observe when serializing.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      A budget smaller than SerializerOptions::Minimum_Bytes is raised to
+ *      that minimum, as there must be room for an elided object.
+ */
+BoundedSerializer::BoundedSerializer(const SerializerOptions &options) :
+    options{options},
+    budget{std::max(options.max_bytes, SerializerOptions::Minimum_Bytes)},
+    marker{Escape(Elision_Marker, false)},
+    reserve{(marker.size() * 2) + 4}
+{
+}
+
+/*
+ *  BoundedSerializer::Serialize()
+ *
+ *  Description:
+ *      Serialize the given JSON object within the budget.
+ *
+ *  Parameters:
+ *      json [in]
+ *          The JSON object to serialize.
+ *
+ *  Returns:
+ *      The JSON text, which is no longer than the budget.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string BoundedSerializer::Serialize(const JSON &json)
+{
+    // Produce the complete text if it fits, as no space need be reserved
+    output.clear();
+    if (WriteComplete(json)) return std::move(output);
+
+    output.clear();
+
+    // A value that does not fit at all is replaced with the marker
+    if (Write(json, 0) == WriteResult::Omitted) output = marker;
+
+    return std::move(output);
+}
+
+/*
+ *  BoundedSerializer::WriteComplete()
+ *
+ *  Description:
+ *      Write the complete text of the given JSON value, as produced by
+ *      ToString(), so long as it fits within the budget.
+ *
+ *  Parameters:
+ *      json [in]
+ *          The JSON value to write.
+ *
+ *  Returns:
+ *      True if the value was written in full within the budget and no
+ *      string exceeds the per-string limit.  If false, the output holds a
+ *      partial value and must be discarded.
+ *
+ *  Comments:
+ *      Writing stops once the budget is exceeded, so the work done is
+ *      proportional to the budget rather than to the size of the value.
+ */
+bool BoundedSerializer::WriteComplete(const JSON &json)
+{
+    bool need_comma = false;
+
+    switch (json.GetValueType())
+    {
+        case JSONValueType::String:
+        {
+            const std::u8string &string = *json.GetValue<JSONString>();
+            if (string.size() > options.max_string_length) return false;
+            if ((output.size() + string.size() + 2) > budget) return false;
+            AppendEscaped(output, string);
+            break;
+        }
+
+        case JSONValueType::Number:
+        {
+            char buffer[Number_Text_Size];
+            output += FormatNumber(json.GetValue<JSONNumber>(), buffer);
+            break;
+        }
+
+        case JSONValueType::Object:
+            output.push_back('{');
+            for (const auto &[name, value] : *json.GetValue<JSONObject>())
+            {
+                if (need_comma) output += ", ";
+                if ((output.size() + name.size() + 4) > budget) return false;
+                AppendEscaped(output, name);
+                output += ": ";
+                if (!WriteComplete(value)) return false;
+                need_comma = true;
+            }
+            output.push_back('}');
+            break;
+
+        case JSONValueType::Array:
+            output.push_back('[');
+            for (const auto &element : *json.GetValue<JSONArray>())
+            {
+                if (need_comma) output += ", ";
+                if (!WriteComplete(element)) return false;
+                need_comma = true;
+            }
+            output.push_back(']');
+            break;
+
+        default:
+            output += json.ToString();
+            break;
+    }
+
+    return (output.size() <= budget);
+}
+
+/*
+ *  BoundedSerializer::Available()
+ *
+ *  Description:
+ *      Determine how many octets may be written for a value, leaving room
+ *      for the closing brackets of open containers and an elided member.
+ *
+ *  Parameters:
+ *      closers [in]
+ *          The number of objects and arrays that are open.
+ *
+ *  Returns:
+ *      The number of octets available.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t BoundedSerializer::Available(std::size_t closers) const
+{
+    std::size_t needed = output.size() + closers + reserve;
+
+    return (needed < budget) ? budget - needed : 0;
+}
+
+/*
+ *  BoundedSerializer::Write()
+ *
+ *  Description:
+ *      Write the given JSON value.
+ *
+ *  Parameters:
+ *      json [in]
+ *          The JSON value to write.
+ *
+ *      closers [in]
+ *          The number of objects and arrays that are open.
+ *
+ *  Returns:
+ *      The extent to which the value was written.  If Omitted, the output
+ *      is unchanged.
+ *
+ *  Comments:
+ *      None.
+ */
+WriteResult BoundedSerializer::Write(const JSON &json, std::size_t closers)
+{
+    switch (json.GetValueType())
+    {
+        case JSONValueType::String:
+            return WriteString(*json.GetValue<JSONString>(), closers);
+
+        case JSONValueType::Object:
+            return WriteObject(json.GetValue<JSONObject>(), closers);
+
+        case JSONValueType::Array:
+            return WriteArray(json.GetValue<JSONArray>(), closers);
+
+        default:
+            return WriteText(json.ToString(), closers);
+    }
+}
+
+/*
+ *  BoundedSerializer::WriteText()
+ *
+ *  Description:
+ *      Write the given text, which cannot be shortened, if it fits.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The serialized number or literal to write.
+ *
+ *      closers [in]
+ *          The number of objects and arrays that are open.
+ *
+ *  Returns:
+ *      Complete if the text was written, Omitted otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+WriteResult BoundedSerializer::WriteText(const std::string &text,
+                                         std::size_t closers)
+{
+    if (text.size() > Available(closers)) return WriteResult::Omitted;
+
+    output += text;
+
+    return WriteResult::Complete;
+}
+
+/*
+ *  BoundedSerializer::WriteString()
+ *
+ *  Description:
+ *      Write the given string, shortening it to observe the per-string
+ *      limit and, if necessary, to fit within the budget.
+ *
+ *  Parameters:
+ *      string [in]
+ *          The string to write.
+ *
+ *      closers [in]
+ *          The number of objects and arrays that are open.
+ *
+ *  Returns:
+ *      Complete if the string was written (even if shortened to observe
+ *      the per-string limit), Truncated if it was shortened to fit within
+ *      the budget, or Omitted if no part of it fits.
+ *
+ *  Comments:
+ *      A string shortened to fit the budget ends the output, so it may
+ *      use the space otherwise reserved for an elided member.  The marker
+ *      appended to it then also indicates that any content following the
+ *      string was omitted.
+ */
+WriteResult BoundedSerializer::WriteString(const std::u8string &string,
+                                           std::size_t closers)
+{
+    std::u8string_view content = string;
+    bool elided = false;
+    std::size_t available = Available(closers);
+
+    // Observe the per-string limit
+    if (content.size() > options.max_string_length)
+    {
+        content = content.substr(0, options.max_string_length);
+        elided = true;
+    }
+
+    // Write the string if it fits (escaping only lengthens the text)
+    if ((content.size() + 2) <= available)
+    {
+        std::string text = Escape(content, elided);
+        if (text.size() <= available)
+        {
+            output += text;
+            return WriteResult::Complete;
+        }
+    }
+
+    // Write as much of the string as will fit, followed by the marker
+    available += reserve;
+    if (available < marker.size()) return WriteResult::Omitted;
+    std::size_t length = std::min(content.size(), available - marker.size());
+    while (length > 0)
+    {
+        std::string text = Escape(content.substr(0, length), true);
+        if (text.size() <= available)
+        {
+            output += text;
+            return WriteResult::Truncated;
+        }
+        length -= std::min(length, text.size() - available);
+    }
+
+    return WriteResult::Omitted;
+}
+
+/*
+ *  BoundedSerializer::WriteObject()
+ *
+ *  Description:
+ *      Write the given object, eliding the members that do not fit.
+ *
+ *  Parameters:
+ *      object [in]
+ *          The object to write.
+ *
+ *      closers [in]
+ *          The number of objects and arrays that are open.
+ *
+ *  Returns:
+ *      Complete if all members were written, Truncated if the object was
+ *      closed early, or Omitted if there was no room to open it.
+ *
+ *  Comments:
+ *      None.
+ */
+WriteResult BoundedSerializer::WriteObject(const JSONObject &object,
+                                           std::size_t closers)
+{
+    bool first = true;
+
+    if (Available(closers) < 2) return WriteResult::Omitted;
+
+    output.push_back('{');
+
+    for (const auto &[name, value] : *object)
+    {
+        WriteResult result = WriteResult::Omitted;
+
+        if (!first) output += ", ";
+
+        // Write the name and value only if the name fits
+        std::string text = Escape(name, false);
+        if ((text.size() + 2) <= Available(closers + 1))
+        {
+            std::size_t position = output.size();
+            output += text;
+            output += ": ";
+            result = Write(value, closers + 1);
+            if (result == WriteResult::Omitted) output.resize(position);
+        }
+
+        // Close the object if the member was not written in full
+        if (result != WriteResult::Complete)
+        {
+            if (result == WriteResult::Omitted)
+            {
+                output += marker;
+                output += ": ";
+                output += marker;
+            }
+            output.push_back('}');
+            return WriteResult::Truncated;
+        }
+
+        first = false;
+    }
+
+    output.push_back('}');
+
+    return WriteResult::Complete;
+}
+
+/*
+ *  BoundedSerializer::WriteArray()
+ *
+ *  Description:
+ *      Write the given array, eliding the elements that do not fit.
+ *
+ *  Parameters:
+ *      array [in]
+ *          The array to write.
+ *
+ *      closers [in]
+ *          The number of objects and arrays that are open.
+ *
+ *  Returns:
+ *      Complete if all elements were written, Truncated if the array was
+ *      closed early, or Omitted if there was no room to open it.
+ *
+ *  Comments:
+ *      None.
+ */
+WriteResult BoundedSerializer::WriteArray(const JSONArray &array,
+                                          std::size_t closers)
+{
+    bool first = true;
+
+    if (Available(closers) < 2) return WriteResult::Omitted;
+
+    output.push_back('[');
+
+    for (const auto &element : *array)
+    {
+        if (!first) output += ", ";
+
+        WriteResult result = Write(element, closers + 1);
+
+        // Close the array if the element was not written in full
+        if (result != WriteResult::Complete)
+        {
+            if (result == WriteResult::Omitted) output += marker;
+            output.push_back(']');
+            return WriteResult::Truncated;
+        }
+
+        first = false;
+    }
+
+    output.push_back(']');
+
+    return WriteResult::Complete;
+}
+
+/*
+ *  BoundedSerializer::Escape()
+ *
+ *  Description:
+ *      Produce the quoted and escaped text for the given string.
+ *
+ *  Parameters:
+ *      string [in]
+ *          The string content, which might have been shortened.
+ *
+ *      elided [in]
+ *          True if the string was shortened, in which case any partial
+ *          character is removed and the Elision_Marker is appended.
+ *
+ *  Returns:
+ *      The serialized string.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string BoundedSerializer::Escape(const std::u8string_view string,
+                                      bool elided)
+{
+    std::string output;
+
+    if (!elided)
+    {
+        AppendEscaped(output, string);
+        return output;
+    }
+
+    std::u8string content(string);
+    TrimPartialCharacter(content);
+    content += Elision_Marker;
+    AppendEscaped(output, content);
+
+    return output;
+}
+
+} // namespace
+
+/*
+ *  JSON::ToString()
+ *
+ *  Description:
+ *      Serialize the JSON object into text that observes the given limits.
+ *
+ *  Parameters:
+ *      options [in]
+ *          The limits to observe, including the maximum size of the text.
+ *
+ *  Returns:
+ *      The JSON text, which is well-formed and no longer than
+ *      options.max_bytes (or SerializerOptions::Minimum_Bytes, if larger).
+ *
+ *  Comments:
+ *      Content that is omitted is replaced with the Elision_Marker, so the
+ *      result is suitable for logging but will generally not be equivalent
+ *      to the original JSON object.
+ */
+std::string JSON::ToString(const SerializerOptions &options) const
+{
+    return BoundedSerializer(options).Serialize(*this);
+}
+
+/*
+ *  JSON::ToCachedString()
+ *
+ *  Description:
+ *      Serialize the JSON object into text, retaining the text of objects
+ *      and arrays for reuse by subsequent calls.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The JSON text, which is identical to that produced by ToString().
+ *
+ *  Comments:
+ *      Text is not retained for a value that was accessed via a non-const
+ *      member function, as a reference to it or to a value within it might
+ *      be retained and used to modify it, nor for the values that enclose
+ *      it.  Since this function modifies the retained text, it is not const,
+ *      so a shared const JSON object must be serialized via ToString().
+ */
+std::string JSON::ToCachedString()
+{
+    std::string output;
+
+    WriteCached(output);
+
+    return output;
+}
+
+/*
+ *  JSON::ClearCache()
+ *
+ *  Description:
+ *      Discard the text retained by ToCachedString() for this JSON object
+ *      and all of the values it contains.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This releases the memory holding the retained text.  Values whose
+ *      parsing was deferred hold no retained text, so they are not parsed,
+ *      and values that were accessed via a non-const member function remain
+ *      noted as such.
+ */
+void JSON::ClearCache()
+{
+    if (annex && !Exposed())
+    {
+        // Values whose parsing was deferred hold no retained text
+        if (annex->deferred) return;
+        annex.reset();
+    }
+
+    if (std::holds_alternative<JSONObject>(value))
+    {
+        for (auto &[key, member] : std::get<JSONObject>(value).value)
+        {
+            member.ClearCache();
+        }
+    }
+    else if (std::holds_alternative<JSONArray>(value))
+    {
+        for (auto &element : std::get<JSONArray>(value).value)
+        {
+            element.ClearCache();
+        }
+    }
+}
+
+/*
+ *  JSON::WriteCached()
+ *
+ *  Description:
+ *      Append the JSON text for this JSON object to the given string, reusing
+ *      or retaining the text of objects and arrays.
+ *
+ *  Parameters:
+ *      output [in/out]
+ *          The string to which the text is appended.
+ *
+ *  Returns:
+ *      True if the text may be retained by an enclosing object or array,
+ *      which is the case only if neither this JSON object nor any value
+ *      within it was accessed via a non-const member function.
+ *
+ *  Comments:
+ *      The text of strings, numbers, and literals is not retained, as it is
+ *      produced as quickly as it would be copied.  When an object or array
+ *      retains its text, the values within it release theirs.  The values
+ *      within are reached via the value member directly, so serializing
+ *      does not itself mark them as accessed.
+ */
+bool JSON::WriteCached(std::string &output)
+{
+    // Reuse the text retained by a previous call
+    if (annex && !Exposed() && !annex->deferred)
+    {
+        output += annex->serialized;
+        return true;
+    }
+
+    // Parse the value if parsing was deferred
+    Expand();
+
+    std::size_t start = output.size();
+    bool retainable = !Exposed();
+    bool need_comma = false;
+
+    switch (GetValueType())
+    {
+        case JSONValueType::String:
+            AppendEscaped(output, std::get<JSONString>(value));
+            return retainable;
+
+        case JSONValueType::Number:
+        {
+            char buffer[Number_Text_Size];
+            output += FormatNumber(std::get<JSONNumber>(value), buffer);
+            return retainable;
+        }
+
+        case JSONValueType::Literal:
+            switch (std::get<JSONLiteral>(value))
+            {
+                case JSONLiteral::True:
+                    output += "true";
+                    break;
+
+                case JSONLiteral::False:
+                    output += "false";
+                    break;
+
+                default:
+                    output += "null";
+                    break;
+            }
+            return retainable;
+
+        case JSONValueType::Object:
+            output.push_back('{');
+            for (auto &[key, member] : std::get<JSONObject>(value).value)
+            {
+                if (need_comma) output += ", ";
+                AppendEscaped(output, key);
+                output += ": ";
+                retainable = member.WriteCached(output) && retainable;
+                need_comma = true;
+            }
+            output.push_back('}');
+            break;
+
+        case JSONValueType::Array:
+            output.push_back('[');
+            for (auto &element : std::get<JSONArray>(value).value)
+            {
+                if (need_comma) output += ", ";
+                retainable = element.WriteCached(output) && retainable;
+                need_comma = true;
+            }
+            output.push_back(']');
+            break;
+
+        default:
+            throw JSONException("Unknown JSON object type");
+    }
+
+    // Text that might be modified via a retained reference is not retained,
+    // and larger objects and arrays are produced from the text retained by
+    // the values within them
+    if (!retainable || ((output.size() - start) > Cached_Text_Granularity))
+    {
+        return retainable;
+    }
+
+    // Retain the text of the object or array in place of that of the values
+    // within it, which is thereby reused whole
+    if (std::holds_alternative<JSONObject>(value))
+    {
+        for (auto &[key, member] : std::get<JSONObject>(value).value)
+        {
+            member.annex.reset();
+        }
+    }
+    else
+    {
+        for (auto &element : std::get<JSONArray>(value).value)
+        {
+            element.annex.reset();
+        }
+    }
+
+    annex.reset(new Annex{{}, output.substr(start)});
+
+    return true;
+}
+
+} // namespace Terra::JSON
@@ -17,12 +17,8 @@
  */
 
 #include <ostream>
-#include <sstream>
-#include <format>
-#ifdef TERRA_DISABLE_STD_FORMAT
-#include <iomanip>
-#endif
 #include <terra/json/json.h>
+#include "json_escape.h"
 #include "unicode_constants.h"
 
 namespace Terra::JSON
@@ -31,244 +27,463 @@ namespace Terra::JSON
 namespace
 {
 
+// Hexadecimal digits used in Unicode escape sequences
+constexpr char Hex_Digits[] = "0123456789ABCDEF";
+
+// Output that appends to a std::string
+struct StringOutput
+{
+    std::string &string;
+
+    void push_back(char c) { string.push_back(c); }
+    void append(const char *text, std::size_t length)
+    {
+        string.append(text, length);
+    }
+};
+
+// Output that writes to a JSONTextSink
+struct SinkOutput
+{
+    JSONTextSink &sink;
+
+    void push_back(char c) { sink.Write(std::string_view(&c, 1)); }
+    void append(const char *text, std::size_t length)
+    {
+        sink.Write(std::string_view(text, length));
+    }
+};
+
+// Output that writes to a std::ostream
+struct StreamOutput
+{
+    std::ostream &o;
+
+    void push_back(char c) { o.put(c); }
+    void append(const char *text, std::size_t length)
+    {
+        o.write(text, static_cast<std::streamsize>(length));
+    }
+};
+
 /*
- *  ConvertToStdString()
+ *  InvalidString()
  *
  *  Description:
- *      This function will convert a std::u8string to std::string.  The
- *      purpose is to facilitate producing error output.
+ *      This function will produce the exception thrown when a string that
+ *      is not valid UTF-8 is serialized.
  *
  *  Parameters:
+ *      text [in]
+ *          A description of the error.
+ *
  *      string [in]
- *          The std::u8string to convert to std::string.
+ *          The string that could not be serialized.
  *
  *  Returns:
- *      The converted std::string.
+ *      The exception to throw.
  *
  *  Comments:
  *      None.
  */
-constexpr std::string ConvertToStdString(const std::u8string &string)
+JSONException InvalidString(const char *text, const std::u8string_view string)
 {
-    return {string.cbegin(), string.cend()};
+    return JSONException(std::string(text) +
+                         std::string(string.cbegin(), string.cend()));
 }
 
 /*
- *  UnicodeEscapeSequence()
+ *  AppendEscapeSequence()
  *
  *  Description:
- *      This function will accept a 16-bit integer and create a text string
- *      containing the JSON Unicode Escape Sequence for it.  For example,
- *      the value 6700 would be represented as \u1A2C.
+ *      This function will append the JSON Unicode Escape Sequence for the
+ *      given 16-bit value.  For example, the value 6700 would be represented
+ *      as \u1A2C.
  *
  *  Parameters:
+ *      output [in/out]
+ *          The output onto which the escape sequence is appended.
+ *
  *      codepoint [in]
  *          The 16-bit codepoint value to convert.
  *
  *  Returns:
- *      A string containing the JSON Unicode Escape Sequence for the given
- *      codepoint.
+ *      Nothing.
  *
  *  Comments:
  *      None.
  */
-std::string UnicodeEscapeSequence(std::uint16_t codepoint)
+template<typename Output>
+void AppendEscapeSequence(Output &output, std::uint16_t codepoint)
 {
-#ifndef TERRA_DISABLE_STD_FORMAT
-    return std::format("\\u{:04X}", codepoint);
-#else
-    std::ostringstream oss;
-    oss << "\\u" << std::setfill('0') << std::uppercase << std::hex
-        << std::setw(4) << codepoint;
-    return oss.str();
-#endif
+    const char sequence[6] =
+    {
+        '\\',
+        'u',
+        Hex_Digits[(codepoint >> 12) & 0x0f],
+        Hex_Digits[(codepoint >> 8) & 0x0f],
+        Hex_Digits[(codepoint >> 4) & 0x0f],
+        Hex_Digits[codepoint & 0x0f]
+    };
+
+    output.append(sequence, sizeof(sequence));
 }
 
-} // namespace
-
 /*
- *  operator<<()
+ *  Escape()
  *
  *  Description:
- *      Streaming operator to produce JSON text for a JSONString type.
+ *      This function will produce the JSON text for the given string,
+ *      including the surrounding quotation marks.
  *
  *  Parameters:
- *      o [in]
- *          A reference to the steaming operator onto which the JSON string
- *          will be appended.
+ *      output [in/out]
+ *          The output onto which the JSON text is appended.
  *
  *      string [in]
  *          The string to output as JSON text.
  *
  *  Returns:
- *      A reference to the streaming operator passed in as input.
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
  *
  *  Comments:
- *      None.
+ *      Runs of characters that need no escaping are appended at once, so a
+ *      string needing no escaping (e.g., most member names) is copied
+ *      directly from the given view without allocating memory.
  */
-std::ostream &operator<<(std::ostream &o, const JSONString &string)
+template<typename Output>
+void Escape(Output &output, const std::u8string_view string)
 {
-    std::size_t expected_utf8_remaining{};
-    std::uint32_t wide_character{};
+    const char8_t *p = string.data();
+    const char8_t *q = p + string.size();
 
     // Write out the string start character
-    o << '"';
+    output.push_back('"');
 
-    // Iterate over each character in the string
-    for (auto c : *string)
+    while (p < q)
     {
-        // If expecting another UTF-8 character, handle it
-        if (expected_utf8_remaining > 0)
+        // Locate the run of characters that need no escaping
+        const char8_t *run = p;
+        while ((p < q) && (*p >= 0x20) && (*p < 0x7e) && (*p != '"') &&
+               (*p != '\\'))
         {
-            // Look for 10xxxxxx octets
-            if ((c & 0xc0) != 0x80)
-            {
-                throw JSONException(std::string("Invalid UTF-8 character "
-                                                "sequence: ") +
-                                    ConvertToStdString(*string));
-            }
-
-            // Append additional bits to the wide character
-            wide_character = (wide_character << 6) | (c & 0x3f);
-
-            // Decrement the number of expected octets remaining
-            expected_utf8_remaining--;
-
-            // If this is the final UTF-8 character, produce the output
-            if (expected_utf8_remaining == 0)
-            {
-                // Verify the character is a valid Unicode value
-                if (wide_character > Unicode::Maximum_Character_Value)
-                {
-                    throw JSONException(std::string("Invalid Unicode "
-                                                    "character: ") +
-                                        ConvertToStdString(*string));
-                }
-
-                // Ensure the character code is not within the surrogate range
-                if ((wide_character >= Unicode::Surrogate_High_Min) &&
-                    (wide_character <= Unicode::Surrogate_Low_Max))
-                {
-                    throw JSONException(std::string("Invalid UTF-8 character "
-                                                    "sequence: ") +
-                                        ConvertToStdString(*string));
-                }
-
-                // Encode using surrogate code points
-                if (wide_character > Unicode::Maximum_BMP_Value)
-                {
-                    // Convert the code point values using two 16-bit values
-                    // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3)
-
-                    o << UnicodeEscapeSequence(static_cast<std::uint16_t>(
-                        Unicode::Lead_Offset + (wide_character >> 10)));
-
-                    o << UnicodeEscapeSequence(static_cast<std::uint16_t>(
-                        Unicode::Surrogate_Low_Min + (wide_character & 0x3ff)));
-                }
-                else
-                {
-                    // Produce a normal BMP code as \uXXXX
-                    o << UnicodeEscapeSequence(
-                        static_cast<std::uint16_t>(wide_character));
-                }
-            }
-
-            continue;
+            p++;
         }
+        if (p > run)
+        {
+            output.append(reinterpret_cast<const char *>(run), p - run);
+        }
+        if (p >= q) break;
 
         // Handle special characters
+        char8_t c = *p++;
         switch (c)
         {
             case '"':
-                o << "\\\"";
-                break;
+                output.append("\\\"", 2);
+                continue;
 
             case '\\':
-                o << "\\\\";
-                break;
+                output.append("\\\\", 2);
+                continue;
 
             case '\b':
-                o << "\\b";
-                break;
+                output.append("\\b", 2);
+                continue;
 
             case '\f':
-                o << "\\f";
-                break;
+                output.append("\\f", 2);
+                continue;
 
             case '\n':
-                o << "\\n";
-                break;
+                output.append("\\n", 2);
+                continue;
 
             case '\r':
-                o << "\\r";
-                break;
+                output.append("\\r", 2);
+                continue;
 
             case '\t':
-                o << "\\t";
-                break;
+                output.append("\\t", 2);
+                continue;
 
             case 0x7e:
-                o << "\\u007E";
-                break;
+                AppendEscapeSequence(output, c);
+                continue;
 
-            default:
-                // Is this a control character?
-                if (c < 0x20)
-                {
-                    o << UnicodeEscapeSequence(static_cast<std::uint16_t>(c));
-                    continue;
-                }
-
-                // Does it appear to be a UTF-8 character?
-                if (c > 0x7f)
-                {
-                    // Two octet UTF-8 sequence (110xxxxx)
-                    if ((c & 0xe0) == 0xc0)
-                    {
-                        wide_character = c & 0x3f;
-                        expected_utf8_remaining = 1;
-                        continue;
-                    }
-
-                    // Three octet UTF-8 sequence (1110xxxx)
-                    if ((c & 0xf0) == 0xe0)
-                    {
-                        wide_character = c & 0x0f;
-                        expected_utf8_remaining = 2;
-                        continue;
-                    }
-
-                    // Four octet UTF-8 sequence (11110xxx)
-                    if ((c & 0xf8) == 0xf0)
-                    {
-                        wide_character = c & 0x07;
-                        expected_utf8_remaining = 3;
-                        continue;
-                    }
-
-                    // Any other value would be an invalid character
-                    throw JSONException(std::string("Invalid UTF-8 character "
-                                                    "sequence: ") +
-                                        ConvertToStdString(*string));
-                }
-
-                // Output regular ASCII character
-                o << static_cast<char>(c);
+            case 0x7f:
+                output.push_back(static_cast<char>(c));
+                continue;
 
+            default:
                 break;
         }
-    }
 
-    // If still processing a UTF-8 sequence, that is an error
-    if (expected_utf8_remaining > 0)
-    {
-        throw JSONException(std::string("Invalid UTF-8 character sequence: ") +
-                            ConvertToStdString(*string));
+        // Is this a control character?
+        if (c < 0x20)
+        {
+            AppendEscapeSequence(output, c);
+            continue;
+        }
+
+        // Determine the length of the UTF-8 sequence
+        std::size_t expected_utf8_remaining{};
+        std::uint32_t wide_character{};
+        if ((c & 0xe0) == 0xc0)
+        {
+            // Two octet UTF-8 sequence (110xxxxx)
+            wide_character = c & 0x1f;
+            expected_utf8_remaining = 1;
+        }
+        else if ((c & 0xf0) == 0xe0)
+        {
+            // Three octet UTF-8 sequence (1110xxxx)
+            wide_character = c & 0x0f;
+            expected_utf8_remaining = 2;
+        }
+        else if ((c & 0xf8) == 0xf0)
+        {
+            // Four octet UTF-8 sequence (11110xxx)
+            wide_character = c & 0x07;
+            expected_utf8_remaining = 3;
+        }
+        else
+        {
+            // Any other value would be an invalid character
+            throw InvalidString("Invalid UTF-8 character sequence: ", string);
+        }
+
+        // Append the bits of the 10xxxxxx octets to the wide character
+        for (; expected_utf8_remaining > 0; expected_utf8_remaining--)
+        {
+            if ((p >= q) || ((*p & 0xc0) != 0x80))
+            {
+                throw InvalidString("Invalid UTF-8 character sequence: ",
+                                    string);
+            }
+            wide_character = (wide_character << 6) | (*p++ & 0x3f);
+        }
+
+        // Verify the character is a valid Unicode value
+        if (wide_character > Unicode::Maximum_Character_Value)
+        {
+            throw InvalidString("Invalid Unicode character: ", string);
+        }
+
+        // Ensure the character code is not within the surrogate range
+        if ((wide_character >= Unicode::Surrogate_High_Min) &&
+            (wide_character <= Unicode::Surrogate_Low_Max))
+        {
+            throw InvalidString("Invalid UTF-8 character sequence: ", string);
+        }
+
+        // Encode using surrogate code points
+        if (wide_character > Unicode::Maximum_BMP_Value)
+        {
+            // Convert the code point values using two 16-bit values
+            // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3)
+            AppendEscapeSequence(output,
+                                 static_cast<std::uint16_t>(
+                                     Unicode::Lead_Offset +
+                                     (wide_character >> 10)));
+            AppendEscapeSequence(output,
+                                 static_cast<std::uint16_t>(
+                                     Unicode::Surrogate_Low_Min +
+                                     (wide_character & 0x3ff)));
+        }
+        else
+        {
+            // Produce a normal BMP code as \uXXXX
+            AppendEscapeSequence(output,
+                                 static_cast<std::uint16_t>(wide_character));
+        }
     }
 
     // Write out the string end character
-    o << '"';
+    output.push_back('"');
+}
+
+} // namespace
+
+/*
+ *  AppendEscaped()
+ *
+ *  Description:
+ *      Append the JSON text for the given string to a std::string.
+ *
+ *  Parameters:
+ *      output [in/out]
+ *          The string onto which the JSON text is appended.
+ *
+ *      string [in]
+ *          The string to output as JSON text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+void AppendEscaped(std::string &output, const std::u8string_view string)
+{
+    StringOutput string_output{output};
+
+    Escape(string_output, string);
+}
+
+/*
+ *  AppendEscaped()
+ *
+ *  Description:
+ *      Append the JSON text for the given JSONString to a std::string.
+ *
+ *  Parameters:
+ *      output [in/out]
+ *          The string onto which the JSON text is appended.
+ *
+ *      string [in]
+ *          The string to output as JSON text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+void AppendEscaped(std::string &output, const JSONString &string)
+{
+    StringOutput string_output{output};
+
+    Escape(string_output, std::u8string_view(string.value));
+}
+
+/*
+ *  WriteEscaped()
+ *
+ *  Description:
+ *      Write the JSON text for the given string to a std::ostream.
+ *
+ *  Parameters:
+ *      o [in]
+ *          The stream onto which the JSON text is written.
+ *
+ *      string [in]
+ *          The string to output as JSON text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteEscaped(std::ostream &o, const std::u8string_view string)
+{
+    StreamOutput stream_output{o};
+
+    Escape(stream_output, string);
+}
+
+/*
+ *  WriteEscaped()
+ *
+ *  Description:
+ *      Write the JSON text for the given JSONString to a std::ostream.
+ *
+ *  Parameters:
+ *      o [in]
+ *          The stream onto which the JSON text is written.
+ *
+ *      string [in]
+ *          The string to output as JSON text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteEscaped(std::ostream &o, const JSONString &string)
+{
+    StreamOutput stream_output{o};
+
+    Escape(stream_output, std::u8string_view(string.value));
+}
+
+/*
+ *  WriteEscaped()
+ *
+ *  Description:
+ *      Write the JSON text for the given string to a JSONTextSink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the JSON text is written.
+ *
+ *      string [in]
+ *          The string to output as JSON text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteEscaped(JSONTextSink &sink, const std::u8string_view string)
+{
+    SinkOutput sink_output{sink};
+
+    Escape(sink_output, string);
+}
+
+/*
+ *  WriteEscaped()
+ *
+ *  Description:
+ *      Write the JSON text for the given JSONString to a JSONTextSink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the JSON text is written.
+ *
+ *      string [in]
+ *          The string to output as JSON text.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteEscaped(JSONTextSink &sink, const JSONString &string)
+{
+    SinkOutput sink_output{sink};
+
+    Escape(sink_output, std::u8string_view(string.value));
+}
+
+/*
+ *  operator<<()
+ *
+ *  Description:
+ *      Streaming operator to produce JSON text for a JSONString type.
+ *
+ *  Parameters:
+ *      o [in]
+ *          A reference to the steaming operator onto which the JSON string
+ *          will be appended.
+ *
+ *      string [in]
+ *          The string to output as JSON text.
+ *
+ *  Returns:
+ *      A reference to the streaming operator passed in as input.
+ *
+ *  Comments:
+ *      None.
+ */
+std::ostream &operator<<(std::ostream &o, const JSONString &string)
+{
+    WriteEscaped(o, string);
 
     return o;
 }
@@ -290,11 +505,11 @@ std::ostream &operator<<(std::ostream &o, const JSONString &string)
  */
 std::string JSONString::ToString() const
 {
-    std::ostringstream oss;
+    std::string output;
 
-    oss << *this;
+    AppendEscaped(output, *this);
 
-    return oss.str();
+    return output;
 }
 
 } // namespace Terra::JSON
@@ -0,0 +1,353 @@
+/*
+ *  json_transcode.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements functions that produce UTF-8 text.
+ *
+ *      JSON text is predominantly ASCII, so transcoding examines several
+ *      code units at once using 64-bit words and copies runs of ASCII
+ *      characters without examining each one individually.  Only the other
+ *      characters are encoded one at a time.  The output is allocated once
+ *      at one octet per code unit and written through a pointer, growing
+ *      only if other characters require more space.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <terra/json/json.h>
+#include "json_transcode.h"
+#include "unicode_constants.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Byte order mark
+constexpr std::uint32_t Byte_Order_Mark = 0xfeff;
+
+/*
+ *  SwapOctets()
+ *
+ *  Description:
+ *      Reverse the order of the octets in the given code unit.
+ *
+ *  Parameters:
+ *      unit [in]
+ *          The code unit.
+ *
+ *  Returns:
+ *      The code unit with its octets reversed.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr char16_t SwapOctets(char16_t unit)
+{
+    return static_cast<char16_t>((unit >> 8) | (unit << 8));
+}
+
+constexpr char32_t SwapOctets(char32_t unit)
+{
+    return ((unit >> 24) & 0x0000'00ff) | ((unit >> 8) & 0x0000'ff00) |
+           ((unit << 8) & 0x00ff'0000) | ((unit << 24) & 0xff00'0000);
+}
+
+/*
+ *  ASCIIMask()
+ *
+ *  Description:
+ *      Return the mask of the bits in a 64-bit word that must be zero if
+ *      every code unit in the word is an ASCII character.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The mask.
+ *
+ *  Comments:
+ *      The octets within each code unit might be reversed, in which case
+ *      the mask is reversed as well.
+ */
+template<typename T, bool Swap>
+constexpr std::uint64_t ASCIIMask()
+{
+    if constexpr (sizeof(T) == 2)
+    {
+        return Swap ? 0x80ff'80ff'80ff'80ff : 0xff80'ff80'ff80'ff80;
+    }
+    else
+    {
+        return Swap ? 0x80ff'ffff'80ff'ffff : 0xffff'ff80'ffff'ff80;
+    }
+}
+
+/*
+ *  EncodeUTF8()
+ *
+ *  Description:
+ *      Write the UTF-8 encoding of the given character to a buffer.
+ *
+ *  Parameters:
+ *      out [out]
+ *          The buffer to which the character is written, which must have
+ *          space for at least four octets.
+ *
+ *      code_value [in]
+ *          The Unicode character to write.
+ *
+ *  Returns:
+ *      A pointer to the octet following those written.
+ *
+ *  Comments:
+ *      The character is assumed to be valid.
+ */
+char8_t *EncodeUTF8(char8_t *out, std::uint32_t code_value)
+{
+    if (code_value <= 0x7f)
+    {
+        *out++ = static_cast<char8_t>(code_value);
+    }
+    else if (code_value <= 0x7ff)
+    {
+        *out++ = 0xc0 | ((code_value >> 6) & 0x1f);
+        *out++ = 0x80 | ((code_value     ) & 0x3f);
+    }
+    else if (code_value <= 0xffff)
+    {
+        *out++ = 0xe0 | ((code_value >> 12) & 0x0f);
+        *out++ = 0x80 | ((code_value >>  6) & 0x3f);
+        *out++ = 0x80 | ((code_value      ) & 0x3f);
+    }
+    else
+    {
+        *out++ = 0xf0 | ((code_value >> 18) & 0x07);
+        *out++ = 0x80 | ((code_value >> 12) & 0x3f);
+        *out++ = 0x80 | ((code_value >>  6) & 0x3f);
+        *out++ = 0x80 | ((code_value      ) & 0x3f);
+    }
+
+    return out;
+}
+
+/*
+ *  Transcode()
+ *
+ *  Description:
+ *      Transcode UTF-16 or UTF-32 text to UTF-8.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to transcode, excluding any byte order mark.
+ *
+ *  Returns:
+ *      The UTF-8 text.  A JSONException is thrown if the text contains an
+ *      unpaired surrogate or a value that is not a Unicode character.
+ *
+ *  Comments:
+ *      If Swap is true, the order of octets within each code unit is
+ *      reversed before the code unit is examined.
+ */
+template<typename T, bool Swap>
+std::u8string Transcode(const std::basic_string_view<T> text)
+{
+    constexpr std::size_t Units_Per_Word = sizeof(std::uint64_t) / sizeof(T);
+    constexpr std::uint64_t Mask = ASCIIMask<T, Swap>();
+    // Most JSON text is ASCII, so allocate one octet per code unit, which
+    // is grown only as needed to hold other characters
+    std::u8string string(text.size(), u8'\0');
+    char8_t *out = string.data();
+    std::size_t i = 0;
+
+    while (i < text.size())
+    {
+        // Copy runs of ASCII characters a word at a time
+        while (i + Units_Per_Word <= text.size())
+        {
+            std::uint64_t word;
+            std::memcpy(&word, text.data() + i, sizeof(word));
+            if ((word & Mask) != 0) break;
+            for (std::size_t j = 0; j < Units_Per_Word; j++)
+            {
+                T unit = text[i + j];
+                if constexpr (Swap) unit = SwapOctets(unit);
+                out[j] = static_cast<char8_t>(unit);
+            }
+            out += Units_Per_Word;
+            i += Units_Per_Word;
+        }
+        if (i >= text.size()) break;
+
+        // Encode the next character
+        std::uint32_t code_value = text[i];
+        if constexpr (Swap) code_value = SwapOctets(text[i]);
+        std::size_t position = i++;
+
+        if ((code_value >= Unicode::Surrogate_High_Min) &&
+            (code_value <= Unicode::Surrogate_Low_Max))
+        {
+            std::uint32_t low_code_value = 0;
+            if constexpr (sizeof(T) == 2)
+            {
+                if (i < text.size())
+                {
+                    low_code_value = text[i];
+                    if constexpr (Swap) low_code_value = SwapOctets(text[i]);
+                }
+            }
+            if ((code_value > Unicode::Surrogate_High_Max) ||
+                (low_code_value < Unicode::Surrogate_Low_Min) ||
+                (low_code_value > Unicode::Surrogate_Low_Max))
+            {
+                throw JSONException("Invalid surrogate at code unit " +
+                                    std::to_string(position));
+            }
+            code_value = (code_value << 10) + low_code_value +
+                         Unicode::Surrogate_Offset;
+            i++;
+        }
+        else if (code_value > Unicode::Maximum_Character_Value)
+        {
+            throw JSONException("Invalid character at code unit " +
+                                std::to_string(position));
+        }
+
+        // Ensure there is space for this character and at least one octet
+        // for each remaining code unit
+        std::size_t length = out - string.data();
+        std::size_t required = length + 4 + (text.size() - i);
+        if (required > string.size())
+        {
+            string.resize(std::max(required, string.size() * 2));
+            out = string.data() + length;
+        }
+
+        out = EncodeUTF8(out, code_value);
+    }
+
+    string.resize(out - string.data());
+
+    return string;
+}
+
+/*
+ *  TranscodeText()
+ *
+ *  Description:
+ *      Transcode UTF-16 or UTF-32 text that might begin with a byte order
+ *      mark to UTF-8.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to transcode.
+ *
+ *  Returns:
+ *      The UTF-8 text, without the byte order mark.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename T>
+std::u8string TranscodeText(std::basic_string_view<T> text)
+{
+    if (!text.empty() && (text.front() == SwapOctets(T(Byte_Order_Mark))))
+    {
+        return Transcode<T, true>(text.substr(1));
+    }
+    if (!text.empty() && (text.front() == T(Byte_Order_Mark)))
+    {
+        text.remove_prefix(1);
+    }
+
+    return Transcode<T, false>(text);
+}
+
+} // namespace
+
+/*
+ *  AppendUTF8()
+ *
+ *  Description:
+ *      Append the UTF-8 encoding of the given character to a string.
+ *
+ *  Parameters:
+ *      string [in/out]
+ *          The string onto which the character is appended.
+ *
+ *      code_value [in]
+ *          The Unicode character to append.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The character is assumed to be valid.
+ */
+void AppendUTF8(std::u8string &string, std::uint32_t code_value)
+{
+    char8_t octets[4];
+
+    string.append(octets, EncodeUTF8(octets, code_value));
+}
+
+/*
+ *  TranscodeToUTF8()
+ *
+ *  Description:
+ *      Transcode UTF-16 text to UTF-8.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The UTF-16 text, which may begin with a byte order mark.
+ *
+ *  Returns:
+ *      The UTF-8 text, without the byte order mark.  A JSONException is
+ *      thrown if the text contains an unpaired surrogate.
+ *
+ *  Comments:
+ *      If the byte order mark indicates that the order of octets is
+ *      reversed, each code unit is swapped.
+ */
+std::u8string TranscodeToUTF8(const std::u16string_view text)
+{
+    return TranscodeText(text);
+}
+
+/*
+ *  TranscodeToUTF8()
+ *
+ *  Description:
+ *      Transcode UTF-32 text to UTF-8.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The UTF-32 text, which may begin with a byte order mark.
+ *
+ *  Returns:
+ *      The UTF-8 text, without the byte order mark.  A JSONException is
+ *      thrown if the text contains a surrogate or a value that is not a
+ *      Unicode character.
+ *
+ *  Comments:
+ *      If the byte order mark indicates that the order of octets is
+ *      reversed, each code unit is swapped.
+ */
+std::u8string TranscodeToUTF8(const std::u32string_view text)
+{
+    return TranscodeText(text);
+}
+
+} // namespace Terra::JSON
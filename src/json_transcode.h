@@ -0,0 +1,38 @@
+/*
+ *  json_transcode.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines functions that produce UTF-8 text, including
+ *      functions that transcode UTF-16 and UTF-32 text so that it may be
+ *      given to the JSONParser.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Terra::JSON
+{
+
+// Append the UTF-8 encoding of the given valid character to a string
+void AppendUTF8(std::u8string &string, std::uint32_t code_value);
+
+// Transcode UTF-16 or UTF-32 text to UTF-8, removing any byte order mark and
+// swapping the order of octets if the byte order mark indicates that it is
+// reversed; a JSONException is thrown if the text is not valid
+std::u8string TranscodeToUTF8(const std::u16string_view text);
+std::u8string TranscodeToUTF8(const std::u32string_view text);
+
+} // namespace Terra::JSON
@@ -0,0 +1,104 @@
+/*
+ *  json_validate.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements the Validate() function, which verifies that
+ *      text is well-formed JSON without producing JSON objects.  Validation
+ *      requires no memory allocation and reports errors via the returned
+ *      ValidationResult rather than by throwing exceptions, making it
+ *      suitable for checking untrusted input before it is forwarded or
+ *      parsed.
+ *
+ *      In addition to the JSON grammar, strings must be valid UTF-8 and
+ *      escaped UTF-16 surrogates must appear in pairs, as is required by
+ *      JSONParser.  Since RFC 8259 only recommends that names within an
+ *      object be unique, duplicate names are not detected.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <terra/json/json.h>
+#include "json_scan.h"
+
+namespace Terra::JSON
+{
+
+/*
+ *  Validate()
+ *
+ *  Description:
+ *      Verify that the given text is well-formed JSON.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The UTF-8 text to verify.
+ *
+ *      max_depth [in]
+ *          The maximum depth to which objects and arrays may be nested, or
+ *          ParserOptions::No_Limit if there is no limit.
+ *
+ *  Returns:
+ *      The result of validation.  If the text is not well-formed, the result
+ *      holds the offset of the first error and a description of it.
+ *
+ *  Comments:
+ *      A limit on nesting protects against exhausting the stack when given
+ *      deeply nested input.
+ */
+ValidationResult Validate(const std::u8string_view content,
+                          std::size_t max_depth) noexcept
+{
+    JSONScanner scanner({.strict_numbers = true,
+                         .utf8 = true,
+                         .max_depth = max_depth});
+    ValidationResult result;
+
+    result.valid = scanner.Scan(content);
+    if (!result.valid)
+    {
+        result.offset = scanner.ErrorOffset();
+        result.error = scanner.ErrorText();
+    }
+
+    return result;
+}
+
+/*
+ *  Validate()
+ *
+ *  Description:
+ *      Verify that the given text is well-formed JSON.
+ *
+ *  Parameters:
+ *      content [in]
+ *          The UTF-8 text to verify.
+ *
+ *      max_depth [in]
+ *          The maximum depth to which objects and arrays may be nested, or
+ *          ParserOptions::No_Limit if there is no limit.
+ *
+ *  Returns:
+ *      The result of validation.  If the text is not well-formed, the result
+ *      holds the offset of the first error and a description of it.
+ *
+ *  Comments:
+ *      None.
+ */
+ValidationResult Validate(const std::string_view content,
+                          std::size_t max_depth) noexcept
+{
+    return Validate(
+        std::u8string_view(reinterpret_cast<const char8_t *>(content.data()),
+                           content.length()),
+        max_depth);
+}
+
+} // namespace Terra::JSON
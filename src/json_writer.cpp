@@ -0,0 +1,565 @@
+/*
+ *  json_writer.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements WriteJSONText(), which writes the JSON text for
+ *      JSON objects to a JSONTextSink as the text is produced.  Unlike
+ *      ToString(), no string holding the entire text is produced, so the
+ *      text may be written directly to its destination (e.g., the output
+ *      iterator of std::format).
+ *
+ *      The Default style produces the same text as ToString().  The Indented
+ *      style produces the same text as a JSONFormatter, but without first
+ *      producing and then parsing the unformatted text.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <terra/json/json.h>
+#include "json_escape.h"
+#include "json_number_text.h"
+
+namespace Terra::JSON
+{
+
+namespace
+{
+
+// Spaces written for indentation, several at a time
+constexpr std::string_view Spaces = "                                ";
+
+// Writer of JSON text in a given style
+class TextWriter
+{
+    public:
+        TextWriter(JSONTextSink &sink,
+                   JSONTextStyle style,
+                   std::size_t indentation) :
+            sink{sink},
+            style{style},
+            indentation{indentation},
+            current_indentation{0}
+        {
+        }
+        ~TextWriter() = default;
+
+        void Write(const JSON &json);
+        void Write(const JSONString &string) { WriteEscaped(sink, string); }
+        void Write(const JSONNumber &number);
+        void Write(const JSONObject &object);
+        void Write(const JSONArray &array);
+        void Write(const JSONLiteral literal);
+
+    protected:
+        void Open(char c);
+        void Separate();
+        void Close(char c);
+        void Indent();
+
+        JSONTextSink &sink;                     // Destination for the text
+        JSONTextStyle style;                    // Layout of the text
+        std::size_t indentation;                // Indentation per level
+        std::size_t current_indentation;        // Current indentation
+};
+
+/*
+ *  TextWriter::Write()
+ *
+ *  Description:
+ *      Write the JSON text for the given JSON object.
+ *
+ *  Parameters:
+ *      json [in]
+ *          The JSON object to write.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the object cannot be written.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Write(const JSON &json)
+{
+    switch (json.GetValueType())
+    {
+        case JSONValueType::String:
+            Write(json.GetValue<JSONString>());
+            break;
+
+        case JSONValueType::Number:
+            Write(json.GetValue<JSONNumber>());
+            break;
+
+        case JSONValueType::Object:
+            Write(json.GetValue<JSONObject>());
+            break;
+
+        case JSONValueType::Array:
+            Write(json.GetValue<JSONArray>());
+            break;
+
+        case JSONValueType::Literal:
+            Write(json.GetValue<JSONLiteral>());
+            break;
+
+        default:
+            throw JSONException("Unknown JSON object type");
+    }
+}
+
+/*
+ *  TextWriter::Write()
+ *
+ *  Description:
+ *      Write the JSON text for the given number.
+ *
+ *  Parameters:
+ *      number [in]
+ *          The number to write.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown for infinity or NaN.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Write(const JSONNumber &number)
+{
+    char buffer[Number_Text_Size];
+
+    sink.Write(FormatNumber(number, buffer));
+}
+
+/*
+ *  TextWriter::Write()
+ *
+ *  Description:
+ *      Write the JSON text for the given object.
+ *
+ *  Parameters:
+ *      object [in]
+ *          The object to write.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if a member cannot be written.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Write(const JSONObject &object)
+{
+    bool need_comma = false;
+
+    Open('{');
+
+    for (const auto &[key, value] : *object)
+    {
+        if (need_comma) Separate();
+        Indent();
+        WriteEscaped(sink, key);
+        sink.Write((style == JSONTextStyle::Compact) ? ":" : ": ");
+        Write(value);
+        need_comma = true;
+    }
+
+    Close('}');
+}
+
+/*
+ *  TextWriter::Write()
+ *
+ *  Description:
+ *      Write the JSON text for the given array.
+ *
+ *  Parameters:
+ *      array [in]
+ *          The array to write.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if an element cannot be written.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Write(const JSONArray &array)
+{
+    bool need_comma = false;
+
+    Open('[');
+
+    for (const auto &element : *array)
+    {
+        if (need_comma) Separate();
+        Indent();
+        Write(element);
+        need_comma = true;
+    }
+
+    Close(']');
+}
+
+/*
+ *  TextWriter::Write()
+ *
+ *  Description:
+ *      Write the JSON text for the given literal.
+ *
+ *  Parameters:
+ *      literal [in]
+ *          The literal to write.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the literal is not valid.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Write(const JSONLiteral literal)
+{
+    switch (literal)
+    {
+        case JSONLiteral::True:
+            sink.Write("true");
+            break;
+
+        case JSONLiteral::False:
+            sink.Write("false");
+            break;
+
+        case JSONLiteral::Null:
+            sink.Write("null");
+            break;
+
+        default:
+            throw JSONException("Invalid JSON Literal value");
+    }
+}
+
+/*
+ *  TextWriter::Open()
+ *
+ *  Description:
+ *      Write the character that opens an object or array.
+ *
+ *  Parameters:
+ *      c [in]
+ *          The opening character.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      As with the JSONFormatter, the Indented style places each member or
+ *      element on a separate line, even if there are none.
+ */
+void TextWriter::Open(char c)
+{
+    sink.Write(std::string_view(&c, 1));
+
+    if (style == JSONTextStyle::Indented)
+    {
+        sink.Write("\n");
+        current_indentation += indentation;
+    }
+}
+
+/*
+ *  TextWriter::Separate()
+ *
+ *  Description:
+ *      Write the separator between members or elements.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Separate()
+{
+    switch (style)
+    {
+        case JSONTextStyle::Compact:
+            sink.Write(",");
+            break;
+
+        case JSONTextStyle::Indented:
+            sink.Write(",\n");
+            break;
+
+        default:
+            sink.Write(", ");
+            break;
+    }
+}
+
+/*
+ *  TextWriter::Close()
+ *
+ *  Description:
+ *      Write the character that closes an object or array.
+ *
+ *  Parameters:
+ *      c [in]
+ *          The closing character.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Close(char c)
+{
+    if (style == JSONTextStyle::Indented)
+    {
+        current_indentation -= indentation;
+        sink.Write("\n");
+        Indent();
+    }
+
+    sink.Write(std::string_view(&c, 1));
+}
+
+/*
+ *  TextWriter::Indent()
+ *
+ *  Description:
+ *      Write the indentation for the current level when using the Indented
+ *      style.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Indent()
+{
+    if (style != JSONTextStyle::Indented) return;
+
+    for (std::size_t remaining = current_indentation; remaining > 0;)
+    {
+        std::size_t length = std::min(remaining, Spaces.size());
+        sink.Write(Spaces.substr(0, length));
+        remaining -= length;
+    }
+}
+
+} // namespace
+
+/*
+ *  WriteJSONText()
+ *
+ *  Description:
+ *      Write the JSON text for the given value to the given sink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the text is written.
+ *
+ *      json [in]
+ *          The value to write.
+ *
+ *      style [in]
+ *          The layout of the text.
+ *
+ *      indentation [in]
+ *          The indentation per level for the Indented style.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the value cannot be written,
+ *      in which case some text might have been written to the sink.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteJSONText(JSONTextSink &sink,
+                   const JSON &json,
+                   JSONTextStyle style,
+                   std::size_t indentation)
+{
+    TextWriter(sink, style, indentation).Write(json);
+}
+
+/*
+ *  WriteJSONText()
+ *
+ *  Description:
+ *      Write the JSON text for the given string to the given sink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the text is written.
+ *
+ *      string [in]
+ *          The string to write.
+ *
+ *      style [in]
+ *          The layout of the text, which does not affect strings.
+ *
+ *      indentation [in]
+ *          The indentation per level, which does not affect strings.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the string is not valid UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONString &string,
+                   JSONTextStyle style,
+                   std::size_t indentation)
+{
+    TextWriter(sink, style, indentation).Write(string);
+}
+
+/*
+ *  WriteJSONText()
+ *
+ *  Description:
+ *      Write the JSON text for the given number to the given sink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the text is written.
+ *
+ *      number [in]
+ *          The number to write.
+ *
+ *      style [in]
+ *          The layout of the text, which does not affect numbers.
+ *
+ *      indentation [in]
+ *          The indentation per level, which does not affect numbers.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown for infinity or NaN.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONNumber &number,
+                   JSONTextStyle style,
+                   std::size_t indentation)
+{
+    TextWriter(sink, style, indentation).Write(number);
+}
+
+/*
+ *  WriteJSONText()
+ *
+ *  Description:
+ *      Write the JSON text for the given object to the given sink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the text is written.
+ *
+ *      object [in]
+ *          The object to write.
+ *
+ *      style [in]
+ *          The layout of the text.
+ *
+ *      indentation [in]
+ *          The indentation per level for the Indented style.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the object cannot be written.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONObject &object,
+                   JSONTextStyle style,
+                   std::size_t indentation)
+{
+    TextWriter(sink, style, indentation).Write(object);
+}
+
+/*
+ *  WriteJSONText()
+ *
+ *  Description:
+ *      Write the JSON text for the given array to the given sink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the text is written.
+ *
+ *      array [in]
+ *          The array to write.
+ *
+ *      style [in]
+ *          The layout of the text.
+ *
+ *      indentation [in]
+ *          The indentation per level for the Indented style.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the array cannot be written.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONArray &array,
+                   JSONTextStyle style,
+                   std::size_t indentation)
+{
+    TextWriter(sink, style, indentation).Write(array);
+}
+
+/*
+ *  WriteJSONText()
+ *
+ *  Description:
+ *      Write the JSON text for the given literal to the given sink.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to which the text is written.
+ *
+ *      literal [in]
+ *          The literal to write.
+ *
+ *      style [in]
+ *          The layout of the text, which does not affect literals.
+ *
+ *      indentation [in]
+ *          The indentation per level, which does not affect literals.
+ *
+ *  Returns:
+ *      Nothing.  A JSONException is thrown if the literal is not valid.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteJSONText(JSONTextSink &sink,
+                   const JSONLiteral literal,
+                   JSONTextStyle style,
+                   std::size_t indentation)
+{
+    TextWriter(sink, style, indentation).Write(literal);
+}
+
+} // namespace Terra::JSON
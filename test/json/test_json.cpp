@@ -15,6 +15,7 @@
  *      None.
  */
 
+#include <utility>
 #include <terra/json/json.h>
 #include <terra/stf/stf.h>
 
@@ -743,3 +744,228 @@ STF_TEST(JSON, ToString)
     STF_ASSERT_EQ(JSONValueType::Literal, object["Key10"].GetValueType());
     STF_ASSERT_EQ(JSONValueType::Array, object["Key11"].GetValueType());
 }
+
+// Test serialization within a byte budget
+STF_TEST(JSON, ToStringBudget)
+{
+    JSON json = JSONParser().Parse(R"(
+        {
+            "name": "sensor",
+            "readings": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14],
+            "tags": {"site": "north", "unit": "celsius"},
+            "note": "The quick brown fox jumps over the lazy dog"
+        })");
+
+    // A sufficient budget produces the same text as ToString()
+    STF_ASSERT_EQ(json.ToString(), json.ToString(SerializerOptions{}));
+    STF_ASSERT_EQ(json.ToString(),
+                  json.ToString({.max_bytes = json.ToString().size()}));
+    JSON mixed = JSONParser().Parse(
+        R"({"a\n": [true, null, -0.0, 1.5e300, {}, []], "b": "\u00e9\"x"})");
+    STF_ASSERT_EQ(mixed.ToString(),
+                  mixed.ToString({.max_bytes = mixed.ToString().size()}));
+
+    // Every budget produces well-formed text of no more than the budget
+    for (std::size_t budget = 0; budget <= json.ToString().size(); budget++)
+    {
+        std::string text = json.ToString({.max_bytes = budget});
+        STF_ASSERT_LE(text.size(),
+                      std::max(budget, SerializerOptions::Minimum_Bytes));
+        STF_ASSERT_NO_EXCEPTION([&]() { JSONParser().Parse(text); });
+        if (budget < json.ToString().size())
+        {
+            STF_ASSERT_NE(std::string::npos, text.find(R"(\u2026)"));
+        }
+    }
+
+    // Check the content when elided
+    STF_ASSERT_EQ(std::string(R"({"name": "sensor", "\u2026": "\u2026"})"),
+                  json.ToString({.max_bytes = 40}));
+    STF_ASSERT_EQ(std::string(R"({"name": "sensor", "note": "The quick brown )"
+                              R"(fox jumps over the lazy dog\u2026"})"),
+                  json.ToString({.max_bytes = 80}));
+    STF_ASSERT_EQ(std::string(R"({"name": "sensor", "note": "The quick brown )"
+                              R"(fox jumps over the lazy dog", "readings": )"
+                              R"([1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, )"
+                              R"("\u2026"]})"),
+                  json.ToString({.max_bytes = 150}));
+}
+
+// Test serialization of long strings
+STF_TEST(JSON, ToStringLongStrings)
+{
+    JSON json = JSONArray{JSONString("abcdefghij"), JSONString("xyz")};
+
+    // Observe the per-string limit
+    STF_ASSERT_EQ(std::string(R"(["abcd\u2026", "xyz"])"),
+                  json.ToString({.max_string_length = 4}));
+
+    // Do not divide multi-octet characters
+    json = JSONString(u8"\u00e9\u00e9\u00e9");
+    STF_ASSERT_EQ(std::string(R"("\u00E9\u2026")"),
+                  json.ToString({.max_string_length = 3}));
+
+    // Shorten a string that does not fit within the budget
+    json = JSONString(std::string(100, 'a'));
+    std::string text = json.ToString({.max_bytes = 40});
+    STF_ASSERT_EQ(std::string("\"") + std::string(32, 'a') + "\\u2026\"",
+                  text);
+
+    // Scalars that cannot be shortened are replaced when they do not fit
+    json = JSONArray{JSONNumber(1),
+                     JSONNumber(123456789012345678),
+                     JSONNumber(123456789012345678)};
+    STF_ASSERT_EQ(std::string(R"([1, "\u2026"])"),
+                  json.ToString({.max_bytes = 32}));
+}
+
+// Test serialization that retains the text of objects and arrays
+STF_TEST(JSON, ToCachedString)
+{
+    JSON json = JSONParser().Parse(R"(
+        {
+            "status": "ok",
+            "items": [{"id": 1, "tags": ["a", "b"]}, {"id": 2, "tags": []}],
+            "meta": {"count": 2, "next": null, "flags": [true, false]}
+        })");
+
+    std::string expected = json.ToString();
+    STF_ASSERT_EQ(expected, json.ToCachedString());
+    STF_ASSERT_EQ(expected, json.ToCachedString());
+
+    // Modifications via non-const access are reflected
+    json["items"][1]["tags"].GetValue<JSONArray>().value.push_back("c");
+    json["meta"]["count"] = 3;
+    STF_ASSERT_EQ(json.ToString(), json.ToCachedString());
+    STF_ASSERT_NE(expected, json.ToCachedString());
+
+    // Replacing a value is reflected
+    json["items"] = JSONArray{};
+    STF_ASSERT_EQ(json.ToString(), json.ToCachedString());
+    (*json).emplace<JSONArray>(JSONArray{JSONNumber(1)});
+    STF_ASSERT_EQ(std::string("[1]"), json.ToCachedString());
+
+    // Copies do not retain the text, and modifying them is reflected
+    JSON copy = json;
+    copy[0] = "x";
+    STF_ASSERT_EQ(std::string("[1]"), json.ToCachedString());
+    STF_ASSERT_EQ(std::string(R"(["x"])"), copy.ToCachedString());
+}
+
+// Test that modification via a retained reference is reflected
+STF_TEST(JSON, ToCachedStringRetainedReference)
+{
+    JSON json = JSONParser().Parse(R"({"a": {"n": 1}, "b": 2})");
+    JSON &n = json[u8"a"][u8"n"];
+
+    STF_ASSERT_EQ(std::string(R"({"a": {"n": 1}, "b": 2})"),
+                  json.ToCachedString());
+    n = 5;
+    STF_ASSERT_EQ(std::string(R"({"a": {"n": 5}, "b": 2})"),
+                  json.ToCachedString());
+
+    // Values within an object or array reached via a retained reference
+    JSON document = JSONParser().Parse(R"({"a": {"b": [1, 2]}, "c": [3]})");
+    JSONArray &b = document["a"]["b"].GetValue<JSONArray>();
+    STF_ASSERT_EQ(document.ToString(), document.ToCachedString());
+    b.value[0] = 5;
+    STF_ASSERT_EQ(std::string(R"({"a": {"b": [5, 2]}, "c": [3]})"),
+                  document.ToCachedString());
+
+    // Discarding the retained text does not forget the retained reference
+    document.ClearCache();
+    STF_ASSERT_EQ(document.ToString(), document.ToCachedString());
+    b.value[1] = 6;
+    STF_ASSERT_EQ(std::string(R"({"a": {"b": [5, 6]}, "c": [3]})"),
+                  document.ToCachedString());
+
+    // Values within an object moved into a JSON object might be referenced
+    JSONObject object{{"x", JSONArray{1}}};
+    JSON &x = object["x"];
+    JSON moved(std::move(object));
+    STF_ASSERT_EQ(std::string(R"({"x": [1]})"), moved.ToCachedString());
+    x.GetValue<JSONArray>().value[0] = 2;
+    STF_ASSERT_EQ(std::string(R"({"x": [2]})"), moved.ToCachedString());
+
+    // Lazily parsed values are parsed when serialized
+    JSON lazy = JSONParser({.lazy = true}).Parse(R"({"x": [1, {"y": 2}]})");
+    lazy.ClearCache();
+    STF_ASSERT_EQ(std::string(R"({"x": [1, {"y": 2}]})"),
+                  lazy.ToCachedString());
+}
+
+// Test that only objects and arrays having little text retain it
+STF_TEST(JSON, ToCachedStringGranularity)
+{
+    JSON built = JSONObject{{"status", "ok"}, {"items", JSONArray{}}};
+    JSONArray &built_items = built["items"].GetValue<JSONArray>();
+    for (int i = 0; i < 1000; i++)
+    {
+        built_items.Emplace(
+            JSONObject{{"id", i}, {"tags", JSONArray{"a", "b"}}});
+    }
+    STF_ASSERT_EQ(built.ToString(), built.ToCachedString());
+
+    // No reference to the content of a copy can be retained, so each
+    // element of the copy retains its text, while the document and array
+    // are too large to do so
+    JSON json = built;
+    STF_ASSERT_EQ(json.ToString(), json.ToCachedString());
+
+    // Modifying a value via a const reference cast away is not noted, which
+    // shows that the text retained by the enclosing element is reused
+    const JSON &element = std::as_const(json)[u8"items"][7];
+    const_cast<JSON &>(element[u8"id"]).GetValue<JSONNumber>() = 700;
+    STF_ASSERT_NE(json.ToString(), json.ToCachedString());
+    json.ClearCache();
+    STF_ASSERT_EQ(json.ToString(), json.ToCachedString());
+
+    // Modification via retained references is reflected
+    JSON &tags = json[u8"items"][5][u8"tags"];
+    JSON &status = json[u8"status"];
+    STF_ASSERT_EQ(json.ToString(), json.ToCachedString());
+    tags.GetValue<JSONArray>().value.clear();
+    status = "done";
+    STF_ASSERT_EQ(json.ToString(), json.ToCachedString());
+    STF_ASSERT_EQ(std::string(R"({"id": 5, "tags": []})"),
+                  json[u8"items"][5].ToCachedString());
+}
+
+// Test moving values out of a parsed document
+STF_TEST(JSON, TakeAndExtract)
+{
+    JSON json = JSONParser().Parse(
+        R"({"name": "a long string that is not stored inline",)"
+        R"( "list": [[1, 2], "x", {"y": true}], "count": 3})");
+
+    // Taking a string moves its storage out of the document
+    const char8_t *characters =
+        (*json[u8"name"].GetValue<JSONString>()).data();
+    std::u8string name = json[u8"name"].TakeString();
+    STF_ASSERT_EQ(characters, name.data());
+    STF_ASSERT_TRUE((*json[u8"name"].GetValue<JSONString>()).empty());
+
+    STF_ASSERT_EQ(3, json[u8"count"].Take<JSONNumber>().GetInteger());
+    STF_ASSERT_EXCEPTION_E([&]() { json[u8"count"].TakeArray(); },
+                           JSONException);
+
+    // Extracting a member moves both its key and value
+    const JSON *list = json.GetValue<JSONObject>().Find(JSONKey(u8"list"));
+    auto node = json.ExtractMember("list");
+    STF_ASSERT_FALSE(node.empty());
+    STF_ASSERT_EQ(list, &node.mapped());
+    STF_ASSERT_EQ(std::u8string(u8"list"), node.key());
+    STF_ASSERT_TRUE(json.ExtractMember(u8"list").empty());
+    STF_ASSERT_EQ(R"({"count": 0, "name": ""})", json.ToString());
+
+    // Consume the elements of the array one at a time
+    std::vector<std::string> elements;
+    JSONArrayConsumer consumer = node.mapped().ConsumeArray();
+    STF_ASSERT_EQ(3, consumer.Size());
+    STF_ASSERT_EQ(0, node.mapped().GetValue<JSONArray>().Size());
+    for (JSON element : consumer) elements.push_back(element.ToString());
+    STF_ASSERT_EQ(3, elements.size());
+    STF_ASSERT_EQ("[1, 2]", elements[0]);
+    STF_ASSERT_EQ(R"("x")", elements[1]);
+    STF_ASSERT_EQ(R"({"y": true})", elements[2]);
+}
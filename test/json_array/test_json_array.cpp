@@ -15,6 +15,7 @@
  *      None.
  */
 
+#include <cstdint>
 #include <terra/json/json.h>
 #include <terra/stf/stf.h>
 
@@ -117,3 +118,98 @@ STF_TEST(JSONArray, ToString)
     STF_ASSERT_EQ(expected, result);
 }
 
+
+// Test construction via MakeArray(), Reserve(), and Emplace()
+STF_TEST(JSONArray, MakeArray)
+{
+    JSONArray inner = MakeArray(3, 4);
+    const JSON *elements = inner.value.data();
+
+    JSONArray array = MakeArray(1, u8"two", JSONLiteral::Null);
+    STF_ASSERT_EQ(3, array.Size());
+    STF_ASSERT_EQ(3, array.value.capacity());
+
+    // Moving a nested array does not copy its elements
+    array.Reserve(5);
+    std::uint64_t version = array.Version();
+    std::uint64_t element_version = array.ElementVersion();
+    array.Emplace(std::move(inner));
+    array.Emplace(JSONValueType::Object)[u8"a"] = "b";
+    STF_ASSERT_EQ(version, array.Version());
+    STF_ASSERT_NE(element_version, array.ElementVersion());
+    STF_ASSERT_EQ(elements, (*array[3].GetValue<JSONArray>()).data());
+
+    STF_ASSERT_EQ(R"([1, "two", null, [3, 4], {"a": "b"}])", array.ToString());
+    STF_ASSERT_EQ("[]", MakeArray().ToString());
+}
+
+// Test bulk conversion between arrays of numbers and contiguous containers
+STF_TEST(JSONArray, FromSpanToVector)
+{
+    std::vector<double> samples{1.5, -2.25, 0.0, 1e100, 3.0};
+    JSONArray array = JSONArray::FromSpan<double>(samples);
+    STF_ASSERT_EQ(5, array.Size());
+    STF_ASSERT_EQ(array.ToString(), ToJSONText<double>(samples));
+    STF_ASSERT_EQ(samples, array.ToVector<double>());
+
+    std::vector<int> integers{1, -2, 3};
+    array = JSONArray::FromSpan<int>(integers);
+    STF_ASSERT_EQ("[1, -2, 3]", ToJSONText<int>(integers));
+    STF_ASSERT_EQ("[1, -2, 3]", array.ToString());
+    STF_ASSERT_EQ(integers, array.ToVector<int>());
+    STF_ASSERT_EQ(std::vector<float>({1.0f, -2.0f, 3.0f}),
+                  array.ToVector<float>());
+    STF_ASSERT_EQ("[]", ToJSONText(std::span<const float>()));
+
+    // Elements that cannot be represented are rejected
+    STF_ASSERT_EXCEPTION_E([&]() { array.ToVector<unsigned>(); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { JSONArray({1, 2.5}).ToVector<long long>(); },
+        JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { JSONArray({1, "2"}).ToVector<double>(); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { JSONArray({1, 1LL << 40}).ToVector<int>(); }, JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { JSONArray({1.0, -1e300}).ToVector<float>(); }, JSONException);
+    try
+    {
+        JSONArray({1.0, 1e300}).ToVector<float>();
+        STF_ASSERT_TRUE(false);
+    }
+    catch (const JSONException &e)
+    {
+        STF_ASSERT_EQ(std::string("Array element 1 is not representable as "
+                                  "the type"),
+                      std::string(e.what()));
+    }
+    STF_ASSERT_EQ(std::vector<double>({1e300}),
+                  JSONArray({1e300}).ToVector<double>());
+    std::vector<double> infinite{1.0, 1.0 / 0.0};
+    STF_ASSERT_EXCEPTION_E([&]() { ToJSONText<double>(infinite); },
+                           JSONException);
+    std::vector<unsigned long long> large{~0ULL};
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { JSONArray::FromSpan<unsigned long long>(large); },
+        JSONException);
+
+    // Each standard integer type is supported
+    std::vector<std::int8_t> bytes{-128, 0, 127};
+    STF_ASSERT_EQ("[-128, 0, 127]", ToJSONText<std::int8_t>(bytes));
+    array = JSONArray::FromSpan<std::int8_t>(bytes);
+    STF_ASSERT_EQ(bytes, array.ToVector<std::int8_t>());
+    std::vector<std::uint16_t> shorts{0, 65535};
+    array = JSONArray::FromSpan<std::uint16_t>(shorts);
+    STF_ASSERT_EQ("[0, 65535]", ToJSONText<std::uint16_t>(shorts));
+    STF_ASSERT_EQ(shorts, array.ToVector<std::uint16_t>());
+    STF_ASSERT_EQ(std::vector<short>({0, -1}),
+                  JSONArray({0, -1}).ToVector<short>());
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { JSONArray({256}).ToVector<std::uint8_t>(); },
+        JSONException);
+    static_assert(JSONArithmetic<std::int64_t>);
+    static_assert(!JSONArithmetic<bool>);
+    static_assert(!JSONArithmetic<char>);
+    static_assert(!JSONArithmetic<long double>);
+}
@@ -0,0 +1,182 @@
+/*
+ *  test_json_columns.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test extracting columns from arrays of objects.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <vector>
+#include <terra/json/json.h>
+#include <terra/json/json_columns.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+// Records with missing, null, nested, and escaped members
+constexpr std::string_view Records = R"([
+    {"id": 1, "price": 9.5, "name": "apple", "stock": true,
+     "origin": {"country": "US"}},
+    {"id": 2, "price": 3, "name": "pear", "stock": false,
+     "ignored": [1, {"id": "x"}], "origin": {"country": null}},
+    {"id": 3, "price": null, "stock": null, "origin": "unknown"},
+    42,
+    {"id": -4, "price": -2.5e2, "name": "", "origin": {"country": "NZ"}}
+])";
+
+// Columns extracted from the records
+const std::vector<JSONColumnSpec> Columns =
+{
+    {{u8"id"}, JSONColumnType::Integer},
+    {{u8"price"}, JSONColumnType::Float},
+    {{u8"name"}, JSONColumnType::String},
+    {{u8"stock"}, JSONColumnType::Boolean},
+    {{u8"origin", u8"country"}, JSONColumnType::String}
+};
+
+// Verify the columns extracted from the records
+void VerifyColumns(const std::vector<JSONColumn> &columns)
+{
+    STF_ASSERT_EQ(5, columns.size());
+    for (const auto &column : columns) STF_ASSERT_EQ(5, column.Size());
+
+    const auto &id = columns[0];
+    STF_ASSERT_EQ(1, id.invalid_count);
+    STF_ASSERT_TRUE(id.IsValid(0));
+    STF_ASSERT_FALSE(id.IsValid(3));
+    STF_ASSERT_EQ(1, id.Get<JSONInteger>()[0]);
+    STF_ASSERT_EQ(3, id.Get<JSONInteger>()[2]);
+    STF_ASSERT_EQ(0, id.Get<JSONInteger>()[3]);
+    STF_ASSERT_EQ(-4, id.Get<JSONInteger>()[4]);
+
+    const auto &price = columns[1];
+    STF_ASSERT_EQ(2, price.invalid_count);
+    STF_ASSERT_EQ(9.5, price.Get<JSONFloat>()[0]);
+    STF_ASSERT_EQ(3.0, price.Get<JSONFloat>()[1]);
+    STF_ASSERT_FALSE(price.IsValid(2));
+    STF_ASSERT_EQ(-250.0, price.Get<JSONFloat>()[4]);
+
+    const auto &name = columns[2];
+    STF_ASSERT_EQ(2, name.invalid_count);
+    STF_ASSERT_TRUE(name.Get<std::u8string>()[0] == u8"apple");
+    STF_ASSERT_TRUE(name.Get<std::u8string>()[1] == u8"pear");
+    STF_ASSERT_FALSE(name.IsValid(2));
+    STF_ASSERT_TRUE(name.IsValid(4));
+    STF_ASSERT_TRUE(name.Get<std::u8string>()[4].empty());
+
+    const auto &stock = columns[3];
+    STF_ASSERT_EQ(3, stock.invalid_count);
+    STF_ASSERT_EQ(1, stock.Get<std::uint8_t>()[0]);
+    STF_ASSERT_EQ(0, stock.Get<std::uint8_t>()[1]);
+    STF_ASSERT_TRUE(stock.IsValid(1));
+    STF_ASSERT_FALSE(stock.IsValid(2));
+
+    const auto &country = columns[4];
+    STF_ASSERT_EQ(3, country.invalid_count);
+    STF_ASSERT_TRUE(country.Get<std::u8string>()[0] == u8"US");
+    STF_ASSERT_FALSE(country.IsValid(1));
+    STF_ASSERT_FALSE(country.IsValid(2));
+    STF_ASSERT_TRUE(country.Get<std::u8string>()[4] == u8"NZ");
+}
+
+} // namespace
+
+// Test extracting columns from a JSONArray
+STF_TEST(JSONColumns, FromArray)
+{
+    JSON json = JSONParser().Parse(Records);
+
+    VerifyColumns(ExtractColumns(json.GetValue<JSONArray>(), Columns));
+}
+
+// Test extracting columns from JSON text
+STF_TEST(JSONColumns, FromText)
+{
+    VerifyColumns(ExtractColumns(Records, Columns));
+
+    // An empty path refers to each element
+    auto columns = ExtractColumns("[1, 2.5, null]",
+                                  {{{}, JSONColumnType::Float}});
+    STF_ASSERT_EQ(3, columns[0].Size());
+    STF_ASSERT_EQ(2.5, columns[0].Get<JSONFloat>()[1]);
+    STF_ASSERT_FALSE(columns[0].IsValid(2));
+
+    columns = ExtractColumns(" [ ] ", Columns);
+    STF_ASSERT_EQ(0, columns[0].Size());
+}
+
+// Test many rows spanning several validity words
+STF_TEST(JSONColumns, ManyRows)
+{
+    std::string text = "[";
+
+    for (int i = 0; i < 1000; i++)
+    {
+        std::string value = (i % 3 == 0) ? "null" : std::to_string(i);
+        if (i > 0) text += ",";
+        text += "{\"v\": " + value + "}";
+    }
+    text += "]";
+    JSON json = JSONParser().Parse(text);
+
+    for (const auto &columns :
+         {ExtractColumns(text, {{{u8"v"}, JSONColumnType::Integer}}),
+          ExtractColumns(json.GetValue<JSONArray>(),
+                         {{{u8"v"}, JSONColumnType::Integer}})})
+    {
+        const auto &column = columns[0];
+        STF_ASSERT_EQ(1000, column.Size());
+        STF_ASSERT_EQ(334, column.invalid_count);
+        STF_ASSERT_EQ(16, column.validity.size());
+        for (std::size_t i = 0; i < 1000; i++)
+        {
+            STF_ASSERT_EQ(i % 3 != 0, column.IsValid(i));
+            if (i % 3 != 0)
+            {
+                STF_ASSERT_EQ(static_cast<JSONInteger>(i),
+                              column.Get<JSONInteger>()[i]);
+            }
+        }
+    }
+}
+
+// Test values of the wrong type and invalid text
+STF_TEST(JSONColumns, Errors)
+{
+    std::vector<JSONColumnSpec> id = {{{u8"id"}, JSONColumnType::Integer}};
+
+    STF_ASSERT_EXCEPTION_E([&]() { ExtractColumns("[{\"id\": 1.5}]", id); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { ExtractColumns("[{\"id\": \"1\"}]", id); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { ExtractColumns("[{\"id\": [1]}]", id); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { ExtractColumns("{\"id\": 1}", id); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { ExtractColumns("[{\"id\": 1}", id); },
+                           JSONException);
+
+    // Text nested more deeply than the given limit
+    STF_ASSERT_EQ(1, ExtractColumns("[{\"id\": 1}]", id, 2)[0].Size());
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { ExtractColumns("[{\"id\": 1}]", id, 1); },
+        JSONException);
+
+    JSON json = JSONParser().Parse("[{\"id\": true}]");
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { ExtractColumns(json.GetValue<JSONArray>(), id); },
+        JSONException);
+}
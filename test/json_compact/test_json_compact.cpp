@@ -0,0 +1,105 @@
+/*
+ *  test_json_compact.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the Compact() function.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <terra/json/json.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+// Test that compacting a document does not alter its content
+STF_TEST(Compact, PreservesContent)
+{
+    JSON json = JSONParser().Parse(u8R"(
+        {
+            "name": "A fairly long string value that is not inline",
+            "list": [ 1, 2.5, true, null, "x", [ ], { } ],
+            "nested": { "a": { "b": [ { "c": false } ] } }
+        }
+    )");
+    std::string expected = json.ToString();
+
+    Compact(json);
+
+    STF_ASSERT_EQ(expected, json.ToString());
+}
+
+// Test compacting a document that was modified after being built
+STF_TEST(Compact, ModifiedDocument)
+{
+    JSON json = JSONArray();
+    JSONArray &array = json.GetValue<JSONArray>();
+
+    // Build a document, growing the array and replacing members as it goes
+    for (int i = 0; i < 500; i++)
+    {
+        JSONObject object;
+        object["id"] = i;
+        object["name"] = std::string(32, static_cast<char>('a' + i % 26));
+        array.value.push_back(object);
+    }
+    for (int i = 0; i < 500; i += 2)
+    {
+        json[i]["name"] = "replaced";
+        json[i]["extra"] = JSONArray({1, 2, 3});
+    }
+    std::string expected = json.ToString();
+
+    Compact(json);
+
+    STF_ASSERT_EQ(expected, json.ToString());
+
+    // Vectors are sized exactly
+    STF_ASSERT_EQ(500, json.GetValue<JSONArray>().value.capacity());
+    STF_ASSERT_EQ(3, json[0]["extra"].GetValue<JSONArray>().value.capacity());
+}
+
+// Test compacting scalar values
+STF_TEST(Compact, Scalars)
+{
+    JSON number = 25;
+    JSON literal = JSONLiteral::True;
+    JSON string = "Test";
+
+    Compact(number);
+    Compact(literal);
+    Compact(string);
+
+    STF_ASSERT_EQ(25, number.GetValue<JSONNumber>().GetInteger());
+    STF_ASSERT_EQ(JSONLiteral::True, literal.GetValue<JSONLiteral>());
+    STF_ASSERT_EQ(std::u8string(u8"Test"), *string.GetValue<JSONString>());
+}
+
+#ifdef TERRA_JSON_NODE_POOL
+// Test that the compacted document is placed in a sequential region
+STF_TEST(Compact, SequentialRegion)
+{
+    JSON json = JSONParser().Parse(u8R"({ "a": [ 1, 2, 3 ], "b": { "c": 1 } })");
+    NodePoolStats before = NodePool::GetStats();
+
+    Compact(json);
+
+    NodePoolStats after = NodePool::GetStats();
+    STF_ASSERT_TRUE(after.region_allocations > before.region_allocations);
+    STF_ASSERT_TRUE(after.region_bytes_reserved > 0);
+
+    // Releasing the document releases the region
+    json = JSONLiteral::Null;
+    STF_ASSERT_EQ(before.region_bytes_reserved,
+                  NodePool::GetStats().region_bytes_reserved);
+}
+#endif
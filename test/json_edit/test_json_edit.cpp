@@ -0,0 +1,113 @@
+/*
+ *  test_json_edit.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the functions that edit JSON text in place.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <terra/json/json.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+const std::string Document = R"({
+    "version": 41,
+    "name": "service",
+    "a/b": {"m~n": [10, 20, {"deep": "x"}]},
+    "list": [ "]", {"}": 1}, [], "last" ],
+    "flag": true
+})";
+
+} // namespace
+
+// Test locating values with JSON Pointers
+STF_TEST(JSONEdit, FindValue)
+{
+    auto text = [](const std::string &pointer)
+    {
+        JSONTextSpan span = FindValue(Document, pointer);
+        return Document.substr(span.offset, span.length);
+    };
+
+    STF_ASSERT_EQ(Document, text(""));
+    STF_ASSERT_EQ(std::string("41"), text("/version"));
+    STF_ASSERT_EQ(std::string(R"("service")"), text("/name"));
+    STF_ASSERT_EQ(std::string("20"), text("/a~1b/m~0n/1"));
+    STF_ASSERT_EQ(std::string(R"("x")"), text("/a~1b/m~0n/2/deep"));
+    STF_ASSERT_EQ(std::string(R"("last")"), text("/list/3"));
+    STF_ASSERT_EQ(std::string("[]"), text("/list/2"));
+    STF_ASSERT_EQ(std::string("1"), text("/list/1/}"));
+
+    // Pointers that do not identify a value
+    for (const char *pointer : {"version", "/missing", "/list/4", "/list/-",
+                                "/list/01", "/list/x", "/version/0",
+                                "/a~1b/m~2n", "/list/2/0"})
+    {
+        STF_ASSERT_EXCEPTION_E([&]() { FindValue(Document, pointer); },
+                               JSONException);
+    }
+
+    // Malformed text along the path is reported
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { FindValue(R"({"x": [1, {"a": 2}, "b": 1})", "/b"); },
+        JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { FindValue(R"({"a": 1, "b" 2})", "/b"); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { FindValue(R"(["a)", "/0"); },
+                           JSONException);
+}
+
+// Test replacing values
+STF_TEST(JSONEdit, ReplaceValue)
+{
+    std::string content = Document;
+
+    // Only the value's text is replaced
+    ReplaceValue(content, "/version", 42);
+    std::string expected = Document;
+    expected.replace(expected.find("41"), 2, "42");
+    STF_ASSERT_EQ(expected, content);
+
+    ReplaceValue(content, "/name", "quote\" and é");
+    ReplaceValue(content, "/a~1b/m~0n/2", JSONArray{JSONLiteral::Null});
+    ReplaceValueText(content, "/list/0", "  {\"b\": [1, 2]}\n");
+
+    JSON json = JSONParser().Parse(content);
+    STF_ASSERT_EQ(std::string("42"), json["version"].ToString());
+    STF_ASSERT_EQ(std::string(R"("quote\" and \u00E9")"),
+                  json["name"].ToString());
+    STF_ASSERT_EQ(std::string("[10, 20, [null]]"),
+                  json["a/b"]["m~n"].ToString());
+    STF_ASSERT_EQ(std::string(R"({"b": [1, 2]})"), json["list"][0].ToString());
+
+    // Invalid replacement text leaves the content unchanged
+    std::string unchanged = content;
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { ReplaceValueText(content, "/version", "{\"a\": }"); },
+        JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { ReplaceValue(content, "/missing", 1); },
+        JSONException);
+    STF_ASSERT_EQ(unchanged, content);
+
+    // Replace the entire document
+    std::u8string text = u8R"({"a": 1})";
+    ReplaceValue(text, u8"", JSONObject{{"b", 2}});
+    STF_ASSERT_EQ(std::u8string(u8R"({"b": 2})"), text);
+    ReplaceValueText(text, u8"/b", u8"[true]");
+    STF_ASSERT_EQ(std::u8string(u8R"({"b": [true]})"), text);
+}
@@ -0,0 +1,137 @@
+/*
+ *  test_json_file_sink.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the JSONFileSink object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <terra/json/json.h>
+#include <terra/json/json_file_sink.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+// Temporary file that is removed when destroyed
+struct TemporaryFile
+{
+    TemporaryFile(const std::string &name) :
+        path{std::filesystem::temp_directory_path() / (name + ".json")}
+    {
+    }
+
+    ~TemporaryFile()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    std::string Content() const
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    std::filesystem::path path;
+};
+
+// Produce a document large enough to fill several blocks
+JSON MakeDocument()
+{
+    JSONArray array;
+
+    for (int i = 0; i < 5000; i++)
+    {
+        JSONString name("item" + std::to_string(i));
+        array.Emplace(MakeObject(std::pair{"id", i},
+                                 std::pair{"name", name},
+                                 std::pair{"value", i * 0.5}));
+    }
+
+    return array;
+}
+
+} // namespace
+
+// Test writing JSON text in blocks
+STF_TEST(JSONFileSink, WriteJSONText)
+{
+    TemporaryFile file("test_file_sink_write");
+    JSON json = MakeDocument();
+
+    JSONFileSink sink(file.path, 4096);
+    WriteJSONText(sink, json);
+    sink.Write("\n");
+    STF_ASSERT_EQ(json.ToString().size() + 1, sink.Size());
+    sink.Close();
+
+    STF_ASSERT_EQ(json.ToString() + "\n", file.Content());
+
+    // Closing again has no effect, but writing fails
+    sink.Close();
+    STF_ASSERT_EXCEPTION_E([&]() { sink.Write("x"); }, JSONException);
+}
+
+// Test writing JSON text using the stream
+STF_TEST(JSONFileSink, Stream)
+{
+    TemporaryFile file("test_file_sink_stream");
+    JSON json = MakeDocument();
+    std::string text = json.ToString();
+
+    {
+        JSONFileSink sink(file.path, 1);
+        JSONFormatter formatter(4);
+        formatter.Print(sink.Stream(), text);
+        sink.Stream() << std::endl << json << 'x';
+        STF_ASSERT_TRUE(sink.Stream().good());
+    }
+
+    STF_ASSERT_EQ(JSONFormatter(4).Print(text) + "\n" + text + "x",
+                  file.Content());
+}
+
+// Test text larger than a block and an empty file
+STF_TEST(JSONFileSink, Sizes)
+{
+    TemporaryFile file("test_file_sink_sizes");
+    std::string text(100000, 'a');
+
+    JSONFileSink sink(file.path, 8192);
+    sink.Write(text);
+    sink.Write("");
+    sink.Close();
+    STF_ASSERT_EQ(text, file.Content());
+
+    JSONFileSink empty(file.path);
+    empty.Close();
+    STF_ASSERT_EQ(0, empty.Size());
+    STF_ASSERT_EQ(std::string(), file.Content());
+}
+
+// Test failing to open the file
+STF_TEST(JSONFileSink, OpenFailure)
+{
+    auto path = std::filesystem::temp_directory_path() /
+                "test_file_sink_missing" / "file.json";
+
+    STF_ASSERT_EXCEPTION_E([&]() { JSONFileSink sink(path); }, JSONException);
+}
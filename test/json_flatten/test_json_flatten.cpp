@@ -0,0 +1,139 @@
+/*
+ *  test_json_flatten.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test flattening JSON values into JSON Pointers and
+ *      scalar values.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <terra/json/json.h>
+#include <terra/json/json_flatten.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+// Pairs of a JSON Pointer and the text of a value
+using Pairs = std::vector<std::pair<std::string, std::string>>;
+
+// Convert UTF-8 text to a std::string
+std::string ToText(const std::u8string_view text)
+{
+    return {text.begin(), text.end()};
+}
+
+} // namespace
+
+// Test flattening a JSON object
+STF_TEST(JSONFlatten, Flatten)
+{
+    JSON json = JSONParser().Parse(
+        R"({"b": {"c": [1, true, "x"]}, "a": null, "e": {}, "f": [],
+            "g~h/i": 2.5, "j": [[3], {"k": "l"}]})");
+    Pairs pairs;
+
+    Flatten(json, [&](std::u8string_view pointer, const JSON &value) {
+        pairs.emplace_back(ToText(pointer), value.ToString());
+    });
+
+    Pairs expected = {{"/a", "null"},
+                      {"/b/c/0", "1"},
+                      {"/b/c/1", "true"},
+                      {"/b/c/2", "\"x\""},
+                      {"/e", "{}"},
+                      {"/f", "[]"},
+                      {"/g~0h~1i", "2.5"},
+                      {"/j/0/0", "3"},
+                      {"/j/1/k", "\"l\""}};
+    STF_ASSERT_TRUE(expected == pairs);
+
+    // Each pointer identifies the value within the document
+    for (const auto &[pointer, text] : pairs)
+    {
+        std::string document = json.ToString();
+        JSONTextSpan span = FindValue(document, pointer);
+        STF_ASSERT_EQ(text, document.substr(span.offset, span.length));
+    }
+
+    // A scalar is passed with an empty pointer
+    pairs.clear();
+    Flatten(JSON(42), [&](std::u8string_view pointer, const JSON &value) {
+        pairs.emplace_back(ToText(pointer), value.ToString());
+    });
+    STF_ASSERT_TRUE((Pairs{{"", "42"}}) == pairs);
+}
+
+// Test flattening JSON text
+STF_TEST(JSONFlatten, FlattenText)
+{
+    Pairs pairs;
+
+    FlattenText(R"( {"b": {"c": [1, true, "x\n"]}, "a": null, "e": { },
+                     "f": [ ], "g~h/i": -2.5e3, "j": [[3], {"k": 7}],
+                     "\u007e/": 0} )",
+                [&](std::u8string_view pointer, std::u8string_view text) {
+                    pairs.emplace_back(ToText(pointer), ToText(text));
+                });
+
+    // Members are visited in the order they appear
+    Pairs expected = {{"/b/c/0", "1"},
+                      {"/b/c/1", "true"},
+                      {"/b/c/2", "\"x\\n\""},
+                      {"/a", "null"},
+                      {"/e", "{ }"},
+                      {"/f", "[ ]"},
+                      {"/g~0h~1i", "-2.5e3"},
+                      {"/j/0/0", "3"},
+                      {"/j/1/k", "7"},
+                      {"/~0~1", "0"}};
+    STF_ASSERT_TRUE(expected == pairs);
+
+    // Many elements
+    std::string text = "[";
+    for (int i = 0; i < 100; i++) text += std::to_string(i) + ",";
+    text.back() = ']';
+    std::size_t count = 0;
+    FlattenText(text, [&](std::u8string_view pointer, std::u8string_view v) {
+        STF_ASSERT_EQ("/" + ToText(v), ToText(pointer));
+        count++;
+    });
+    STF_ASSERT_EQ(100, count);
+
+    // Invalid text
+    STF_ASSERT_EXCEPTION_E(
+        [&]() {
+            FlattenText("{\"a\": [1, 2}",
+                        [&](std::u8string_view, std::u8string_view) {});
+        },
+        JSONException);
+
+    // Text nested more deeply than the given limit
+    std::string deep = std::string(10, '[') + std::string(10, ']');
+    count = 0;
+    FlattenText(deep,
+                [&](std::u8string_view, std::u8string_view) { count++; },
+                10);
+    STF_ASSERT_EQ(1, count);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() {
+            FlattenText(deep,
+                        [&](std::u8string_view, std::u8string_view) {},
+                        9);
+        },
+        JSONException);
+}
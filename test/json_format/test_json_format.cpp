@@ -0,0 +1,118 @@
+/*
+ *  test_json_format.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the std::formatter specializations for the JSON
+ *      types and WriteJSONText().
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <format>
+#include <iterator>
+#include <string>
+#include <terra/json/json.h>
+#include <terra/json/json_format.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+// Document exercising each of the JSON types
+const std::string Document = R"({"name": "café \"bar\"", "list": )"
+                             R"([1, -2.5, true, null, [], {}, ["x"]], )"
+                             R"("nested": {"a": {"b": [1e100, 0]}}})";
+
+} // namespace
+
+#ifndef TERRA_DISABLE_STD_FORMAT
+
+// Test that the default format produces the same text as ToString()
+STF_TEST(JSONFormat, Default)
+{
+    JSON json = JSONParser().Parse(Document);
+
+    STF_ASSERT_EQ(json.ToString(), std::format("{}", json));
+
+    std::string buffer = "value: ";
+    std::format_to(std::back_inserter(buffer), "{}!", json);
+    STF_ASSERT_EQ("value: " + json.ToString() + "!", buffer);
+
+    STF_ASSERT_EQ(R"("caf\u00E9 \"bar\"")",
+                  std::format("{}", json[u8"name"].GetValue<JSONString>()));
+    STF_ASSERT_EQ("-2.5",
+                  std::format("{}", json[u8"list"][1].GetValue<JSONNumber>()));
+    STF_ASSERT_EQ(json[u8"nested"].ToString(),
+                  std::format("{}", json[u8"nested"].GetValue<JSONObject>()));
+    STF_ASSERT_EQ(json[u8"list"].ToString(),
+                  std::format("{}", json[u8"list"].GetValue<JSONArray>()));
+    STF_ASSERT_EQ("null", std::format("{}", JSONLiteral::Null));
+}
+
+// Test the compact and indented formats
+STF_TEST(JSONFormat, Styles)
+{
+    JSON json = JSONParser().Parse(Document);
+
+    STF_ASSERT_EQ(R"({"list":[1,-2.5,true,null,[],{},["x"]],)"
+                  R"("name":"caf\u00E9 \"bar\"",)"
+                  R"("nested":{"a":{"b":[1e+100,0]}}})",
+                  std::format("{:c}", json));
+
+    // The indented text is the same as that of the JSONFormatter
+    STF_ASSERT_EQ(JSONFormatter().Print(json), std::format("{:i}", json));
+    STF_ASSERT_EQ(JSONFormatter(4).Print(json), std::format("{:i4}", json));
+    STF_ASSERT_EQ(JSONFormatter(40).Print(json),
+                  std::format("{:i40}", json));
+    STF_ASSERT_EQ("[\n  1,\n  2\n]",
+                  std::format("{:i}", MakeArray(1, 2)));
+
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { return std::vformat("{:x}", std::make_format_args(json)); },
+        std::format_error);
+}
+
+#endif // TERRA_DISABLE_STD_FORMAT
+
+// Test writing to a JSONTextSink
+STF_TEST(JSONFormat, WriteJSONText)
+{
+    // Sink that counts the writes and appends to a string
+    struct StringSink : public JSONTextSink
+    {
+        void Write(const std::string_view text) override
+        {
+            output += text;
+            writes++;
+        }
+
+        std::string output;
+        std::size_t writes{};
+    };
+
+    JSON json = JSONParser().Parse(Document);
+
+    StringSink sink;
+    WriteJSONText(sink, json);
+    STF_ASSERT_EQ(json.ToString(), sink.output);
+    STF_ASSERT_GT(sink.writes, 1);
+
+    StringSink indented;
+    WriteJSONText(indented, json, JSONTextStyle::Indented, 3);
+    STF_ASSERT_EQ(JSONFormatter(3).Print(json), indented.output);
+
+    StringSink invalid;
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { WriteJSONText(invalid, JSONNumber(1.0 / 0.0)); },
+        JSONException);
+}
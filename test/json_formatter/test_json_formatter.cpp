@@ -471,3 +471,17 @@ STF_TEST(JSONFormatter, JSONArray4)
 
     STF_ASSERT_EQ(expected, result);
 }
+
+// Test formatting strings containing escape sequences
+STF_TEST(JSONFormatter, EscapedStrings)
+{
+    std::string content = R"({"a": "q\"uote\\", "b": ["\né"]})";
+    std::string expected = "{\n"
+                           "  \"a\": \"q\\\"uote\\\\\",\n"
+                           "  \"b\": [\n"
+                           "    \"\\né\"\n"
+                           "  ]\n"
+                           "}";
+
+    STF_ASSERT_EQ(expected, JSONFormatter().Print(content));
+}
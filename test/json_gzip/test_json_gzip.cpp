@@ -0,0 +1,215 @@
+/*
+ *  test_json_gzip.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test parsing of gzip-compressed JSON text.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include <terra/json/json.h>
+#include <terra/json/json_gzip.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+// Compress the given text using the gzip format (or zlib format if false)
+std::string Compress(const std::string &text, bool gzip = true)
+{
+    z_stream z{};
+    std::string compressed(deflateBound(&z, text.size()) + 64, '\0');
+
+    deflateInit2(&z,
+                 Z_DEFAULT_COMPRESSION,
+                 Z_DEFLATED,
+                 MAX_WBITS + (gzip ? 16 : 0),
+                 8,
+                 Z_DEFAULT_STRATEGY);
+    z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+    z.avail_in = static_cast<uInt>(text.size());
+    z.next_out = reinterpret_cast<Bytef *>(compressed.data());
+    z.avail_out = static_cast<uInt>(compressed.size());
+    deflate(&z, Z_FINISH);
+    compressed.resize(z.total_out);
+    deflateEnd(&z);
+
+    return compressed;
+}
+
+// Produce JSON text holding one object per line
+std::string MakeLines(std::size_t count)
+{
+    std::string text;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        text += "{\"id\": " + std::to_string(i) + ", \"name\": \"item" +
+                std::to_string(i) + "\"}" + ((i % 7 == 0) ? "\r\n" : "\n");
+        if (i % 100 == 0) text += "  \n";
+    }
+
+    return text;
+}
+
+} // namespace
+
+// Test parsing a compressed document
+STF_TEST(JSONGzip, ParseGzip)
+{
+    std::string text = "[";
+    for (std::size_t i = 0; i < 2000; i++)
+    {
+        text += "{\"id\": " + std::to_string(i) + ", \"value\": 1.5},\n";
+    }
+    text += "null]";
+    JSON expected = JSONParser().Parse(text);
+
+    std::istringstream gzip(Compress(text));
+    STF_ASSERT_EQ(expected.ToString(), ParseGzip(gzip).ToString());
+
+    std::istringstream zlib(Compress(text, false));
+    STF_ASSERT_EQ(expected.ToString(), ParseGzip(zlib).ToString());
+
+    // Concatenated gzip members are read in full
+    std::istringstream members(Compress("[1, ") + Compress("2]"));
+    STF_ASSERT_EQ("[1, 2]", ParseGzip(members).ToString());
+}
+
+// Test reading decompressed text in blocks
+STF_TEST(JSONGzip, Source)
+{
+    std::string text = MakeLines(500);
+    std::istringstream input(Compress(text));
+    JSONGzipSource source(input, 100);
+    std::u8string result;
+    std::size_t reads = 0;
+
+    while (source.Read(result)) reads++;
+
+    STF_ASSERT_GT(reads, 10);
+    STF_ASSERT_EQ(text, std::string(result.begin(), result.end()));
+    STF_ASSERT_FALSE(source.Read(result));
+}
+
+// Test parsing compressed JSON Lines
+STF_TEST(JSONGzip, ParseGzipLines)
+{
+    std::string text = MakeLines(20000);
+    std::istringstream input(Compress(text));
+    std::size_t next = 0;
+    bool in_order = true;
+
+    std::size_t count = ParseGzipLines(input, [&](JSON &&json) {
+        in_order = in_order &&
+                   (json[u8"id"].GetValue<JSONNumber>().GetInteger() ==
+                    static_cast<JSONInteger>(next));
+        next++;
+    });
+
+    STF_ASSERT_EQ(20000, count);
+    STF_ASSERT_EQ(20000, next);
+    STF_ASSERT_TRUE(in_order);
+
+    // The last line need not end with a newline
+    std::istringstream unterminated(Compress("1\n2\n3"));
+    STF_ASSERT_EQ(3, ParseGzipLines(unterminated, [](JSON &&) {}));
+}
+
+// Test errors when parsing compressed text
+STF_TEST(JSONGzip, Errors)
+{
+    std::string compressed = Compress(MakeLines(1000));
+
+    // Truncated data
+    std::istringstream truncated(compressed.substr(0, compressed.size() / 2));
+    STF_ASSERT_EXCEPTION_E([&]() { ParseGzip(truncated); }, JSONException);
+
+    // Data that is not compressed
+    std::istringstream plain("[1, 2, 3]");
+    STF_ASSERT_EXCEPTION_E([&]() { ParseGzip(plain); }, JSONException);
+
+    // An implausible size in the trailer only limits the space reserved,
+    // and the mismatch is detected on decompression
+    std::string oversized = Compress("[1, 2, 3]");
+    oversized.replace(oversized.size() - 4, 4, "\xff\xff\xff\x7f");
+    std::istringstream implausible(oversized);
+    STF_ASSERT_EXCEPTION_E([&]() { ParseGzip(implausible); }, JSONException);
+
+    // Errors decompressing or parsing lines are propagated
+    std::istringstream truncated_lines(
+        compressed.substr(0, compressed.size() / 2));
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { ParseGzipLines(truncated_lines, [](JSON &&) {}); },
+        JSONException);
+    std::istringstream malformed(Compress("1\n[2,\n3\n"));
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { ParseGzipLines(malformed, [](JSON &&) {}); },
+        JSONException);
+
+    // An exception thrown by the consumer stops decompression
+    std::istringstream input(Compress(MakeLines(20000)));
+    std::size_t consumed = 0;
+    STF_ASSERT_EXCEPTION_E(
+        [&]() {
+            ParseGzipLines(input, [&](JSON &&) {
+                if (++consumed == 5) throw std::runtime_error("stop");
+            });
+        },
+        std::runtime_error);
+    STF_ASSERT_EQ(5, consumed);
+}
+
+// Test that decompression stops once the text exceeds the maximum size
+STF_TEST(JSONGzip, Limits)
+{
+    ParserOptions options{.max_document_size = 1000};
+    std::string compressed = Compress(MakeLines(20000));
+
+    // Data is truncated, so reading it in full would fail to decompress
+    std::istringstream truncated(compressed.substr(0, compressed.size() / 2));
+    try
+    {
+        ParseGzip(truncated, options);
+        STF_ASSERT_TRUE(false);
+    }
+    catch (const JSONException &e)
+    {
+        STF_ASSERT_EQ(std::string("The content exceeds the maximum document "
+                                  "size"),
+                      e.what());
+    }
+
+    // Short lines are accepted, but a line without end is not buffered
+    std::string text = MakeLines(100) + std::string(1000000, ' ');
+    compressed = Compress(text);
+    std::istringstream unterminated(
+        compressed.substr(0, compressed.size() - 8));
+    std::size_t count = 0;
+    try
+    {
+        ParseGzipLines(unterminated, [&](JSON &&) { count++; }, options);
+        STF_ASSERT_TRUE(false);
+    }
+    catch (const JSONException &e)
+    {
+        STF_ASSERT_EQ(std::string("The content exceeds the maximum document "
+                                  "size"),
+                      e.what());
+    }
+    STF_ASSERT_EQ(100, count);
+}
@@ -0,0 +1,227 @@
+/*
+ *  test_json_index.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the JSONArrayIndex object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <terra/json/json.h>
+#include <terra/json/json_index.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+// Produce an array of user objects with numeric and string identifiers
+JSON MakeUsers(int count)
+{
+    JSON json = JSONArray();
+    JSONArray &array = json.GetValue<JSONArray>();
+
+    for (int i = 0; i < count; i++)
+    {
+        JSONObject user;
+        user["id"] = i;
+        user["name"] = JSONString("user" + std::to_string(i));
+        user["profile"] = JSONObject({{"email", JSONString("u" + std::to_string(i))}});
+        array.value.push_back(std::move(user));
+    }
+
+    return json;
+}
+
+} // namespace
+
+// Test finding elements by a numeric member
+STF_TEST(JSONArrayIndex, FindByNumber)
+{
+    JSON users = MakeUsers(1000);
+    JSONArrayIndex index(users.GetValue<JSONArray>(), "id");
+
+    STF_ASSERT_EQ(1000, index.Size());
+
+    const JSON *user = index.Find(42);
+    STF_ASSERT_TRUE(user != nullptr);
+    STF_ASSERT_EQ(std::u8string(u8"user42"),
+                  *(*user)["name"].GetValue<JSONString>());
+
+    // Numerically equal floating point values find the same element
+    STF_ASSERT_EQ(42, index.FindPosition(42.0));
+
+    // Missing and non-scalar keys are not found
+    STF_ASSERT_TRUE(index.Find(1000) == nullptr);
+    STF_ASSERT_TRUE(index.Find(JSONArray()) == nullptr);
+    STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition("42"));
+}
+
+// Test finding elements by a string member
+STF_TEST(JSONArrayIndex, FindByString)
+{
+    JSON users = MakeUsers(100);
+    JSONArrayIndex index(users.GetValue<JSONArray>(), u8"name");
+
+    STF_ASSERT_EQ(7, index.FindPosition("user7"));
+    STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition("user100"));
+}
+
+// Test finding elements by a member of a nested object
+STF_TEST(JSONArrayIndex, FindByPath)
+{
+    JSON users = MakeUsers(100);
+    JSONArrayIndex index(users.GetValue<JSONArray>(),
+                         std::vector<std::u8string>{u8"profile", u8"email"});
+
+    STF_ASSERT_EQ(99, index.FindPosition("u99"));
+}
+
+// Test that the index follows modifications made via the array
+STF_TEST(JSONArrayIndex, Modification)
+{
+    JSON users = MakeUsers(10);
+    JSONArray &array = users.GetValue<JSONArray>();
+    JSONArrayIndex index(array, "id");
+
+    // Change an element's key via the array
+    array[3]["id"] = 300;
+    STF_ASSERT_EQ(3, index.FindPosition(300));
+    STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition(3));
+
+    // Add an element via the array
+    (*array).push_back(JSONObject({{"id", 10}}));
+    STF_ASSERT_EQ(10, index.FindPosition(10));
+
+    // Directly modify the value member, which is detected for found keys
+    array.value[5].GetValue<JSONObject>()["id"] = 500;
+    STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition(5));
+    index.Rebuild();
+    STF_ASSERT_EQ(5, index.FindPosition(500));
+}
+
+// Test that updating found elements does not cause the index to be rebuilt
+STF_TEST(JSONArrayIndex, UpdateAfterFind)
+{
+    JSON users = MakeUsers(10);
+    JSONArray &array = users.GetValue<JSONArray>();
+    JSONArrayIndex index(array, "id");
+
+    // Remove a key directly, which is noticed only when the index is rebuilt
+    array.value[7].GetValue<JSONObject>().value.erase(u8"id");
+
+    // Finding and then updating elements leaves the index as built
+    for (std::size_t i = 0; i < 5; i++)
+    {
+        std::size_t position = index.FindPosition(i);
+        STF_ASSERT_EQ(i, position);
+        array[position]["name"] = JSONString("updated");
+    }
+    STF_ASSERT_EQ(10, index.Size());
+
+    // Appended elements are added without rebuilding the index
+    array.Emplace(JSONObject({{"id", 10}}));
+    STF_ASSERT_EQ(10, index.FindPosition(10));
+    STF_ASSERT_EQ(11, index.Size());
+
+    // An element changed via operator[] is re-indexed without a rebuild,
+    // leaving a stale entry for its former key
+    array[0]["id"] = 100;
+    STF_ASSERT_EQ(0, index.FindPosition(100));
+    STF_ASSERT_EQ(12, index.Size());
+
+    // Finding the stale entry causes a rebuild
+    STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition(0));
+    STF_ASSERT_EQ(10, index.Size());
+}
+
+// Test that interleaved updates and misses do not repeatedly rebuild
+STF_TEST(JSONArrayIndex, InterleavedUpdatesAndMisses)
+{
+    JSON users = MakeUsers(10);
+    JSONArray &array = users.GetValue<JSONArray>();
+    JSONArrayIndex index(array, "id");
+
+    // Remove a key directly, which is noticed only when the index is rebuilt
+    array.value[7].GetValue<JSONObject>().value.erase(u8"id");
+
+    for (std::size_t i = 0; i < 5; i++)
+    {
+        array[i]["name"] = JSONString("updated");
+        STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition(100 + i));
+        STF_ASSERT_EQ(10, index.Size());
+    }
+
+    // Several updates between lookups cause a single rebuild on a miss
+    array[1]["name"] = JSONString("again");
+    array[2]["id"] = 200;
+    STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition(300));
+    STF_ASSERT_EQ(9, index.Size());
+    STF_ASSERT_EQ(2, index.FindPosition(200));
+
+    // Subsequent updates and misses do not rebuild again
+    array.value[8].GetValue<JSONObject>().value.erase(u8"id");
+    for (std::size_t i = 0; i < 5; i++)
+    {
+        array[i]["name"] = JSONString("updated again");
+        STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition(300 + i));
+        STF_ASSERT_EQ(9, index.Size());
+    }
+}
+
+// Test that assigning the array is noted by the index
+STF_TEST(JSONArrayIndex, Assignment)
+{
+    JSON users = MakeUsers(3);
+    JSONArray &array = users.GetValue<JSONArray>();
+    JSONArrayIndex index(array, "id");
+    JSONArray other({JSONObject({{"id", 2}}),
+                     JSONObject({{"id", 1}}),
+                     JSONObject({{"id", 0}})});
+
+    // Both arrays have the same size and version
+    STF_ASSERT_EQ(other.Version(), array.Version());
+    STF_ASSERT_EQ(2, index.FindPosition(2));
+
+    array = other;
+    STF_ASSERT_EQ(0, index.FindPosition(2));
+    STF_ASSERT_EQ(2, index.FindPosition(0));
+
+    JSONArray reversed({JSONObject({{"id", 5}}),
+                        JSONObject({{"id", 6}}),
+                        JSONObject({{"id", 7}})});
+    array = std::move(reversed);
+    STF_ASSERT_EQ(1, index.FindPosition(6));
+    STF_ASSERT_EQ(JSONArrayIndex::Not_Found, index.FindPosition(1));
+}
+
+// Test that elements that are not objects or lack the key are skipped
+STF_TEST(JSONArrayIndex, MixedElements)
+{
+    JSONArray array({1, "two", JSONObject({{"id", "x"}}), JSONObject()});
+    JSONArrayIndex index(array, "id");
+
+    STF_ASSERT_EQ(1, index.Size());
+    STF_ASSERT_EQ(2, index.FindPosition("x"));
+}
+
+// Test that duplicate keys find the first element
+STF_TEST(JSONArrayIndex, DuplicateKeys)
+{
+    JSONArray array({JSONObject({{"id", 1}}),
+                     JSONObject({{"id", 2}}),
+                     JSONObject({{"id", 1}})});
+    JSONArrayIndex index(array, "id");
+
+    STF_ASSERT_EQ(0, index.FindPosition(1));
+}
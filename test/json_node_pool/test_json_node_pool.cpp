@@ -0,0 +1,178 @@
+/*
+ *  test_json_node_pool.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the NodePool and NodePoolAllocator.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <map>
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstring>
+#include <terra/json/json.h>
+#include <terra/json/json_node_pool.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+// Test allocating and freeing blocks of various sizes
+STF_TEST(NodePool, AllocateDeallocate)
+{
+    std::vector<std::pair<void *, std::size_t>> blocks;
+
+    NodePoolStats before = NodePool::GetStats();
+
+    for (std::size_t size = 1; size <= NodePool::Maximum_Block_Size; size += 7)
+    {
+        void *block = NodePool::Allocate(size);
+
+        // Every block must be suitably aligned and writable
+        STF_ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(block) %
+                             NodePool::Alignment);
+        std::memset(block, 0xa5, size);
+
+        blocks.emplace_back(block, size);
+    }
+
+    NodePoolStats during = NodePool::GetStats();
+    STF_ASSERT_EQ(before.allocations + blocks.size(), during.allocations);
+    STF_ASSERT_TRUE(during.bytes_in_use > before.bytes_in_use);
+    STF_ASSERT_TRUE(during.bytes_reserved >= during.bytes_in_use);
+
+    for (auto [block, size] : blocks) NodePool::Deallocate(block, size);
+
+    NodePoolStats after = NodePool::GetStats();
+    STF_ASSERT_EQ(before.bytes_in_use, after.bytes_in_use);
+    STF_ASSERT_EQ(during.deallocations + blocks.size(), after.deallocations);
+}
+
+// Test that freed blocks are reused
+STF_TEST(NodePool, BlockReuse)
+{
+    void *first = NodePool::Allocate(40);
+    NodePool::Deallocate(first, 40);
+
+    void *second = NodePool::Allocate(48);
+    STF_ASSERT_EQ(first, second);
+    NodePool::Deallocate(second, 48);
+}
+
+// Test that large or over-aligned requests are given to operator new
+STF_TEST(NodePool, LargeAllocations)
+{
+    NodePoolStats before = NodePool::GetStats();
+
+    void *large = NodePool::Allocate(NodePool::Maximum_Block_Size + 1);
+    void *aligned = NodePool::Allocate(64, 64);
+    STF_ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(aligned) % 64);
+
+    NodePoolStats after = NodePool::GetStats();
+    STF_ASSERT_EQ(before.large_allocations + 2, after.large_allocations);
+    STF_ASSERT_EQ(before.allocations, after.allocations);
+
+    NodePool::Deallocate(large, NodePool::Maximum_Block_Size + 1);
+    NodePool::Deallocate(aligned, 64, 64);
+}
+
+// Test freeing blocks from a thread other than the allocating thread
+STF_TEST(NodePool, CrossThreadFree)
+{
+    constexpr std::size_t Block_Count = 1000;
+    std::vector<void *> blocks;
+
+    NodePoolStats before = NodePool::GetStats();
+
+    for (std::size_t i = 0; i < Block_Count; i++)
+    {
+        blocks.push_back(NodePool::Allocate(64));
+    }
+
+    std::thread thread([&]() {
+        for (void *block : blocks) NodePool::Deallocate(block, 64);
+    });
+    thread.join();
+
+    NodePoolStats after = NodePool::GetStats();
+    STF_ASSERT_EQ(before.remote_deallocations + Block_Count,
+                  after.remote_deallocations);
+    STF_ASSERT_EQ(before.bytes_in_use, after.bytes_in_use);
+
+    // Blocks freed remotely are reclaimed by the owning thread
+    blocks.clear();
+    for (std::size_t i = 0; i < Block_Count; i++)
+    {
+        blocks.push_back(NodePool::Allocate(64));
+    }
+    NodePoolStats reused = NodePool::GetStats();
+    STF_ASSERT_EQ(after.chunks, reused.chunks);
+
+    for (void *block : blocks) NodePool::Deallocate(block, 64);
+}
+
+// Test that blocks may outlive the thread that allocated them
+STF_TEST(NodePool, ThreadExit)
+{
+    std::vector<void *> blocks;
+
+    std::thread thread([&]() {
+        for (std::size_t i = 0; i < 100; i++)
+        {
+            blocks.push_back(NodePool::Allocate(32));
+        }
+    });
+    thread.join();
+
+    for (void *block : blocks) NodePool::Deallocate(block, 32);
+
+    // A new thread adopts the orphaned cache
+    std::thread other([&]() {
+        void *block = NodePool::Allocate(32);
+        NodePool::Deallocate(block, 32);
+    });
+    other.join();
+}
+
+// Test using the allocator with standard containers
+STF_TEST(NodePool, Allocator)
+{
+    std::map<std::u8string,
+             JSON,
+             std::less<std::u8string>,
+             NodePoolAllocator<std::pair<const std::u8string, JSON>>> map;
+    std::vector<JSON, NodePoolAllocator<JSON>> vector;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        map[u8"key" + std::u8string(1, static_cast<char8_t>('a' + i % 26)) +
+            std::u8string(i / 26 + 1, u8'x')] = i;
+        vector.emplace_back(i);
+    }
+
+    STF_ASSERT_EQ(1000, map.size());
+    STF_ASSERT_EQ(1000, vector.size());
+    STF_ASSERT_EQ(999, vector[999].GetValue<JSONNumber>().GetInteger());
+}
+
+// Test that the fragmentation figure is within range
+STF_TEST(NodePool, Fragmentation)
+{
+    void *block = NodePool::Allocate(16);
+
+    NodePoolStats stats = NodePool::GetStats();
+    STF_ASSERT_TRUE(stats.Fragmentation() >= 0.0);
+    STF_ASSERT_TRUE(stats.Fragmentation() < 1.0);
+    STF_ASSERT_TRUE(stats.refills > 0);
+
+    NodePool::Deallocate(block, 16);
+}
@@ -274,3 +274,104 @@ STF_TEST(JSONObject, ToString)
     STF_ASSERT_EQ(expected, result);
 }
 
+// Test output of names that require escaping
+STF_TEST(JSONObject, ToStringEscapedNames)
+{
+    JSONObject object;
+
+    object[u8"plain"] = 1;
+    object[u8"quote\"d"] = 2;
+    object[u8"caf\u00e9"] = 3;
+    object[u8"tab\t"] = 4;
+
+    std::string expected = R"({"caf\u00E9": 3, "plain": 1, "quote\"d": 2, )"
+                           R"("tab\t": 4})";
+
+    STF_ASSERT_EQ(expected, object.ToString());
+    STF_ASSERT_EQ(expected, JSON(object).ToCachedString());
+    STF_ASSERT_EQ(expected, JSON(object).ToString(SerializerOptions{}));
+}
+
+
+// Test lookups using JSONKey handles
+STF_TEST(JSONObject, JSONKeyLookup)
+{
+    using namespace Terra::JSON::Literals;
+
+    constexpr JSONKey Type_Key{u8"type"};
+    constexpr auto Id_Key = u8"id"_key;
+
+    JSONObject object = {
+        {u8"type", "user"},
+        {u8"id", 42},
+        {u8"payload", JSONObject()}
+    };
+
+    STF_ASSERT_EQ(std::u8string(u8"user"),
+                  *object[Type_Key].GetValue<JSONString>());
+    STF_ASSERT_EQ(42, object[Id_Key].GetValue<JSONNumber>().GetInteger());
+    STF_ASSERT_TRUE(object.HasKey(u8"payload"_key));
+    STF_ASSERT_FALSE(object.HasKey(u8"missing"_key));
+    STF_ASSERT_TRUE(object.Find(u8"missing"_key) == nullptr);
+    STF_ASSERT_TRUE(object.Find(Id_Key) == &object[Id_Key]);
+
+    // Lookups using views and std::string find the same members
+    STF_ASSERT_TRUE(object.Find(std::u8string_view(u8"id")) ==
+                    &object[Id_Key]);
+    STF_ASSERT_TRUE(&object[std::string("type")] == &object[Type_Key]);
+    STF_ASSERT_TRUE(object.HasKey(std::string("payload")));
+    STF_ASSERT_FALSE(object.HasKey(std::string("missing")));
+
+    // Lookup via a const object throws if the key is not present
+    const JSONObject &const_object = object;
+    auto lookup = [&]() { const_object[u8"missing"_key]; };
+    STF_ASSERT_EXCEPTION_E(lookup, std::out_of_range);
+
+    // Non-const lookup inserts a new member
+    object[u8"new"_key] = 1;
+    STF_ASSERT_EQ(4, object.Size());
+
+    // Lookup through the JSON object
+    JSON json = object;
+    STF_ASSERT_EQ(42, json[Id_Key].GetValue<JSONNumber>().GetInteger());
+    STF_ASSERT_EQ(42,
+                  json[std::string("id")].GetValue<JSONNumber>().GetInteger());
+    STF_ASSERT_TRUE(json.ExtractMember(std::string_view("id")));
+    STF_ASSERT_FALSE(json.ExtractMember(u8"id"_key));
+}
+
+// Test JSONKey properties
+STF_TEST(JSONObject, JSONKeyProperties)
+{
+    constexpr JSONKey Key{u8"payload"};
+
+    static_assert(Key.Size() == 7);
+    static_assert(Key.View() == u8"payload");
+
+    STF_ASSERT_TRUE(JSONKey(std::string("payload")) == Key);
+    STF_ASSERT_FALSE(JSONKey(u8"Payload") == Key);
+}
+
+// Test construction via MakeObject() and Emplace()
+STF_TEST(JSONObject, MakeObject)
+{
+    JSONArray list = MakeArray(1, 2, 3);
+    const JSON *elements = list.value.data();
+
+    JSONObject object = MakeObject(std::pair{u8"list", std::move(list)},
+                                   std::pair{"name", "value"},
+                                   std::pair{u8"nested",
+                                             MakeObject(std::pair{"x", 1.5})});
+    STF_ASSERT_EQ(3, object.Size());
+    STF_ASSERT_EQ(elements,
+                  (*object[u8"list"].GetValue<JSONArray>()).data());
+
+    // Emplace() replaces an existing member
+    object.Emplace("name", 7);
+    object.Emplace(std::u8string(u8"flag"), JSONLiteral::True);
+
+    STF_ASSERT_EQ(
+        R"({"flag": true, "list": [1, 2, 3], "name": 7, "nested": {"x": 1.5}})",
+        object.ToString());
+    STF_ASSERT_EQ("{}", MakeObject().ToString());
+}
@@ -0,0 +1,191 @@
+/*
+ *  test_json_offset_index.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the JSONOffsetIndex object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <terra/json/json.h>
+#include <terra/json/json_offset_index.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+namespace
+{
+
+// Temporary data and index files that are removed when destroyed
+struct TemporaryFiles
+{
+    TemporaryFiles(const std::string &name, const std::string &content) :
+        data{std::filesystem::temp_directory_path() / (name + ".json")},
+        index{std::filesystem::temp_directory_path() / (name + ".idx")}
+    {
+        std::ofstream(data, std::ios::binary) << content;
+    }
+
+    ~TemporaryFiles()
+    {
+        std::error_code error;
+        std::filesystem::remove(data, error);
+        std::filesystem::remove(index, error);
+    }
+
+    std::filesystem::path data;
+    std::filesystem::path index;
+};
+
+} // namespace
+
+// Test random access to the elements of an array
+STF_TEST(JSONOffsetIndex, Array)
+{
+    std::string content = "[";
+    for (int i = 0; i < 1000; i++)
+    {
+        if (i > 0) content += ",\n  ";
+        content += "{\"id\": " + std::to_string(i) + ", \"name\": \"user" +
+                   std::to_string(i) + "\", \"tags\": [\"a\", \"]\"]}";
+    }
+    content += "]\n";
+    TemporaryFiles files("test_offset_index_array", content);
+
+    JSONOffsetIndex::Build(files.data, files.index,
+                           JSONOffsetIndex::Layout::Array);
+    JSONOffsetIndex index(files.data, files.index);
+
+    STF_ASSERT_EQ(1000, index.Size());
+    STF_ASSERT_FALSE(index.HasMembers());
+    STF_ASSERT_EQ(JSONOffsetIndex::Layout::Array, index.GetLayout());
+
+    // Every element matches the parsed array
+    JSON json = JSONParser().Parse(content);
+    for (std::size_t i = 0; i < index.Size(); i += 97)
+    {
+        STF_ASSERT_EQ(json[i].ToString(), index.Get(i).ToString());
+    }
+    STF_ASSERT_EQ(json[999].ToString(), index.Get(999).ToString());
+
+    STF_ASSERT_EQ(std::u8string(
+                      u8"{\"id\": 5, \"name\": \"user5\", \"tags\": [\"a\", \"]\"]}"),
+                  index.Text(5));
+    STF_ASSERT_EXCEPTION_E([&]() { index.Get(1000); }, std::out_of_range);
+    STF_ASSERT_EXCEPTION_E([&]() { index.GetMember(0, "id"); },
+                           JSONException);
+}
+
+// Test random access to the members of values, one per line
+STF_TEST(JSONOffsetIndex, LinesMembers)
+{
+    TemporaryFiles files("test_offset_index_lines",
+                         "{\"a\": 1, \"b\": {\"c\": [1, 2]}}\r\n"
+                         "\n"
+                         "  \"scalar\"  \n"
+                         "{\"na\\u006De\": \"x\", \"e\": {}}\n"
+                         "[true, false, null]");
+
+    JSONOffsetIndex::Build(files.data, files.index,
+                           JSONOffsetIndex::Layout::Lines, true);
+    JSONOffsetIndex index(files.data, files.index);
+
+    STF_ASSERT_EQ(4, index.Size());
+    STF_ASSERT_TRUE(index.HasMembers());
+
+    STF_ASSERT_EQ("1", index.GetMember(0, "a").ToString());
+    STF_ASSERT_EQ(R"({"c": [1, 2]})", index.GetMember(0, "b").ToString());
+    STF_ASSERT_EQ(R"("scalar")", index.Get(1).ToString());
+    STF_ASSERT_EQ(R"("x")", index.GetMember(2, u8"name").ToString());
+    STF_ASSERT_EQ("{}", index.GetMember(2, "e").ToString());
+    STF_ASSERT_EQ("[true, false, null]", index.Get(3).ToString());
+
+    STF_ASSERT_TRUE(index.MemberText(0, u8"z").empty());
+    STF_ASSERT_TRUE(index.MemberText(1, u8"a").empty());
+    STF_ASSERT_EXCEPTION_E([&]() { index.GetMember(3, "a"); },
+                           JSONException);
+}
+
+// Test errors when building and opening an index
+STF_TEST(JSONOffsetIndex, Errors)
+{
+    // Build the index of values and members, which should fail
+    auto build = [](const std::string &content, JSONOffsetIndex::Layout layout)
+    {
+        TemporaryFiles files("test_offset_index_error", content);
+        JSONOffsetIndex::Build(files.data, files.index, layout, true);
+    };
+
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { build("[1, 2 3]", JSONOffsetIndex::Layout::Array); },
+        JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { build("[[1, 2]", JSONOffsetIndex::Layout::Array); },
+        JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { build("[1, tru, {]", JSONOffsetIndex::Layout::Array); },
+        JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { build("{\"a\": 1} 2\n", JSONOffsetIndex::Layout::Lines); },
+        JSONException);
+    STF_ASSERT_EXCEPTION_E(
+        [&]() { build("{\"a\" 1}\n", JSONOffsetIndex::Layout::Lines); },
+        JSONException);
+
+    // An index that does not match the data file is rejected
+    {
+        TemporaryFiles files("test_offset_index_error", "[1, 2]");
+        JSONOffsetIndex::Build(files.data,
+                               files.index,
+                               JSONOffsetIndex::Layout::Array);
+        std::ofstream(files.data, std::ios::binary) << "[1, 2, 3]";
+        STF_ASSERT_EXCEPTION_E(
+            [&]() { JSONOffsetIndex(files.data, files.index); },
+            JSONException);
+        STF_ASSERT_EXCEPTION_E(
+            [&]() { JSONOffsetIndex(files.index, files.data); },
+            JSONException);
+    }
+
+    // Malformed scalars are detected when parsed
+    {
+        TemporaryFiles files("test_offset_index_error", "[1, tru]");
+        JSONOffsetIndex::Build(files.data,
+                               files.index,
+                               JSONOffsetIndex::Layout::Array);
+        JSONOffsetIndex index(files.data, files.index);
+        STF_ASSERT_EQ("1", index.Get(0).ToString());
+        STF_ASSERT_EXCEPTION_E([&]() { index.Get(1); }, JSONException);
+    }
+}
+
+// Test an empty array and an empty file
+STF_TEST(JSONOffsetIndex, Empty)
+{
+    {
+        TemporaryFiles files("test_offset_index_empty", " [ ] ");
+        JSONOffsetIndex::Build(files.data,
+                               files.index,
+                               JSONOffsetIndex::Layout::Array);
+        STF_ASSERT_EQ(0, JSONOffsetIndex(files.data, files.index).Size());
+    }
+    {
+        TemporaryFiles files("test_offset_index_empty", "");
+        JSONOffsetIndex::Build(files.data,
+                               files.index,
+                               JSONOffsetIndex::Layout::Lines,
+                               true);
+        STF_ASSERT_EQ(0, JSONOffsetIndex(files.data, files.index).Size());
+    }
+}
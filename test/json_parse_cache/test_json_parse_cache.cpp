@@ -0,0 +1,126 @@
+/*
+ *  test_json_parse_cache.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the JSONParseCache object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <terra/json/json.h>
+#include <terra/json/json_parse_cache.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+// Test that repeated text returns the same document
+STF_TEST(JSONParseCache, Hits)
+{
+    JSONParseCache cache(4);
+
+    auto first = cache.Parse(R"({"a": [1, 2, 3]})");
+    auto second = cache.Parse(std::string(R"({"a": [1, 2, 3]})"));
+    auto third = cache.Parse(u8R"({"a": [1, 2, 3] })");
+
+    STF_ASSERT_EQ(first.get(), second.get());
+    STF_ASSERT_NE(first.get(), third.get());
+    STF_ASSERT_EQ(std::string(R"({"a": [1, 2, 3]})"), first->ToString());
+    STF_ASSERT_EQ(first->ToString(), third->ToString());
+
+    JSONParseCacheStatistics statistics = cache.GetStatistics();
+    STF_ASSERT_EQ(1, statistics.hits);
+    STF_ASSERT_EQ(2, statistics.misses);
+    STF_ASSERT_EQ(0, statistics.evictions);
+    STF_ASSERT_EQ(2, cache.Size());
+    STF_ASSERT_EQ(4, cache.Capacity());
+}
+
+// Test eviction of the least recently used document
+STF_TEST(JSONParseCache, Eviction)
+{
+    JSONParseCache cache(2);
+
+    auto one = cache.Parse("1");
+    auto two = cache.Parse("2");
+    cache.Parse("1");
+    auto three = cache.Parse("3");
+
+    STF_ASSERT_EQ(2, cache.Size());
+    STF_ASSERT_EQ(1, cache.GetStatistics().evictions);
+
+    // "2" was least recently used, so it was evicted
+    STF_ASSERT_EQ(one.get(), cache.Parse("1").get());
+    STF_ASSERT_NE(two.get(), cache.Parse("2").get());
+    STF_ASSERT_EQ(std::string("2"), two->ToString());
+
+    JSONParseCacheStatistics statistics = cache.GetStatistics();
+    STF_ASSERT_EQ(2, statistics.hits);
+    STF_ASSERT_EQ(4, statistics.misses);
+    STF_ASSERT_EQ(2, statistics.evictions);
+
+    cache.Clear();
+    STF_ASSERT_EQ(0, cache.Size());
+    STF_ASSERT_NE(one.get(), cache.Parse("1").get());
+}
+
+// Test that errors are reported and not cached
+STF_TEST(JSONParseCache, Errors)
+{
+    JSONParseCache cache(2, {.max_depth = 2});
+
+    auto parse = [&]() { cache.Parse("[[[1]]]"); };
+    STF_ASSERT_EXCEPTION_E(parse, JSONException);
+    STF_ASSERT_EXCEPTION_E(parse, JSONException);
+    STF_ASSERT_EQ(0, cache.Size());
+    STF_ASSERT_EQ(2, cache.GetStatistics().misses);
+
+    // A cache with no capacity parses every time
+    JSONParseCache empty(0);
+    STF_ASSERT_NE(empty.Parse("[]").get(), empty.Parse("[]").get());
+    STF_ASSERT_EQ(0, empty.Size());
+}
+
+// Test that the lazy option is ignored
+STF_TEST(JSONParseCache, Lazy)
+{
+    JSONParseCache cache(2, {.lazy = true});
+
+    auto json = cache.Parse(R"({"a": {"b": [true]}})");
+    STF_ASSERT_EQ(std::string(R"({"a": {"b": [true]}})"), json->ToString());
+}
+
+// Test use of the cache by multiple threads
+STF_TEST(JSONParseCache, Threads)
+{
+    JSONParseCache cache(8);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int j = 0; j < 1000; j++)
+            {
+                std::string text = "[" + std::to_string(j % 16) + "]";
+                auto json = cache.Parse(text);
+                if (json->ToString() != text) throw JSONException(text);
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    JSONParseCacheStatistics statistics = cache.GetStatistics();
+    STF_ASSERT_EQ(4000, statistics.hits + statistics.misses);
+    STF_ASSERT_LE(cache.Size(), 8);
+}
@@ -628,3 +628,389 @@ STF_TEST(JSONParser, JSONMove)
     // There should be two tag / value pairs
     STF_ASSERT_EQ(5, result_copy.GetValue<JSONArray>().Size());
 }
+
+// Test that arrays are allocated with the exact number of elements
+STF_TEST(JSONParser, ArrayExactCapacity)
+{
+    JSONParser json_parser;
+    std::u8string json_text = u8R"(
+        [ 1, "a,b]", [ ], [ [ 1, 2 ], { "x": [ 3, 4, 5 ], "y": 6 } ],
+          "\"[", { "z": "]" }, [ "," ] ]
+    )";
+
+    JSON result = json_parser.Parse(json_text);
+
+    const JSONArray &array = result.GetValue<JSONArray>();
+    STF_ASSERT_EQ(7, array.Size());
+    STF_ASSERT_EQ(7, array.value.capacity());
+
+    // Empty array
+    STF_ASSERT_EQ(0, array[2].GetValue<JSONArray>().Size());
+
+    // Nested arrays
+    const JSONArray &nested = array[3].GetValue<JSONArray>();
+    STF_ASSERT_EQ(2, nested.Size());
+    STF_ASSERT_EQ(2, nested.value.capacity());
+    STF_ASSERT_EQ(2, nested[0].GetValue<JSONArray>().value.capacity());
+    STF_ASSERT_EQ(3, nested[1]["x"].GetValue<JSONArray>().Size());
+    STF_ASSERT_EQ(3, nested[1]["x"].GetValue<JSONArray>().value.capacity());
+
+    // Strings containing brackets and commas
+    STF_ASSERT_EQ(std::u8string(u8"a,b]"), *array[1].GetValue<JSONString>());
+    STF_ASSERT_EQ(std::u8string(u8"\"["), *array[4].GetValue<JSONString>());
+    STF_ASSERT_EQ(1, array[6].GetValue<JSONArray>().value.capacity());
+}
+
+// Test that a large array is parsed correctly
+STF_TEST(JSONParser, LargeArray)
+{
+    JSONParser json_parser;
+    std::string json_text = "[";
+
+    for (std::size_t i = 0; i < 10000; i++)
+    {
+        if (i > 0) json_text += ",";
+        json_text += std::to_string(i);
+    }
+    json_text += "]";
+
+    JSON result = json_parser.Parse(json_text);
+
+    const JSONArray &array = result.GetValue<JSONArray>();
+    STF_ASSERT_EQ(10000, array.Size());
+    STF_ASSERT_EQ(10000, array.value.capacity());
+    STF_ASSERT_EQ(9999, array[9999].GetValue<JSONNumber>().GetInteger());
+}
+
+// Test that strings with and without escapes are parsed correctly
+STF_TEST(JSONParser, ParseStringEscapesAndPlain)
+{
+    JSONParser json_parser;
+    std::u8string json_text = u8R"(
+        [ "plain text", "tab\there", "é😁", "" ]
+    )";
+    std::u8string expected = u8"é\U0001F601";
+
+    JSON result = json_parser.Parse(json_text);
+
+    STF_ASSERT_EQ(std::u8string(u8"plain text"),
+                  *result[0].GetValue<JSONString>());
+    STF_ASSERT_EQ(std::u8string(u8"tab\there"),
+                  *result[1].GetValue<JSONString>());
+    STF_ASSERT_EQ(expected, *result[2].GetValue<JSONString>());
+    STF_ASSERT_EQ(std::u8string(), *result[3].GetValue<JSONString>());
+}
+
+// Test that a control character in an unescaped string is rejected
+STF_TEST(JSONParser, ParseStringControlCharacter)
+{
+    JSONParser json_parser;
+    std::string json_text = "\"abc\x01xyz\"";
+
+    auto parse = [&]() { json_parser.Parse(json_text); };
+
+    STF_ASSERT_EXCEPTION_E(parse, JSONException);
+}
+
+// Test that an unterminated array is rejected
+STF_TEST(JSONParser, ParseUnterminatedArray)
+{
+    JSONParser json_parser;
+    std::string json_text = R"([ 1, [ 2, 3 ], "x")";
+
+    auto parse = [&]() { json_parser.Parse(json_text); };
+
+    STF_ASSERT_EXCEPTION_E(parse, JSONException);
+}
+
+// Test that lazy parsing produces the same document as eager parsing
+STF_TEST(JSONParser, LazyMatchesEager)
+{
+    JSONParser eager_parser;
+    JSONParser lazy_parser({.lazy = true});
+    std::u8string json_text = u8R"(
+        {
+            "users": [
+                { "id": 1, "name": "Alice \"A\"", "tags": [ "x", "y" ] },
+                { "id": 2, "name": "Bob é😁", "tags": [] },
+                { "id": 3, "score": -1.5e3, "nested": { "a": [ [], {} ] } }
+            ],
+            "empty": {},
+            "literal": null,
+            "text": "[not an array]"
+        }
+    )";
+
+    JSON eager = eager_parser.Parse(json_text);
+    JSON lazy = lazy_parser.Parse(json_text);
+
+    STF_ASSERT_EQ(eager.ToString(), lazy.ToString());
+}
+
+// Test access to a lazily parsed document
+STF_TEST(JSONParser, LazyAccess)
+{
+    JSON json;
+
+    {
+        JSONParser json_parser({.lazy = true});
+        json = json_parser.Parse(R"({"a": [10, 20, {"b": "c"}], "d": [1]})");
+    }
+
+    // The type of unparsed values is known without parsing them
+    STF_ASSERT_EQ(JSONValueType::Array, json["a"].GetValueType());
+
+    // Values may be accessed via a const reference
+    const JSON &const_json = json;
+    STF_ASSERT_EQ(std::u8string(u8"c"),
+                  *const_json["a"][2]["b"].GetValue<JSONString>());
+    STF_ASSERT_EQ(3, const_json["a"].GetValue<JSONArray>().Size());
+    STF_ASSERT_EQ(3, const_json["a"].GetValue<JSONArray>().value.capacity());
+
+    // Copies share the unparsed text
+    JSON copy = json["d"];
+    json["d"] = 5;
+    STF_ASSERT_EQ(std::string("[1]"), copy.ToString());
+
+    // Unparsed values may be replaced
+    json["a"][2] = JSONArray();
+    STF_ASSERT_EQ(std::string(R"({"a": [10, 20, []], "d": 5})"),
+                  json.ToString());
+}
+
+// Test that lazy parsing reports errors in values not yet parsed
+STF_TEST(JSONParser, LazyErrors)
+{
+    JSONParser json_parser({.lazy = true});
+
+    for (const std::string json_text : {R"({"a": {"b": [1, 2,]}})",
+                                        R"({"a": [{"b": 1, "b": 2}]})",
+                                        R"({"a": [{"b": 1, "b": 2}]})",
+                                        R"({"a": [99999999999999999999]})",
+                                        R"({"a": [1e999]})",
+                                        R"({"a": ["\ud83d"]})",
+                                        R"({"a": [1]} x)"})
+    {
+        auto parse = [&]() { json_parser.Parse(json_text); };
+
+        STF_ASSERT_EXCEPTION_E(parse, JSONException);
+    }
+}
+
+// Test that lazy parsing accepts what eager parsing accepts
+STF_TEST(JSONParser, LazyLenient)
+{
+    JSONParser json_parser({.lazy = true});
+
+    // Leading zeros and "\q" are accepted by the parser
+    JSON json = json_parser.Parse(R"([007, "\q"])");
+
+    STF_ASSERT_EQ(7, json[0].GetValue<JSONNumber>().GetInteger());
+    STF_ASSERT_EQ(std::u8string(u8"q"), *json[1].GetValue<JSONString>());
+}
+
+// Test that the parser enforces the limits given in ParserOptions
+STF_TEST(JSONParser, Limits)
+{
+    struct LimitTest
+    {
+        ParserOptions options;
+        std::string accepted;
+        std::string rejected;
+    };
+    std::vector<LimitTest> tests = {
+        {{.max_document_size = 8}, "[1, 2]", "[1, 2, 3]"},
+        {{.max_depth = 2}, "[[1], {}]", "[[[1]]]"},
+        {{.max_depth = 2}, R"({"a": {}})", R"({"a": {"b": {}}})"},
+        {{.max_values = 4}, "[1, [2]]", "[1, [2], 3]"},
+        {{.max_values = 2}, R"({"a": "b"})", R"({"a": "b", "c": 1})"},
+        {{.max_string_length = 3}, R"(["abc", "\n"])", R"(["abcd"])"},
+        {{.max_string_length = 3}, R"({"abc": 1})", R"({"abcd": 1})"},
+        {{.max_string_length = 3}, R"("\n")", R"("éé")"},
+        {{.max_members = 2},
+         R"({"a": 1, "b": 2})",
+         R"({"a": 1, "b": 2, "c": 3})"},
+        {{.max_elements = 2}, "[[1, 2], []]", "[[1, 2, 3]]"}};
+
+    for (auto &test : tests)
+    {
+        for (bool lazy : {false, true})
+        {
+            test.options.lazy = lazy;
+            JSONParser json_parser(test.options);
+
+            JSON json = json_parser.Parse(test.accepted);
+            STF_ASSERT_EQ(JSONParser().Parse(test.accepted).ToString(),
+                          json.ToString());
+
+            auto parse = [&]() { json_parser.Parse(test.rejected); };
+            STF_ASSERT_EXCEPTION_E(parse, JSONException);
+        }
+    }
+}
+
+// Test that a large array exceeding the element limit is rejected before
+// storage for it is allocated
+STF_TEST(JSONParser, LimitsLargeArray)
+{
+    JSONParser json_parser({.max_elements = 1000});
+    std::string json_text = "[0";
+    for (std::size_t i = 1; i < 100'000; i++) json_text += ",0";
+    json_text += "]";
+
+    auto parse = [&]() { json_parser.Parse(json_text); };
+
+    STF_ASSERT_EXCEPTION_E(parse, JSONException);
+}
+
+// Test that deeply nested input is rejected rather than exhausting the stack
+STF_TEST(JSONParser, LimitsDeepNesting)
+{
+    JSONParser json_parser({.max_depth = 64});
+    std::string json_text(1'000'000, '[');
+
+    auto parse = [&]() { json_parser.Parse(json_text); };
+
+    STF_ASSERT_EXCEPTION_E(parse, JSONException);
+}
+
+// Test previewing JSON text within budgets
+STF_TEST(JSONParser, Preview)
+{
+    JSONParser json_parser;
+    std::string json_text = R"(
+        {
+            "a": [1, 2, 3, 4, [5, 6]],
+            "b": {"c": {"d": 1}, "e": "abcdefghij"},
+            "f": "x\ty\tz and more text",
+            "g": ["short"]
+        }
+    )";
+
+    JSON preview = json_parser.Preview(json_text, {.max_elements = 2});
+    STF_ASSERT_EQ(std::u8string(u8"…"),
+                  *preview["a"][2].GetValue<JSONString>());
+    STF_ASSERT_EQ(3, preview["a"].GetValue<JSONArray>().Size());
+    STF_ASSERT_EQ(1, preview["g"].GetValue<JSONArray>().Size());
+
+    preview = json_parser.Preview(json_text, {.max_members = 1});
+    STF_ASSERT_EQ(2, preview.GetValue<JSONObject>().Size());
+    STF_ASSERT_TRUE(preview.GetValue<JSONObject>().HasKey(u8"…"));
+    STF_ASSERT_TRUE(preview.GetValue<JSONObject>().HasKey(u8"a"));
+
+    preview = json_parser.Preview(json_text, {.max_depth = 2});
+    STF_ASSERT_EQ(1, preview["b"]["c"].GetValue<JSONObject>().Size());
+    STF_ASSERT_TRUE(preview["b"]["c"].GetValue<JSONObject>().HasKey(
+        u8"…"));
+    STF_ASSERT_EQ(std::u8string(u8"…"),
+                  *preview["a"][4][0].GetValue<JSONString>());
+
+    preview = json_parser.Preview(json_text, {.max_string_length = 5});
+    STF_ASSERT_EQ(std::u8string(u8"abcde…"),
+                  *preview["b"]["e"].GetValue<JSONString>());
+    STF_ASSERT_EQ(std::u8string(u8"x\ty\t…"),
+                  *preview["f"].GetValue<JSONString>());
+    STF_ASSERT_EQ(std::u8string(u8"short"),
+                  *preview["g"][0].GetValue<JSONString>());
+
+    // Without budgets, the preview is the whole document
+    STF_ASSERT_EQ(json_parser.Parse(json_text).ToString(),
+                  json_parser.Preview(json_text, {}).ToString());
+}
+
+// Test that previews do not divide multi-octet characters
+STF_TEST(JSONParser, PreviewMultiOctet)
+{
+    JSONParser json_parser;
+
+    JSON preview =
+        json_parser.Preview(u8R"(["éé", "a😁"])", {.max_string_length = 3});
+
+    STF_ASSERT_EQ(std::u8string(u8"é…"),
+                  *preview[0].GetValue<JSONString>());
+    STF_ASSERT_EQ(std::u8string(u8"a…"),
+                  *preview[1].GetValue<JSONString>());
+}
+
+// Test that previews skip over elided content containing brackets
+STF_TEST(JSONParser, PreviewSkip)
+{
+    JSONParser json_parser;
+
+    JSON preview = json_parser.Preview(
+        R"([1, "]", {"}": [["\"]"]]}, 4] )", {.max_elements = 1});
+    STF_ASSERT_EQ(std::string(R"([1, "\u2026"])"), preview.ToString());
+
+    auto parse = [&]() {
+        json_parser.Preview(R"([1, [2, 3)", {.max_elements = 1});
+    };
+    STF_ASSERT_EXCEPTION_E(parse, JSONException);
+}
+
+// Test parsing UTF-16 and UTF-32 text
+STF_TEST(JSONParser, UTF16AndUTF32)
+{
+    const std::string expected = JSONParser().Parse(
+        u8"{\"name\": \"café 中\", \"emoji\": \"\U0001F600\", "
+        u8"\"long ascii text\": [1, 2, 3]}").ToString();
+
+    std::u16string utf16 =
+        u"{\"name\": \"café 中\", \"emoji\": \"\U0001F600\", "
+        u"\"long ascii text\": [1, 2, 3]}";
+    std::u32string utf32 =
+        U"{\"name\": \"café 中\", \"emoji\": \"\U0001F600\", "
+        U"\"long ascii text\": [1, 2, 3]}";
+
+    STF_ASSERT_EQ(expected, JSONParser().Parse(utf16).ToString());
+    STF_ASSERT_EQ(expected, JSONParser().Parse(utf32).ToString());
+
+    // A byte order mark is removed
+    STF_ASSERT_EQ(expected, JSONParser().Parse(u'\uFEFF' + utf16).ToString());
+    STF_ASSERT_EQ(expected, JSONParser().Parse(U'\uFEFF' + utf32).ToString());
+
+    // Text whose octets are reversed, as indicated by the byte order mark,
+    // is corrected
+    std::u16string swapped16 = u'\uFEFF' + utf16;
+    for (auto &unit : swapped16)
+    {
+        unit = static_cast<char16_t>((unit >> 8) | (unit << 8));
+    }
+    STF_ASSERT_EQ(expected, JSONParser().Parse(swapped16).ToString());
+
+    std::u32string swapped32 = U'\uFEFF' + utf32;
+    for (auto &unit : swapped32)
+    {
+        unit = ((unit >> 24) & 0xff) | ((unit >> 8) & 0xff00) |
+               ((unit << 8) & 0xff0000) | ((unit << 24) & 0xff000000);
+    }
+    STF_ASSERT_EQ(expected, JSONParser().Parse(swapped32).ToString());
+
+    // Text whose UTF-8 form is several times its number of code units
+    std::u16string wide16 = u"[\"" + std::u16string(1000, u'\u4e2d') + u"\"]";
+    std::u32string wide32 = U"[\"" + std::u32string(1000, U'\U0001F600') +
+                            U"\"]";
+    STF_ASSERT_EQ(3000, JSONParser().Parse(wide16)[0]
+                            .GetValue<JSONString>().value.size());
+    STF_ASSERT_EQ(4000, JSONParser().Parse(wide32)[0]
+                            .GetValue<JSONString>().value.size());
+
+    // Invalid text is rejected
+    std::u16string lone_high = u"[\"x\"]";
+    lone_high[2] = 0xd800;
+    std::u16string lone_low = u"[\"x\"]";
+    lone_low[2] = 0xdc00;
+    std::u32string surrogate = U"[\"x\"]";
+    surrogate[2] = 0xd800;
+    std::u32string too_large = U"[\"x\"]";
+    too_large[2] = 0x110000;
+    STF_ASSERT_EXCEPTION_E([&]() { JSONParser().Parse(lone_high); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { JSONParser().Parse(lone_low); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { JSONParser().Parse(surrogate); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { JSONParser().Parse(too_large); },
+                           JSONException);
+    STF_ASSERT_EXCEPTION_E([&]() { JSONParser().Parse(u"[1, "); },
+                           JSONException);
+}
@@ -15,8 +15,13 @@
  *      None.
  */
 
+#include <memory>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 #include <terra/json/json.h>
+#include <terra/json/json_parse_cache.h>
 #include <terra/stf/stf.h>
 
 using namespace Terra::JSON;
@@ -215,3 +220,73 @@ STF_TEST(JSONString, ToString)
 
     STF_ASSERT_EQ(expected, result);
 }
+
+// Test JSON text output of strings mixing escaped and unescaped characters
+STF_TEST(JSONString, Output6)
+{
+    JSONString string = u8"ab\"c\\d\b\f\n\r\t~\x7fé\U0001F600 end";
+    const std::string expected =
+        "\"ab\\\"c\\\\d\\b\\f\\n\\r\\t\\u007E\x7f\\u00E9\\uD83D\\uDE00 end\"";
+
+    std::ostringstream oss;
+
+    oss << string;
+
+    STF_ASSERT_EQ(expected, oss.str());
+    STF_ASSERT_EQ(expected, string.ToString());
+}
+
+// Test that strings that are not valid UTF-8 are rejected
+STF_TEST(JSONString, InvalidUTF8)
+{
+    for (const std::u8string &invalid : {std::u8string(1, char8_t(0x80)),
+                                        std::u8string(1, char8_t(0xe5)),
+                                        std::u8string(u8"a\xe5\xb0z"),
+                                        std::u8string(u8"\xed\xa0\x80"),
+                                        std::u8string(u8"\xf7\xbf\xbf\xbf")})
+    {
+        JSONString string(invalid);
+        STF_ASSERT_EXCEPTION_E([&]() { string.ToString(); }, JSONException);
+    }
+}
+
+// Test serializing strings modified directly after being serialized
+STF_TEST(JSONString, DirectModification)
+{
+    JSON json = JSONParser().Parse(R"({"k": "abc", "t": "xyz"})");
+    STF_ASSERT_EQ(R"({"k": "abc", "t": "xyz"})", json.ToString());
+
+    // Modifications that do not change the length are also observed
+    json[u8"k"].GetValue<JSONString>().value[0] = u8'"';
+    json[u8"t"].GetValue<JSONString>().value[1] = u8'\n';
+    std::string text = json.ToString();
+    STF_ASSERT_EQ(R"({"k": "\"bc", "t": "x\nz"})", text);
+    STF_ASSERT_EQ(text, JSONParser().Parse(text).ToString());
+}
+
+// Test serializing a shared document from several threads
+STF_TEST(JSONString, ConcurrentSerialization)
+{
+    std::string text = "[";
+    for (int i = 0; i < 1000; i++)
+    {
+        if (i > 0) text += ", ";
+        text += "\"value " + std::to_string(i) + "\"";
+    }
+    text += "]";
+
+    JSONParseCache cache(1);
+    std::shared_ptr<const JSON> json = cache.Parse(text);
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+
+    for (auto &result : results)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 10; i++) result = json->ToString();
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    for (const auto &result : results) STF_ASSERT_EQ(text, result);
+}
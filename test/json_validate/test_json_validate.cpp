@@ -0,0 +1,120 @@
+/*
+ *  test_json_validate.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the Validate() function.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <terra/json/json.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::JSON;
+
+// Test that well-formed text is accepted, as it is by the parser
+STF_TEST(Validate, WellFormed)
+{
+    JSONParser json_parser;
+
+    for (const std::string json_text :
+         {R"({"a": [1, -2.5e+3, 0, 0.25, true, false, null], "b": {}})",
+          R"([])",
+          R"("\"\\\/\b\f\n\r\t\u00e9\ud83d\ude01")",
+          "  \r\n\t 42 \n",
+          "\"\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x81\"",
+          R"([[[[{"x": [{}]}]]]])"})
+    {
+        STF_ASSERT_TRUE(Validate(json_text).valid);
+
+        auto parse = [&]() { json_parser.Parse(json_text); };
+        STF_ASSERT_NO_EXCEPTION(parse);
+    }
+}
+
+// Test that malformed text is rejected, as it is by the parser
+STF_TEST(Validate, Malformed)
+{
+    JSONParser json_parser;
+
+    for (const std::string json_text : {"",
+                                        "   ",
+                                        "[1, 2,]",
+                                        "{\"a\" 1}",
+                                        "{\"a\": 1,}",
+                                        "[1 2]",
+                                        "\"abc",
+                                        "\"a\x01z\"",
+                                        "\"\\ud83d\"",
+                                        "\"\\ude01\"",
+                                        "\"\\u12G4\"",
+                                        "-",
+                                        "1.",
+                                        "1e",
+                                        "tru",
+                                        "nul",
+                                        "[1] x",
+                                        "{1: 2}"})
+    {
+        ValidationResult result = Validate(json_text);
+
+        STF_ASSERT_FALSE(result.valid);
+        STF_ASSERT_TRUE(result.error != nullptr);
+        STF_ASSERT_LE(result.offset, json_text.size());
+
+        auto parse = [&]() { json_parser.Parse(json_text); };
+        STF_ASSERT_EXCEPTION_E(parse, JSONException);
+    }
+}
+
+// Test rules required by RFC 8259 that the parser does not enforce
+STF_TEST(Validate, Strict)
+{
+    for (const std::string json_text : {"01",
+                                        "[-00]",
+                                        "\"\\q\"",
+                                        "\"\xc0\xaf\"",
+                                        "\"\xed\xa0\x80\"",
+                                        "\"\xf4\x90\x80\x80\"",
+                                        "\"\xe2\x82\"",
+                                        "\"\x80\""})
+    {
+        STF_ASSERT_FALSE(Validate(json_text).valid);
+    }
+}
+
+// Test the reported error offset
+STF_TEST(Validate, ErrorOffset)
+{
+    ValidationResult result = Validate(std::string(R"({"a": [1, 2, x]})"));
+
+    STF_ASSERT_FALSE(result);
+    STF_ASSERT_EQ(13, result.offset);
+}
+
+// Test the limit on nesting depth
+STF_TEST(Validate, MaximumDepth)
+{
+    std::string json_text = std::string(100, '[') + std::string(100, ']');
+
+    STF_ASSERT_TRUE(Validate(json_text, 100).valid);
+    STF_ASSERT_FALSE(Validate(json_text, 99).valid);
+    STF_ASSERT_TRUE(Validate(json_text, ParserOptions::No_Limit).valid);
+
+    // A limit of zero permits only values that are not objects or arrays
+    STF_ASSERT_TRUE(Validate("1", 0).valid);
+    STF_ASSERT_FALSE(Validate("[]", 0).valid);
+
+    // The default limit protects against exhausting the stack
+    std::string deep_text(1'000'000, '[');
+    STF_ASSERT_FALSE(Validate(deep_text).valid);
+}